@@ -52,9 +52,11 @@ static const MetaEnum::Value<Protocol::MessageType> message_type_table[] = {
     M(ModelHeaderRequest),
     M(ModelSetDataRequest),
     M(ModelSortRequest),
+    M(ModelFetchMoreRequest),
     M(ModelSyncBarrier),
     M(SelectionModelStateRequest),
     M(ModelRowColumnCountReply),
+    M(ModelFetchMoreReply),
     M(ModelContentReply),
     M(ModelContentChanged),
     M(ModelHeaderReply),
@@ -67,6 +67,9 @@ void RemoteModel::Node::clearChildrenStructure()
     children.clear();
     rowCount = -1;
     columnCount = -1;
+    canFetchMore = false;
+    fetchingMore = false;
+    fetchMoreQueued = false;
 }
 
 void RemoteModel::Node::allocateColumns()
@@ -272,6 +275,40 @@ void RemoteModel::sort(int column, Qt::SortOrder order)
     sendMessage(msg);
 }
 
+bool RemoteModel::hasChildren(const QModelIndex &parent) const
+{
+    // lazily populated nodes need to be expandable for their children to be fetched
+    return QAbstractItemModel::hasChildren(parent) || canFetchMore(parent);
+}
+
+bool RemoteModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!isConnected() || parent.column() > 0)
+        return false;
+
+    Node *node = nodeForIndex(parent);
+    Q_ASSERT(node);
+    return node->rowCount >= 0 && node->canFetchMore;
+}
+
+void RemoteModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    Node *node = nodeForIndex(parent);
+    if (node->fetchingMore) {
+        // views ask again when the previous chunk arrives, before we know if there is more
+        node->fetchMoreQueued = true;
+        return;
+    }
+    node->fetchingMore = true;
+
+    Message msg(m_myAddress, Protocol::ModelFetchMoreRequest);
+    msg << Protocol::fromQModelIndex(parent);
+    sendMessage(msg);
+}
+
 void RemoteModel::newMessage(const GammaRay::Message &msg)
 {
     if (!checkSyncBarrier(msg))
@@ -289,7 +326,8 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
             Protocol::ModelIndex index;
             msg >> index;
             qint32 rowCount, columnCount;
-            msg >> rowCount >> columnCount;
+            bool canFetchMore;
+            msg >> rowCount >> columnCount >> canFetchMore;
 
             Node *node = nodeForIndex(index);
             if (!node) {
@@ -336,14 +374,36 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
                     node->children.push_back(child);
                 }
                 node->rowCount = rowCount;
+                node->canFetchMore = canFetchMore;
                 endInsertRows();
             } else {
                 node->rowCount = rowCount;
+                node->canFetchMore = canFetchMore;
+                if (canFetchMore && qmi.isValid())
+                    emit dataChanged(qmi, qmi); // so views show it as expandable
             }
         }
         break;
     }
 
+    case Protocol::ModelFetchMoreReply:
+    {
+        Protocol::ModelIndex index;
+        bool canFetchMore;
+        msg >> index >> canFetchMore;
+
+        Node *node = nodeForIndex(index);
+        if (!node || !node->fetchingMore)
+            break; // structure changed meanwhile, we'll ask for the row count again anyway
+        node->fetchingMore = false;
+        node->canFetchMore = canFetchMore;
+        if (node->fetchMoreQueued) {
+            node->fetchMoreQueued = false;
+            fetchMore(modelIndexForNode(node, 0));
+        }
+        break;
+    }
+
     case Protocol::ModelContentReply:
     {
         quint32 size;
@@ -74,6 +74,9 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 public slots:
     void newMessage(const GammaRay::Message &msg);
@@ -105,6 +108,9 @@ private:
         QVector<Node *> children;
         qint32 rowCount = -1;
         qint32 columnCount = -1;
+        bool canFetchMore = false; // as last reported by the server
+        bool fetchingMore = false; // waiting for a fetchMore() reply
+        bool fetchMoreQueued = false; // fetchMore() called again while waiting
         QVector<QHash<int, QVariant> > data; // column -> role -> data
         QVector<Qt::ItemFlags> flags;      // column -> flags
         std::vector<RemoteModelNodeState::NodeStates> state;         // column -> state (cache outdated, waiting for data, etc)
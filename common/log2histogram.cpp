@@ -0,0 +1,134 @@
+/*
+  log2histogram.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "log2histogram.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GammaRay;
+
+Log2Histogram::Log2Histogram()
+    : m_count(0)
+    , m_sum(0)
+    , m_max(0)
+{
+    std::fill(m_buckets, m_buckets + BucketCount, 0);
+}
+
+int Log2Histogram::bucket(qint64 value)
+{
+    int i = 0;
+    for (quint64 v = qMax<qint64>(0, value); v; v >>= 1)
+        ++i;
+    return qMin<int>(i, BucketCount - 1);
+}
+
+void Log2Histogram::add(qint64 value)
+{
+    ++m_buckets[bucket(value)];
+    ++m_count;
+    m_sum += value;
+    m_max = qMax(m_max, value);
+}
+
+void Log2Histogram::remove(qint64 value)
+{
+    auto &n = m_buckets[bucket(value)];
+    Q_ASSERT(n > 0 && m_count > 0);
+    --n;
+    --m_count;
+    m_sum -= value;
+}
+
+void Log2Histogram::addToBucket(int bucket, quint64 count)
+{
+    Q_ASSERT(bucket >= 0 && bucket < BucketCount);
+    m_buckets[bucket] += count;
+    m_count += count;
+}
+
+void Log2Histogram::merge(const Log2Histogram &other)
+{
+    for (int i = 0; i < BucketCount; ++i)
+        m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = qMax(m_max, other.m_max);
+}
+
+double Log2Histogram::mean() const
+{
+    return m_count == 0 ? 0.0 : double(m_sum) / m_count;
+}
+
+quint64 Log2Histogram::bucketCount(int bucket) const
+{
+    Q_ASSERT(bucket >= 0 && bucket < BucketCount);
+    return m_buckets[bucket];
+}
+
+double Log2Histogram::percentile(double p) const
+{
+    if (m_count == 0)
+        return 0.0;
+
+    const double rank = p * m_count;
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        const quint64 n = m_buckets[i];
+        if (n == 0 || seen + n < rank) {
+            seen += n;
+            continue;
+        }
+        if (i == 0)
+            return 0.0;
+        const double lower = std::ldexp(1.0, i - 1);
+        const double value = lower + lower * (rank - seen) / n;
+        // a maximum of 0 with values beyond bucket 0 means they came from addToBucket()
+        return m_max > 0 ? qMin(value, double(m_max)) : value;
+    }
+    return double(m_max);
+}
+
+QString Log2Histogram::toString(double scale, const QString &unit) const
+{
+    QStringList lines;
+    for (int i = 0; i < BucketCount; ++i) {
+        const quint64 n = m_buckets[i];
+        if (n == 0)
+            continue;
+        const double lower = i == 0 ? 0.0 : std::ldexp(1.0, i - 1) / scale;
+        const double upper = std::ldexp(1.0, i) / scale;
+        lines.push_back(QStringLiteral("%1 - %2 %3: %4").arg(QString::number(lower, 'g', 3),
+                                                             QString::number(upper, 'g', 3),
+                                                             unit, QString::number(n)));
+    }
+    return lines.join(QLatin1Char('\n'));
+}
@@ -0,0 +1,88 @@
+/*
+  log2histogram.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_LOG2HISTOGRAM_H
+#define GAMMARAY_LOG2HISTOGRAM_H
+
+#include "gammaray_common_export.h"
+
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QString;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+
+/**
+ * Histogram with power of two bucket sizes, for values spanning several orders of magnitude.
+ *
+ * Bucket @c i holds the values in [2^(i-1), 2^i), bucket 0 holds 0 and negative values.
+ * Percentiles are interpolated linearly within their bucket.
+ * @since 2.12
+ */
+class GAMMARAY_COMMON_EXPORT Log2Histogram
+{
+public:
+    enum { BucketCount = 64 };
+
+    Log2Histogram();
+
+    void add(qint64 value);
+    /** Removes a previously added @p value, e.g. when it leaves a sliding window.
+     *  This does not lower maximum().
+     */
+    void remove(qint64 value);
+    /** Adds @p count values only known by their @p bucket, they don't contribute to
+     *  mean() and maximum(). Used for snapshots of externally maintained bucket counters.
+     */
+    void addToBucket(int bucket, quint64 count);
+    void merge(const Log2Histogram &other);
+
+    quint64 count() const { return m_count; }
+    double mean() const;
+    qint64 maximum() const { return m_max; }
+    quint64 bucketCount(int bucket) const;
+    /** Approximate value at percentile @p p (0..1), clamped to maximum() if that is known. */
+    double percentile(double p) const;
+
+    /** Human readable bucket list, values are divided by @p scale. */
+    QString toString(double scale, const QString &unit) const;
+
+    /** Returns the index of the bucket @p value belongs to. */
+    static int bucket(qint64 value);
+
+private:
+    quint64 m_buckets[BucketCount];
+    quint64 m_count;
+    qint64 m_sum;
+    qint64 m_max;
+};
+
+}
+
+#endif // GAMMARAY_LOG2HISTOGRAM_H
@@ -27,6 +27,7 @@
 */
 
 #include "message.h"
+#include "profilingpoint.h"
 
 #include "sharedpool.h"
 #include "lz4/lz4.h" // 3rdparty
@@ -241,8 +242,13 @@ void Message::write(QIODevice *device) const
     static const bool compressionEnabled = qgetenv("GAMMARAY_DISABLE_LZ4") != "1";
     const int buffSize = m_buffer->data.size();
     auto& compressedData = m_buffer->scratchSpace;
-    if (buffSize > minimumUncompressedSize && compressionEnabled)
+    if (buffSize > minimumUncompressedSize && compressionEnabled) {
+        static ProfilingPoint compressionPoint("Remote", "message compression");
+        ScopedProfilingTimer timer(compressionPoint);
         compress(m_buffer->data.buffer(), compressedData);
+        if (ProfilingPoint::isEnabled())
+            compressionPoint.addBytes(buffSize);
+    }
 
     const bool isCompressed = compressedData.size() && compressedData.size() < buffSize;
     if (isCompressed)
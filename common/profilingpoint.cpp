@@ -0,0 +1,164 @@
+/*
+  profilingpoint.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profilingpoint.h"
+
+#include <QMutex>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+namespace {
+struct ProfilingPointRegistry
+{
+    QMutex mutex;
+    QVector<ProfilingPoint*> points;
+};
+}
+
+Q_GLOBAL_STATIC(ProfilingPointRegistry, s_registry)
+
+QAtomicInt ProfilingPoint::s_enabled(0);
+
+ProfilingPoint::ProfilingPoint(const char *tool, const char *name)
+    : m_tool(tool)
+    , m_name(name)
+{
+    reset();
+    if (auto registry = s_registry()) {
+        QMutexLocker lock(&registry->mutex);
+        registry->points.push_back(this);
+    }
+}
+
+ProfilingPoint::~ProfilingPoint()
+{
+    if (s_registry.isDestroyed())
+        return;
+    auto registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    registry->points.removeOne(this);
+}
+
+const char *ProfilingPoint::tool() const
+{
+    return m_tool;
+}
+
+const char *ProfilingPoint::name() const
+{
+    return m_name;
+}
+
+void ProfilingPoint::record(qint64 nsecs)
+{
+    const auto duration = static_cast<quint64>(qMax<qint64>(0, nsecs));
+    m_count.fetchAndAddRelaxed(1);
+    m_totalNSecs.fetchAndAddRelaxed(duration);
+
+    auto max = m_maxNSecs.loadAcquire();
+    while (duration > max && !m_maxNSecs.testAndSetOrdered(max, duration, max)) {}
+
+    m_buckets[Log2Histogram::bucket(nsecs)].fetchAndAddRelaxed(1);
+}
+
+void ProfilingPoint::addBytes(qint64 bytes)
+{
+    if (bytes > 0)
+        m_bytes.fetchAndAddRelaxed(static_cast<quint64>(bytes));
+}
+
+quint64 ProfilingPoint::count() const
+{
+    return m_count.loadAcquire();
+}
+
+quint64 ProfilingPoint::totalNSecs() const
+{
+    return m_totalNSecs.loadAcquire();
+}
+
+quint64 ProfilingPoint::maxNSecs() const
+{
+    return m_maxNSecs.loadAcquire();
+}
+
+quint64 ProfilingPoint::bytes() const
+{
+    return m_bytes.loadAcquire();
+}
+
+quint64 ProfilingPoint::bucketCount(int bucket) const
+{
+    Q_ASSERT(bucket >= 0 && bucket < HistogramBuckets);
+    return m_buckets[bucket].loadAcquire();
+}
+
+Log2Histogram ProfilingPoint::histogram() const
+{
+    Log2Histogram histogram;
+    for (int i = 0; i < HistogramBuckets; ++i)
+        histogram.addToBucket(i, bucketCount(i));
+    return histogram;
+}
+
+quint64 ProfilingPoint::percentileNSecs(double p) const
+{
+    return std::min(static_cast<quint64>(histogram().percentile(p)), maxNSecs());
+}
+
+void ProfilingPoint::reset()
+{
+    m_count.storeRelease(0);
+    m_totalNSecs.storeRelease(0);
+    m_maxNSecs.storeRelease(0);
+    m_bytes.storeRelease(0);
+    for (auto &bucket : m_buckets)
+        bucket.storeRelease(0);
+}
+
+void ProfilingPoint::setEnabled(bool enabled)
+{
+    s_enabled.storeRelease(enabled ? 1 : 0);
+}
+
+QVector<ProfilingPoint*> ProfilingPoint::points()
+{
+    if (s_registry.isDestroyed())
+        return {};
+    auto registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    return registry->points;
+}
+
+void ProfilingPoint::resetAll()
+{
+    const auto allPoints = points();
+    for (auto point : allPoints)
+        point->reset();
+}
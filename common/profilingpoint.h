@@ -0,0 +1,134 @@
+/*
+  profilingpoint.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_PROFILINGPOINT_H
+#define GAMMARAY_PROFILINGPOINT_H
+
+#include "gammaray_common_export.h"
+#include "log2histogram.h"
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QVector>
+
+namespace GammaRay {
+/**
+ * A named hot path inside GammaRay itself, for measuring the probe's own overhead.
+ *
+ * Instances are meant to be function-local statics, see GAMMARAY_PROFILE_SCOPE.
+ * Recording is lock-free and safe from any thread, and does nothing but a single
+ * atomic load as long as profiling is disabled.
+ */
+class GAMMARAY_COMMON_EXPORT ProfilingPoint
+{
+public:
+    /** Number of duration histogram buckets, see Log2Histogram for their layout. */
+    enum { HistogramBuckets = Log2Histogram::BucketCount };
+
+    /** Registers a new profiling point for @p tool, both strings need to be static. */
+    explicit ProfilingPoint(const char *tool, const char *name);
+    ~ProfilingPoint();
+
+    const char *tool() const;
+    const char *name() const;
+
+    /** Record one execution taking @p nsecs nanoseconds. */
+    void record(qint64 nsecs);
+    /** Account @p bytes of data processed, e.g. serialized or compressed. */
+    void addBytes(qint64 bytes);
+
+    quint64 count() const;
+    quint64 totalNSecs() const;
+    quint64 maxNSecs() const;
+    quint64 bytes() const;
+    quint64 bucketCount(int bucket) const;
+    /** Snapshot of the duration histogram, in nanoseconds. */
+    Log2Histogram histogram() const;
+    /** Approximate duration percentile @p p (0..1), based on the histogram. */
+    quint64 percentileNSecs(double p) const;
+
+    void reset();
+
+    /** Returns @c true if profiling data is currently being collected. */
+    static bool isEnabled()
+    {
+        return s_enabled.loadAcquire();
+    }
+    static void setEnabled(bool enabled);
+
+    /** All currently registered profiling points. */
+    static QVector<ProfilingPoint*> points();
+    /** Reset the statistics of all profiling points. */
+    static void resetAll();
+
+private:
+    Q_DISABLE_COPY(ProfilingPoint)
+
+    const char *m_tool;
+    const char *m_name;
+    QAtomicInteger<quint64> m_count;
+    QAtomicInteger<quint64> m_totalNSecs;
+    QAtomicInteger<quint64> m_maxNSecs;
+    QAtomicInteger<quint64> m_bytes;
+    QAtomicInteger<quint64> m_buckets[HistogramBuckets];
+
+    static QAtomicInt s_enabled;
+};
+
+/** Measures the time spent in the current scope for @p point, if profiling is enabled. */
+class ScopedProfilingTimer
+{
+public:
+    explicit ScopedProfilingTimer(ProfilingPoint &point)
+        : m_point(ProfilingPoint::isEnabled() ? &point : nullptr)
+    {
+        if (Q_UNLIKELY(m_point))
+            m_timer.start();
+    }
+
+    ~ScopedProfilingTimer()
+    {
+        if (Q_UNLIKELY(m_point))
+            m_point->record(m_timer.nsecsElapsed());
+    }
+
+private:
+    Q_DISABLE_COPY(ScopedProfilingTimer)
+    ProfilingPoint *m_point;
+    QElapsedTimer m_timer;
+};
+}
+
+#define GAMMARAY_PROFILING_CONCAT_IMPL(a, b) a ## b
+#define GAMMARAY_PROFILING_CONCAT(a, b) GAMMARAY_PROFILING_CONCAT_IMPL(a, b)
+
+/** Defines a static profiling point for @p tool and @p name, and times the enclosing scope with it. */
+#define GAMMARAY_PROFILE_SCOPE(tool, name) \
+    static GammaRay::ProfilingPoint GAMMARAY_PROFILING_CONCAT(gammarayProfilingPoint, __LINE__)(tool, name); \
+    GammaRay::ScopedProfilingTimer GAMMARAY_PROFILING_CONCAT(gammarayProfilingTimer, __LINE__)(GAMMARAY_PROFILING_CONCAT(gammarayProfilingPoint, __LINE__))
+
+#endif // GAMMARAY_PROFILINGPOINT_H
@@ -79,11 +79,13 @@ enum BuildInMessageType {
     ModelHeaderRequest,
     ModelSetDataRequest,
     ModelSortRequest,
+    ModelFetchMoreRequest,
     ModelSyncBarrier,
     SelectionModelStateRequest,
 
     // server -> client
     ModelRowColumnCountReply,
+    ModelFetchMoreReply,
     ModelContentReply,
     ModelContentChanged,
     ModelHeaderReply,
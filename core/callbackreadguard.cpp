@@ -0,0 +1,85 @@
+/*
+  callbackreadguard.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "callbackreadguard.h"
+
+#include <QThread>
+
+using namespace GammaRay;
+
+namespace {
+// one cache line per stripe, so threads in different stripes don't contend
+struct ReaderStripe
+{
+    QAtomicInt readers;
+    char padding[64 - sizeof(QAtomicInt)];
+};
+}
+
+static ReaderStripe s_readerStripes[64];
+
+QAtomicInt *CallbackReadGuard::readers(int stripe)
+{
+    Q_STATIC_ASSERT(sizeof(s_readerStripes) / sizeof(ReaderStripe) == StripeCount);
+    Q_ASSERT(stripe >= 0 && stripe < StripeCount);
+    return &s_readerStripes[stripe].readers;
+}
+
+QAtomicInt *CallbackReadGuard::currentReaders()
+{
+    // thread ids are pointer-like, scramble them (Fibonacci hashing) to spread the stripes
+    const auto id = quint64(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    return readers(int((id * Q_UINT64_C(11400714819323198485)) >> 58));
+}
+
+void CallbackReadGuard::synchronize()
+{
+    CallbackGracePeriod gracePeriod;
+    while (!gracePeriod.hasElapsed())
+        QThread::yieldCurrentThread();
+}
+
+CallbackGracePeriod::CallbackGracePeriod()
+    : m_pendingStripes(0)
+{
+    // ordered, pairs with the guard constructor: a reader not seen here yet sees the new data
+    for (int i = 0; i < CallbackReadGuard::StripeCount; ++i) {
+        if (CallbackReadGuard::readers(i)->fetchAndAddOrdered(0) != 0)
+            m_pendingStripes |= Q_UINT64_C(1) << i;
+    }
+}
+
+bool CallbackGracePeriod::hasElapsed()
+{
+    // a stripe seen without readers once has no reader left from before the start
+    for (int i = 0; m_pendingStripes && i < CallbackReadGuard::StripeCount; ++i) {
+        const auto bit = Q_UINT64_C(1) << i;
+        if ((m_pendingStripes & bit) && CallbackReadGuard::readers(i)->loadAcquire() == 0)
+            m_pendingStripes &= ~bit;
+    }
+    return m_pendingStripes == 0;
+}
@@ -0,0 +1,90 @@
+/*
+  callbackreadguard.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_CALLBACKREADGUARD_H
+#define GAMMARAY_CALLBACKREADGUARD_H
+
+#include "gammaray_core_export.h"
+
+#include <QAtomicInt>
+
+namespace GammaRay {
+/** @brief Marks a callback Qt invokes in an arbitrary thread as reading lock-free published data.
+ *
+ *  Data read under a guard is published through an atomic pointer. To free the data it
+ *  replaced, a writer swaps the pointer and then waits for a CallbackGracePeriod, after
+ *  which no guard that could have seen the old data is alive anymore.
+ *
+ *  Reader counts are striped by thread, so guards in different threads don't write to a
+ *  shared cache line. Guards nest.
+ */
+class GAMMARAY_CORE_EXPORT CallbackReadGuard
+{
+public:
+    CallbackReadGuard()
+        : m_readers(currentReaders())
+    {
+        // ordered, pairs with the pointer swap before a grace period starts
+        m_readers->fetchAndAddOrdered(1);
+    }
+    ~CallbackReadGuard()
+    {
+        m_readers->fetchAndAddRelease(-1);
+    }
+
+    /**
+     * Blocks until all guards alive at the time of this call are gone.
+     * Must not be called while holding a guard in the current thread.
+     */
+    static void synchronize();
+
+private:
+    Q_DISABLE_COPY(CallbackReadGuard)
+    friend class CallbackGracePeriod;
+
+    enum { StripeCount = 64 };
+    static QAtomicInt *currentReaders();
+    static QAtomicInt *readers(int stripe);
+
+    QAtomicInt *m_readers;
+};
+
+/** @brief Non-blocking wait for the guards alive at construction time to be gone. */
+class GAMMARAY_CORE_EXPORT CallbackGracePeriod
+{
+public:
+    CallbackGracePeriod();
+
+    /** Returns @c true once all guards alive at construction time are gone. */
+    bool hasElapsed();
+
+private:
+    quint64 m_pendingStripes;
+};
+}
+
+#endif // GAMMARAY_CALLBACKREADGUARD_H
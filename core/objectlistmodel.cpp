@@ -30,10 +30,14 @@
 
 #include "probe.h"
 
+#include <compat/qasconst.h>
+
 #include <QThread>
 #include <QCoreApplication>
+#include <QMutexLocker>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 
 using namespace GammaRay;
@@ -41,6 +45,12 @@ using namespace std;
 
 ObjectListModel::ObjectListModel(Probe *probe)
     : ObjectModelBase< QAbstractTableModel >(probe)
+    , m_validChunkStarts(0)
+    , m_rowCount(0)
+    , m_objectsDirty(false)
+    , m_nextSerial(0)
+    , m_batchDepth(0)
+    , m_firstPendingSerial(0)
 {
     connect(probe, &Probe::objectCreated,
             this, &ObjectListModel::objectAdded);
@@ -57,8 +67,9 @@ QPair<int, QVariant> ObjectListModel::defaultSelectedItem() const
 QVariant ObjectListModel::data(const QModelIndex &index, int role) const
 {
     QMutexLocker lock(Probe::objectLock());
-    if (index.row() >= 0 && index.row() < m_objects.size()) {
-        QObject *obj = m_objects.at(index.row());
+    if (index.row() >= 0 && index.row() < m_rowCount) {
+        const int chunk = chunkForRow(index.row());
+        QObject *obj = m_chunks[chunk].objects.at(index.row() - m_chunkStart.at(chunk));
         if (Probe::instance()->isValidObject(obj))
             return dataForObject(obj, index, role);
     }
@@ -77,7 +88,7 @@ int ObjectListModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return m_objects.size();
+    return m_rowCount;
 }
 
 void ObjectListModel::objectAdded(QObject *obj)
@@ -86,16 +97,20 @@ void ObjectListModel::objectAdded(QObject *obj)
     Q_ASSERT(QThread::currentThread() == thread());
     Q_ASSERT(obj);
     Q_ASSERT(Probe::instance()->isValidObject(obj));
+    Q_ASSERT(!m_serials.contains(obj));
 
-    auto it = std::lower_bound(m_objects.begin(), m_objects.end(), obj);
-    Q_ASSERT(it == m_objects.end() || *it != obj);
+    const auto serial = m_nextSerial++;
+    m_serials.insert(obj, serial);
 
-    const int row = std::distance(m_objects.begin(), it);
-    Q_ASSERT(row >= 0 && row <= m_objects.size());
+    if (m_batchDepth > 0) {
+        if (m_pendingAdds.isEmpty())
+            m_firstPendingSerial = serial;
+        m_pendingAdds.push_back(obj);
+        return;
+    }
 
-    beginInsertRows(QModelIndex(), row, row);
-    m_objects.insert(it, obj);
-    Q_ASSERT(m_objects.at(row) == obj);
+    beginInsertRows(QModelIndex(), m_rowCount, m_rowCount);
+    appendObjects({ serial }, { obj });
     endInsertRows();
 }
 
@@ -103,22 +118,212 @@ void ObjectListModel::objectRemoved(QObject *obj)
 {
     Q_ASSERT(thread() == QThread::currentThread());
 
-    auto it = std::lower_bound(m_objects.begin(), m_objects.end(), obj);
-    if (it == m_objects.end() || *it != obj) {
+    const auto it = m_serials.find(obj);
+    if (it == m_serials.end()) {
         // not found
         return;
     }
+    const auto serial = it.value();
+    m_serials.erase(it);
 
-    const int row = std::distance(m_objects.begin(), it);
-    Q_ASSERT(row >= 0 && row < m_objects.size());
-    Q_ASSERT(m_objects.at(row) == obj);
+    if (!m_pendingAdds.isEmpty() && serial >= m_firstPendingSerial) {
+        // added and removed within the same batch, nobody ever saw it
+        m_pendingAdds[serial - m_firstPendingSerial] = nullptr;
+        return;
+    }
+    if (m_batchDepth > 0) {
+        m_pendingRemovals.push_back(serial);
+        return;
+    }
+
+    const int row = rowForSerial(serial);
+    Q_ASSERT(row >= 0 && row < m_rowCount);
 
     beginRemoveRows(QModelIndex(), row, row);
-    m_objects.erase(it);
+    removeObjects(row, row);
     endRemoveRows();
 }
 
+void ObjectListModel::beginBatch()
+{
+    Q_ASSERT(thread() == QThread::currentThread());
+    ++m_batchDepth;
+}
+
+void ObjectListModel::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    if (--m_batchDepth > 0)
+        return;
+
+    if (!m_pendingRemovals.isEmpty()) {
+        QVector<int> rows;
+        rows.reserve(m_pendingRemovals.size());
+        for (const auto serial : qAsConst(m_pendingRemovals))
+            rows.push_back(rowForSerial(serial));
+        m_pendingRemovals.clear();
+
+        // remove back to front, so the rows of the remaining ranges stay valid
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+        for (int i = 0; i < rows.size();) {
+            int first = rows.at(i);
+            const int last = first;
+            for (++i; i < rows.size() && rows.at(i) == first - 1; ++i)
+                first = rows.at(i);
+            beginRemoveRows(QModelIndex(), first, last);
+            removeObjects(first, last);
+            endRemoveRows();
+        }
+    }
+
+    if (!m_pendingAdds.isEmpty()) {
+        QVector<quint64> serials;
+        QVector<QObject *> objects;
+        serials.reserve(m_pendingAdds.size());
+        objects.reserve(m_pendingAdds.size());
+        for (int i = 0; i < m_pendingAdds.size(); ++i) {
+            if (!m_pendingAdds.at(i))
+                continue;
+            serials.push_back(m_firstPendingSerial + i);
+            objects.push_back(m_pendingAdds.at(i));
+        }
+        m_pendingAdds.clear();
+
+        if (!objects.isEmpty()) {
+            beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + objects.size() - 1);
+            appendObjects(serials, objects);
+            endInsertRows();
+        }
+    }
+}
+
+int ObjectListModel::chunkForRow(int row) const
+{
+    Q_ASSERT(row >= 0 && row < m_rowCount);
+    if (m_validChunkStarts == 0
+        || row >= m_chunkStart.at(m_validChunkStarts - 1) + m_chunks[m_validChunkStarts - 1].objects.size())
+        updateChunkStarts();
+    const auto it = std::upper_bound(m_chunkStart.constBegin(),
+                                     m_chunkStart.constBegin() + m_validChunkStarts, row);
+    return std::distance(m_chunkStart.constBegin(), it) - 1;
+}
+
+int ObjectListModel::rowForSerial(quint64 serial) const
+{
+    // serials are increasing across chunks, so we can bisect twice
+    const auto chunkIt = std::upper_bound(m_chunks.begin(), m_chunks.end(), serial,
+                                          [](quint64 value, const Chunk &chunk) {
+        return value < chunk.serials.first();
+    });
+    if (chunkIt == m_chunks.begin())
+        return -1;
+    const int chunkIndex = std::distance(m_chunks.begin(), chunkIt) - 1;
+    const auto &chunk = m_chunks[chunkIndex];
+    const auto it = std::lower_bound(chunk.serials.constBegin(), chunk.serials.constEnd(), serial);
+    if (it == chunk.serials.constEnd() || *it != serial)
+        return -1;
+    if (chunkIndex >= m_validChunkStarts)
+        updateChunkStarts();
+    return m_chunkStart.at(chunkIndex) + std::distance(chunk.serials.constBegin(), it);
+}
+
+void ObjectListModel::updateChunkStarts() const
+{
+    int row = 0;
+    if (m_validChunkStarts > 0)
+        row = m_chunkStart.at(m_validChunkStarts - 1) + m_chunks[m_validChunkStarts - 1].objects.size();
+    for (int i = m_validChunkStarts; i < int(m_chunks.size()); ++i) {
+        m_chunkStart[i] = row;
+        row += m_chunks[i].objects.size();
+    }
+    m_validChunkStarts = m_chunks.size();
+    Q_ASSERT(row == m_rowCount);
+}
+
+void ObjectListModel::appendObjects(const QVector<quint64> &serials, const QVector<QObject *> &objects)
+{
+    Q_ASSERT(serials.size() == objects.size());
+    for (int i = 0; i < objects.size();) {
+        if (m_chunks.empty() || m_chunks.back().objects.size() >= ChunkSize) {
+            // the start row of a new chunk is always right, but validity is tracked as a prefix
+            if (m_validChunkStarts == int(m_chunks.size()))
+                ++m_validChunkStarts;
+            m_chunks.push_back(Chunk());
+            m_chunks.back().serials.reserve(ChunkSize);
+            m_chunks.back().objects.reserve(ChunkSize);
+            m_chunkStart.push_back(m_rowCount);
+        }
+        auto &chunk = m_chunks.back();
+        const int count = std::min<int>(ChunkSize - chunk.objects.size(), objects.size() - i);
+        chunk.serials.append(serials.mid(i, count));
+        chunk.objects.append(objects.mid(i, count));
+        m_rowCount += count;
+        i += count;
+    }
+    m_objectsDirty = true;
+}
+
+void ObjectListModel::removeObjects(int first, int last)
+{
+    const int firstChunk = chunkForRow(first);
+    int chunkIndex = firstChunk;
+    int remaining = last - first + 1;
+    int offset = first - m_chunkStart.at(chunkIndex);
+    while (remaining > 0) {
+        auto &chunk = m_chunks[chunkIndex];
+        const int count = std::min(remaining, chunk.objects.size() - offset);
+        chunk.serials.remove(offset, count);
+        chunk.objects.remove(offset, count);
+        remaining -= count;
+        offset = 0;
+        ++chunkIndex;
+    }
+    m_rowCount -= last - first + 1;
+    m_objectsDirty = true;
+
+    // start rows after the first touched chunk are fixed up lazily on the next lookup behind it,
+    // removing ranges back to front thus never has to touch them
+    m_validChunkStarts = std::min(m_validChunkStarts, firstChunk + 1);
+
+    for (int i = chunkIndex - 1; i >= firstChunk; --i)
+        mergeChunk(i);
+}
+
+void ObjectListModel::mergeChunk(int chunkIndex)
+{
+    // drop emptied chunks and fold underfilled ones into a neighbor, so that
+    // long running applications don't accumulate lots of nearly empty chunks
+    auto &chunk = m_chunks[chunkIndex];
+    if (chunk.objects.size() >= ChunkSize / 4)
+        return;
+
+    if (chunkIndex > 0 && m_chunks[chunkIndex - 1].objects.size() + chunk.objects.size() <= ChunkSize) {
+        auto &previous = m_chunks[chunkIndex - 1];
+        previous.serials += chunk.serials;
+        previous.objects += chunk.objects;
+    } else if (chunkIndex + 1 < int(m_chunks.size())
+               && chunk.objects.size() + m_chunks[chunkIndex + 1].objects.size() <= ChunkSize) {
+        ++chunkIndex;
+        auto &next = m_chunks[chunkIndex];
+        chunk.serials += next.serials;
+        chunk.objects += next.objects;
+    } else if (!chunk.objects.isEmpty()) {
+        return;
+    }
+
+    m_chunks.erase(m_chunks.begin() + chunkIndex);
+    m_chunkStart.remove(chunkIndex);
+    m_validChunkStarts = std::min(m_validChunkStarts, chunkIndex);
+}
+
 const QVector<QObject *> &ObjectListModel::objects() const
 {
+    if (m_objectsDirty) {
+        m_objects.resize(0);
+        m_objects.reserve(m_rowCount);
+        for (const auto &chunk : m_chunks)
+            m_objects += chunk.objects;
+        m_objectsDirty = false;
+    }
     return m_objects;
 }
@@ -31,9 +31,10 @@
 
 #include "objectmodelbase.h"
 
-#include <QMutex>
+#include <QHash>
 #include <QVector>
-#include <QSet>
+
+#include <vector>
 
 namespace GammaRay {
 class Probe;
@@ -65,18 +66,53 @@ public:
      *
      * FIXME: This is a dirty hack. Instead of offering a getter to the internal data
      * here, we should move it out and only give the model a view of the data.
+     * The list is reassembled from the chunked storage on the first call after a change.
      */
     const QVector<QObject*> &objects() const;
 
+    /*!
+     * Collect object additions and removals until the matching endBatch() call,
+     * and report them as ranged row changes then. Calls can be nested.
+     */
+    void beginBatch();
+    void endBatch();
+
 private slots:
     void objectAdded(QObject *obj);
     void objectRemoved(QObject *obj);
 
 private:
-    void removeObject(QObject *obj);
-
-    // sorted vector for stable iterators/indexes, esp. for the model methods
-    QVector<QObject *> m_objects;
+    // objects are kept in insertion order, identified by an increasing serial number
+    struct Chunk
+    {
+        QVector<quint64> serials;
+        QVector<QObject *> objects;
+    };
+    enum { ChunkSize = 1024 };
+
+    int chunkForRow(int row) const;
+    int rowForSerial(quint64 serial) const;
+    void updateChunkStarts() const;
+    void appendObjects(const QVector<quint64> &serials, const QVector<QObject *> &objects);
+    void removeObjects(int first, int last);
+    void mergeChunk(int chunkIndex);
+
+    // chunked storage, so inserts and removals only move a bounded number of entries
+    std::vector<Chunk> m_chunks;
+    mutable QVector<int> m_chunkStart; // row of the first object in the corresponding chunk
+    mutable int m_validChunkStarts; // m_chunkStart is up to date below this chunk index
+    int m_rowCount;
+
+    mutable QVector<QObject *> m_objects; // flat copy handed out by objects()
+    mutable bool m_objectsDirty;
+
+    QHash<QObject *, quint64> m_serials;
+    quint64 m_nextSerial;
+
+    int m_batchDepth;
+    quint64 m_firstPendingSerial;
+    QVector<QObject *> m_pendingAdds; // serial is m_firstPendingSerial + index, nullptr if removed again
+    QVector<quint64> m_pendingRemovals;
 };
 }
 
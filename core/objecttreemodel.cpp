@@ -30,12 +30,15 @@
 
 #include "probe.h"
 
+#include <compat/qasconst.h>
+
 #include <QEvent>
 #include <QMutex>
 #include <QThread>
 #include <QCoreApplication>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 
 #define IF_DEBUG(x)
@@ -47,6 +50,7 @@ using namespace GammaRay;
 
 ObjectTreeModel::ObjectTreeModel(Probe *probe)
     : ObjectModelBase< QAbstractItemModel >(probe)
+    , m_batchDepth(0)
 {
     connect(probe, &Probe::objectCreated,
             this, &ObjectTreeModel::objectAdded);
@@ -77,7 +81,7 @@ void ObjectTreeModel::objectAdded(QObject *obj)
              )
     Q_ASSERT(!obj->parent() || Probe::instance()->isValidObject(parentObject(obj)));
 
-    if (indexForObject(obj).isValid()) {
+    if (isTracked(obj)) {
         IF_DEBUG(cout << "tree double obj added: " << hex << obj << endl;
                  )
         return;
@@ -88,30 +92,17 @@ void ObjectTreeModel::objectAdded(QObject *obj)
     // then later the delayed signal comes in
     // so catch this gracefully by first adding the
     // parent if required
-    if (parentObject(obj)) {
-        const QModelIndex index = indexForObject(parentObject(obj));
-        if (!index.isValid()) {
-            IF_DEBUG(cout << "tree: handle parent first" << endl;
-                     )
-            objectAdded(parentObject(obj));
-        }
+    if (parentObject(obj) && !isTracked(parentObject(obj))) {
+        IF_DEBUG(cout << "tree: handle parent first" << endl;
+                 )
+        objectAdded(parentObject(obj));
     }
 
-    const QModelIndex index = indexForObject(parentObject(obj));
-
-    // either we get a proper parent and hence valid index or there is no parent
-    Q_ASSERT(index.isValid() || !parentObject(obj));
-
-    QVector<QObject *> &children = m_parentChildMap[ parentObject(obj) ];
-    auto it = std::lower_bound(children.begin(), children.end(), obj);
-    const int row = std::distance(children.begin(), it);
+    m_pendingAdds.push_back(obj);
+    m_pendingAddSet.insert(obj);
 
-    beginInsertRows(index, row, row);
-
-    children.insert(it, obj);
-    m_childParentMap.insert(obj, parentObject(obj));
-
-    endInsertRows();
+    if (m_batchDepth == 0)
+        applyPendingChanges();
 }
 
 void ObjectTreeModel::objectRemoved(QObject *obj)
@@ -122,35 +113,24 @@ void ObjectTreeModel::objectRemoved(QObject *obj)
     IF_DEBUG(cout
              << "tree removed: "
              << hex << obj << " "
-             << hex << obj->parent() << dec << " "
-             << m_parentChildMap.value(obj->parent()).size() << " "
-             << m_parentChildMap.contains(obj) << endl;
+             << m_childParentMap.contains(obj) << " "
+             << m_pendingAddSet.contains(obj) << endl;
              )
 
+    if (m_pendingAddSet.remove(obj)) {
+        // added and removed within the same batch, nobody ever saw it
+        return;
+    }
     if (!m_childParentMap.contains(obj)) {
         Q_ASSERT(!m_parentChildMap.contains(obj));
         return;
     }
 
-    QObject *parentObj = m_childParentMap[ obj ];
-    const QModelIndex parentIndex = indexForObject(parentObj);
-    if (parentObj && !parentIndex.isValid())
-        return;
-
-    QVector<QObject *> &siblings = m_parentChildMap[ parentObj ];
-
-    auto it = std::lower_bound(siblings.begin(), siblings.end(), obj);
-    if (it == siblings.end() || *it != obj)
-        return;
-    const int row = std::distance(siblings.begin(), it);
-
-    beginRemoveRows(parentIndex, row, row);
-
-    siblings.erase(it);
-    m_childParentMap.remove(obj);
-    m_parentChildMap.remove(obj);
+    m_pendingMoves.remove(obj);
+    m_pendingRemovals.insert(obj);
 
-    endRemoveRows();
+    if (m_batchDepth == 0)
+        applyPendingChanges();
 }
 
 void ObjectTreeModel::objectReparented(QObject *obj)
@@ -167,40 +147,276 @@ void ObjectTreeModel::objectReparented(QObject *obj)
     }
 
     // we didn't know obj yet
-    if (!m_childParentMap.contains(obj)) {
-        Q_ASSERT(!m_parentChildMap.contains(obj));
+    if (!isTracked(obj)) {
         objectAdded(obj);
         return;
     }
 
-    QObject *oldParent = m_childParentMap.value(obj);
-    const auto sourceParent = indexForObject(oldParent);
-    if ((oldParent && !sourceParent.isValid()) || (oldParent == parentObject(obj)))
+    // the parent of pending additions is only looked at when inserting them
+    if (m_pendingAddSet.contains(obj)) {
+        if (m_batchDepth == 0)
+            applyPendingChanges(); // it might have waited for a parent known to the probe
         return;
+    }
+
+    QObject *newParent = parentObject(obj);
+    if (newParent && !isTracked(newParent) && Probe::instance()->isValidObject(newParent))
+        objectAdded(newParent);
+    m_pendingMoves.insert(obj);
 
-    QVector<QObject *> &oldSiblings = m_parentChildMap[oldParent];
-    auto oldIt = std::lower_bound(oldSiblings.begin(),
-                                                          oldSiblings.end(), obj);
-    if (oldIt == oldSiblings.end() || *oldIt != obj)
+    if (m_batchDepth == 0)
+        applyPendingChanges();
+}
+
+void ObjectTreeModel::beginBatch()
+{
+    Q_ASSERT(thread() == QThread::currentThread());
+    ++m_batchDepth;
+}
+
+void ObjectTreeModel::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    if (--m_batchDepth == 0)
+        applyPendingChanges();
+}
+
+bool ObjectTreeModel::isTracked(QObject *object) const
+{
+    return m_pendingAddSet.contains(object)
+           || (m_childParentMap.contains(object) && !m_pendingRemovals.contains(object));
+}
+
+void ObjectTreeModel::applyPendingChanges()
+{
+    // we look at the parents of the objects involved
+    QMutexLocker objectLock(Probe::objectLock());
+
+    // removals first, the addresses might have been reused by additions in the same batch,
+    // and additions before moves, so the new parents are known
+    applyRemovals();
+    applyAdditions();
+    applyMoves();
+    // objects a move couldn't be applied to were taken out of the tree, add them back
+    applyAdditions();
+}
+
+void ObjectTreeModel::applyRemovals()
+{
+    if (m_pendingRemovals.isEmpty())
         return;
-    const int sourceRow = std::distance(oldSiblings.begin(), oldIt);
 
-    IF_DEBUG(cout << "actually reparenting! " << hex << obj << " old parent: " << oldParent << " new parent: " << parentObject(
-                 obj) << dec << endl;
-             )
-    const auto destParent = indexForObject(parentObject(obj));
-    Q_ASSERT(destParent.isValid() || !parentObject(obj));
-
-    QVector<QObject *> &newSiblings = m_parentChildMap[parentObject(obj)];
-    auto newIt = std::lower_bound(newSiblings.begin(),
-                                                          newSiblings.end(), obj);
-    const int destRow = std::distance(newSiblings.begin(), newIt);
-
-    beginMoveRows(sourceParent, sourceRow, sourceRow, destParent, destRow);
-    oldSiblings.erase(oldIt);
-    newSiblings.insert(newIt, obj);
-    m_childParentMap.insert(obj, parentObject(obj));
-    endMoveRows();
+    QHash<QObject *, QVector<int> > rowsByParent;
+    for (QObject *obj : qAsConst(m_pendingRemovals)) {
+        // removing an ancestor takes the entire sub-tree out already
+        bool ancestorRemoved = false;
+        for (QObject *p = m_childParentMap.value(obj); p && !ancestorRemoved; p = m_childParentMap.value(p))
+            ancestorRemoved = m_pendingRemovals.contains(p);
+        if (!ancestorRemoved)
+            rowsByParent[m_childParentMap.value(obj)].push_back(m_childRowMap.value(obj));
+    }
+
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        QObject *parentObj = it.key();
+        auto &rows = it.value();
+
+        // remove back to front, so the rows of the remaining ranges stay valid
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+        const QModelIndex parentIndex = indexForObject(parentObj);
+        for (int i = 0; i < rows.size();) {
+            int first = rows.at(i);
+            const int last = first;
+            for (++i; i < rows.size() && rows.at(i) == first - 1; ++i)
+                first = rows.at(i);
+
+            beginRemoveRows(parentIndex, first, last);
+            QVector<QObject *> &siblings = m_parentChildMap[parentObj];
+            const auto removed = siblings.mid(first, last - first + 1);
+            siblings.remove(first, last - first + 1);
+            for (QObject *obj : removed)
+                removeSubtree(obj);
+            endRemoveRows();
+        }
+        updateRows(parentObj, rows.last());
+    }
+    m_pendingRemovals.clear();
+}
+
+void ObjectTreeModel::applyAdditions()
+{
+    if (m_pendingAdds.isEmpty())
+        return;
+
+    // group by parent, the list grows while we iterate if we discover unknown ancestors
+    QHash<QObject *, QVector<QObject *> > addsByParent;
+    QSet<QObject *> accepted;
+    for (int i = 0; i < m_pendingAdds.size(); ++i) {
+        QObject *obj = m_pendingAdds.at(i);
+        if (!m_pendingAddSet.remove(obj))
+            continue; // removed again, or a duplicate entry
+        QObject *parentObj = parentObject(obj);
+        if (parentObj && !m_childParentMap.contains(parentObj) && !accepted.contains(parentObj)
+            && !m_pendingAddSet.contains(parentObj) && Probe::instance()->isValidObject(parentObj)) {
+            m_pendingAdds.push_back(parentObj);
+            m_pendingAddSet.insert(parentObj);
+        }
+        addsByParent[parentObj].push_back(obj);
+        accepted.insert(obj);
+    }
+    m_pendingAdds.clear();
+    Q_ASSERT(m_pendingAddSet.isEmpty());
+
+    // insert top-down, one range per parent
+    QVector<QObject *> parents;
+    for (auto it = addsByParent.constBegin(); it != addsByParent.constEnd(); ++it) {
+        if (!it.key() || m_childParentMap.contains(it.key()))
+            parents.push_back(it.key());
+    }
+    for (int i = 0; i < parents.size(); ++i) {
+        QObject *parentObj = parents.at(i);
+        const auto children = addsByParent.take(parentObj);
+        const QModelIndex parentIndex = indexForObject(parentObj);
+        QVector<QObject *> &siblings = m_parentChildMap[parentObj];
+
+        beginInsertRows(parentIndex, siblings.size(), siblings.size() + children.size() - 1);
+        for (QObject *obj : children) {
+            m_childParentMap.insert(obj, parentObj);
+            m_childRowMap.insert(obj, siblings.size());
+            siblings.push_back(obj);
+            if (addsByParent.contains(obj))
+                parents.push_back(obj);
+        }
+        endInsertRows();
+    }
+
+    // what is left hangs below a parent the probe doesn't know yet, retry with the next change
+    for (auto it = addsByParent.constBegin(); it != addsByParent.constEnd(); ++it) {
+        for (QObject *obj : it.value()) {
+            m_pendingAdds.push_back(obj);
+            m_pendingAddSet.insert(obj);
+        }
+    }
+}
+
+void ObjectTreeModel::applyMoves()
+{
+    if (m_pendingMoves.isEmpty())
+        return;
+
+    struct Move
+    {
+        int depth;
+        QObject *oldParent;
+        QObject *newParent;
+        QObject *object;
+    };
+    QVector<Move> moves;
+    moves.reserve(m_pendingMoves.size());
+    for (QObject *obj : qAsConst(m_pendingMoves)) {
+        QObject *oldParent = m_childParentMap.value(obj);
+        QObject *newParent = parentObject(obj);
+        if (oldParent == newParent)
+            continue;
+        int depth = 0;
+        for (QObject *p = newParent; p; p = parentObject(p))
+            ++depth;
+        moves.push_back({ depth, oldParent, newParent, obj });
+    }
+    m_pendingMoves.clear();
+
+    // moving top-down ensures the new parent is in its final place already, so we never
+    // try to move something into its own sub-tree
+    std::sort(moves.begin(), moves.end(), [](const Move &lhs, const Move &rhs) {
+        if (lhs.depth != rhs.depth)
+            return lhs.depth < rhs.depth;
+        if (lhs.oldParent != rhs.oldParent)
+            return std::less<QObject *>()(lhs.oldParent, rhs.oldParent);
+        return std::less<QObject *>()(lhs.newParent, rhs.newParent);
+    });
+
+    for (int i = 0; i < moves.size();) {
+        const int depth = moves.at(i).depth;
+        QObject *oldParent = moves.at(i).oldParent;
+        QObject *newParent = moves.at(i).newParent;
+        QVector<int> rows;
+        for (; i < moves.size() && moves.at(i).depth == depth
+             && moves.at(i).oldParent == oldParent && moves.at(i).newParent == newParent; ++i) {
+            // skip what an earlier failed move took out of the tree along with its ancestor
+            const auto it = m_childParentMap.constFind(moves.at(i).object);
+            if (it != m_childParentMap.constEnd() && it.value() == oldParent)
+                rows.push_back(m_childRowMap.value(moves.at(i).object));
+        }
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+        for (int j = 0; j < rows.size();) {
+            int first = rows.at(j);
+            const int last = first;
+            for (++j; j < rows.size() && rows.at(j) == first - 1; ++j)
+                first = rows.at(j);
+
+            // a new parent unknown to the probe, or one inside the moved rows means our tree is
+            // out of sync with the actual parents, take the rows out and add them again instead
+            if ((newParent && !m_childParentMap.contains(newParent))
+                || !beginMoveRows(indexForObject(oldParent), first, last,
+                                  indexForObject(newParent), m_parentChildMap.value(newParent).size())) {
+                reinsertRows(oldParent, first, last);
+                continue;
+            }
+            // make sure both exist, so taking references to them doesn't rehash
+            m_parentChildMap[oldParent];
+            m_parentChildMap[newParent];
+            QVector<QObject *> &oldSiblings = m_parentChildMap[oldParent];
+            QVector<QObject *> &newSiblings = m_parentChildMap[newParent];
+            const auto moved = oldSiblings.mid(first, last - first + 1);
+            oldSiblings.remove(first, last - first + 1);
+            for (QObject *obj : moved) {
+                m_childParentMap.insert(obj, newParent);
+                m_childRowMap.insert(obj, newSiblings.size());
+                newSiblings.push_back(obj);
+            }
+            endMoveRows();
+            // the new parent might be a sibling following the moved rows
+            updateRows(oldParent, first);
+        }
+    }
+}
+
+void ObjectTreeModel::reinsertRows(QObject *parent, int first, int last)
+{
+    beginRemoveRows(indexForObject(parent), first, last);
+    QVector<QObject *> &siblings = m_parentChildMap[parent];
+    const auto removed = siblings.mid(first, last - first + 1);
+    siblings.remove(first, last - first + 1);
+    for (QObject *obj : removed)
+        removeSubtree(obj);
+    endRemoveRows();
+    updateRows(parent, first);
+}
+
+void ObjectTreeModel::removeSubtree(QObject *object)
+{
+    const auto children = m_parentChildMap.take(object);
+    for (QObject *child : children)
+        removeSubtree(child);
+    m_childParentMap.remove(object);
+    m_childRowMap.remove(object);
+    m_pendingMoves.remove(object);
+
+    // objects reparented out of a destroyed sub-tree before we got to the move are still
+    // alive, add them again at their actual place
+    if (Probe::instance()->isValidObject(object) && !m_pendingRemovals.contains(object)) {
+        m_pendingAdds.push_back(object);
+        m_pendingAddSet.insert(object);
+    }
+}
+
+void ObjectTreeModel::updateRows(QObject *parent, int firstRow)
+{
+    const auto it = m_parentChildMap.constFind(parent);
+    if (it == m_parentChildMap.constEnd())
+        return;
+    for (int row = firstRow; row < it.value().size(); ++row)
+        m_childRowMap[it.value().at(row)] = row;
 }
 
 QVariant ObjectTreeModel::data(const QModelIndex &index, int role) const
@@ -240,25 +456,19 @@ QModelIndex ObjectTreeModel::parent(const QModelIndex &child) const
 QModelIndex ObjectTreeModel::index(int row, int column, const QModelIndex &parent) const
 {
     QObject *parentObj = reinterpret_cast<QObject *>(parent.internalPointer());
-    const QVector<QObject *> children = m_parentChildMap.value(parentObj);
-    if (row < 0 || column < 0 || row >= children.size() || column >= columnCount())
+    const auto it = m_parentChildMap.constFind(parentObj);
+    if (it == m_parentChildMap.constEnd() || row < 0 || column < 0 || row >= it.value().size()
+        || column >= columnCount())
         return {};
-    return createIndex(row, column, children.at(row));
+    return createIndex(row, column, it.value().at(row));
 }
 
 QModelIndex ObjectTreeModel::indexForObject(QObject *object) const
 {
     if (!object)
         return {};
-    QObject *parent = m_childParentMap.value(object);
-    const QModelIndex parentIndex = indexForObject(parent);
-    if (!parentIndex.isValid() && parent)
-        return QModelIndex();
-    const QVector<QObject *> &siblings = m_parentChildMap[ parent ];
-    auto it = std::lower_bound(siblings.constBegin(), siblings.constEnd(), object);
-    if (it == siblings.constEnd() || *it != object)
-        return QModelIndex();
-
-    const int row = std::distance(siblings.constBegin(), it);
-    return index(row, 0, parentIndex);
+    const auto it = m_childRowMap.constFind(object);
+    if (it == m_childRowMap.constEnd())
+        return {};
+    return createIndex(it.value(), 0, object);
 }
@@ -31,6 +31,8 @@
 
 #include "objectmodelbase.h"
 
+#include <QHash>
+#include <QSet>
 #include <QVector>
 
 namespace GammaRay {
@@ -50,6 +52,13 @@ public:
 
     Q_INVOKABLE QPair<int, QVariant> defaultSelectedItem() const;
 
+    /*!
+     * Collect object additions, removals and reparenting until the matching endBatch()
+     * call, and report them as ranged row changes per parent then. Calls can be nested.
+     */
+    void beginBatch();
+    void endBatch();
+
 private slots:
     void objectAdded(QObject *obj);
     void objectRemoved(QObject *obj);
@@ -57,10 +66,27 @@ private slots:
 
 private:
     QModelIndex indexForObject(QObject *object) const;
+    bool isTracked(QObject *object) const;
+
+    void applyPendingChanges();
+    void applyRemovals();
+    void applyAdditions();
+    void applyMoves();
+    void reinsertRows(QObject *parent, int first, int last);
+    void removeSubtree(QObject *object);
+    void updateRows(QObject *parent, int firstRow);
 
 private:
+    // children are kept in insertion order, m_childRowMap caches their row for O(1) lookups
     QHash<QObject *, QObject *> m_childParentMap;
+    QHash<QObject *, int> m_childRowMap;
     QHash<QObject *, QVector<QObject *> > m_parentChildMap;
+
+    int m_batchDepth;
+    QVector<QObject *> m_pendingAdds; // parents before children, might contain stale entries
+    QSet<QObject *> m_pendingAddSet;
+    QSet<QObject *> m_pendingRemovals;
+    QSet<QObject *> m_pendingMoves;
 };
 }
 
@@ -45,6 +45,8 @@
 #include "util.h"
 #include "varianthandler.h"
 #include "metaobjectregistry.h"
+#include "signalspysenderfilter.h"
+#include "callbackreadguard.h"
 
 #include "remote/server.h"
 #include "remote/remotemodelserver.h"
@@ -56,6 +58,7 @@
 #include <common/objectbroker.h>
 #include <common/streamoperators.h>
 #include <common/paths.h>
+#include <common/profilingpoint.h>
 
 #include <compat/qasconst.h>
 
@@ -86,22 +89,128 @@ using namespace std;
 QAtomicPointer<Probe> Probe::s_instance = QAtomicPointer<Probe>(nullptr);
 
 namespace GammaRay {
+namespace {
+// Registered signal spy callbacks of one kind, flattened into plain arrays.
+template<typename Callback>
+struct SignalSpyCallbacks
+{
+    QVector<Callback> all;
+    QVector<Callback> monitoredSendersOnly;
+
+    bool isEmpty() const { return all.isEmpty() && monitoredSendersOnly.isEmpty(); }
+    bool operator==(const SignalSpyCallbacks &other) const
+    {
+        return all == other.all && monitoredSendersOnly == other.monitoredSendersOnly;
+    }
+};
+
+// Never modified once published, registration replaces it as a whole (RCU style), so
+// emissions in any thread can dispatch without locking. Replaced tables are retired
+// until the callbacks that could still use them are done, see CallbackReadGuard.
+struct SignalSpyDispatchTable
+{
+    SignalSpyCallbacks<SignalSpyCallbackSet::BeginCallback> signalBegin;
+    SignalSpyCallbacks<SignalSpyCallbackSet::EndCallback> signalEnd;
+    SignalSpyCallbacks<SignalSpyCallbackSet::BeginCallback> slotBegin;
+    SignalSpyCallbacks<SignalSpyCallbackSet::EndCallback> slotEnd;
+
+    bool operator==(const SignalSpyDispatchTable &other) const
+    {
+        return signalBegin == other.signalBegin && signalEnd == other.signalEnd
+               && slotBegin == other.slotBegin && slotEnd == other.slotEnd;
+    }
+};
+}
+
+namespace {
+struct RetiredSignalSpyDispatchTable
+{
+    const SignalSpyDispatchTable *table;
+    CallbackGracePeriod gracePeriod;
+};
+}
+
+static QAtomicPointer<const SignalSpyDispatchTable> s_signalSpyDispatch;
+static QVector<RetiredSignalSpyDispatchTable> s_retiredSignalSpyDispatchTables;
+
+static void freeRetiredSignalSpyDispatchTables()
+{
+    for (auto it = s_retiredSignalSpyDispatchTables.begin(); it != s_retiredSignalSpyDispatchTables.end();) {
+        if (it->gracePeriod.hasElapsed()) {
+            delete it->table;
+            it = s_retiredSignalSpyDispatchTables.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(SignalSpySenderFilter, s_signalSpySenders)
+
+template<typename Callback>
+static void addSignalSpyCallback(SignalSpyCallbacks<Callback> &callbacks, Callback callback, bool monitoredSendersOnly)
+{
+    if (!callback)
+        return;
+    if (monitoredSendersOnly)
+        callbacks.monitoredSendersOnly.push_back(callback);
+    else
+        callbacks.all.push_back(callback);
+}
+
+/* Cheap pre-check before any per-object work, sets @p monitoredSender if the callbacks
+ * restricted to opted-in senders need to be called for @p caller.
+ */
+template<typename Callback>
+static bool needsSignalSpyDispatch(const SignalSpyCallbacks<Callback> &callbacks, QObject *caller, bool *monitoredSender)
+{
+    *monitoredSender = !callbacks.monitoredSendersOnly.isEmpty() && s_signalSpySenders()->mayContain(caller);
+    return *monitoredSender || !callbacks.all.isEmpty();
+}
+
+template<typename Callback, typename... Args>
+static void dispatchSignalSpyCallbacks(const SignalSpyCallbacks<Callback> &callbacks, bool monitoredSender, Args... args)
+{
+    for (const auto callback : callbacks.all)
+        callback(args...);
+    if (!monitoredSender)
+        return;
+    for (const auto callback : callbacks.monitoredSendersOnly)
+        callback(args...);
+}
+
 static void signal_begin_callback(QObject *caller, int method_index, void **argv)
 {
-    if (method_index == 0 || !Probe::instance() || Probe::instance()->filterObject(caller))
+    // only reads shared state, the guard writes to a per-thread stripe
+    if (method_index == 0 || !s_signalSpyDispatch.load())
+        return;
+    const CallbackReadGuard guard;
+    const auto table = s_signalSpyDispatch.loadAcquire();
+    if (!table || !Probe::instance())
+        return;
+
+    bool monitoredSender;
+    if (!needsSignalSpyDispatch(table->signalBegin, caller, &monitoredSender) || Probe::instance()->filterObject(caller))
         return;
+    GAMMARAY_PROFILE_SCOPE("Probe", "signal begin callbacks");
 
     method_index = Util::signalIndexToMethodIndex(caller->metaObject(), method_index);
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
-            if (callbacks.signalBeginCallback)
-                callbacks.signalBeginCallback(caller, method_index, argv);
-        });
+    dispatchSignalSpyCallbacks(table->signalBegin, monitoredSender, caller, method_index, argv);
 }
 
 static void signal_end_callback(QObject *caller, int method_index)
 {
-    if (method_index == 0 || !Probe::instance())
+    if (method_index == 0 || !s_signalSpyDispatch.load())
         return;
+    const CallbackReadGuard guard;
+    const auto table = s_signalSpyDispatch.loadAcquire();
+    if (!table || !Probe::instance())
+        return;
+
+    bool monitoredSender;
+    if (!needsSignalSpyDispatch(table->signalEnd, caller, &monitoredSender))
+        return;
+    GAMMARAY_PROFILE_SCOPE("Probe", "signal end callbacks");
 
     QMutexLocker locker(Probe::objectLock());
     if (!Probe::instance()->isValidObject(caller)) // implies filterObject()
@@ -109,39 +218,106 @@ static void signal_end_callback(QObject *caller, int method_index)
     locker.unlock();
 
     method_index = Util::signalIndexToMethodIndex(caller->metaObject(), method_index);
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
-            if (callbacks.signalEndCallback)
-                callbacks.signalEndCallback(caller, method_index);
-        });
+    dispatchSignalSpyCallbacks(table->signalEnd, monitoredSender, caller, method_index);
 }
 
 static void slot_begin_callback(QObject *caller, int method_index, void **argv)
 {
-    if (method_index == 0 || !Probe::instance() || Probe::instance()->filterObject(caller))
+    if (method_index == 0 || !s_signalSpyDispatch.load())
+        return;
+    const CallbackReadGuard guard;
+    const auto table = s_signalSpyDispatch.loadAcquire();
+    if (!table || !Probe::instance())
+        return;
+
+    bool monitoredSender;
+    if (!needsSignalSpyDispatch(table->slotBegin, caller, &monitoredSender) || Probe::instance()->filterObject(caller))
         return;
+    GAMMARAY_PROFILE_SCOPE("Probe", "slot begin callbacks");
 
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
-            if (callbacks.slotBeginCallback)
-                callbacks.slotBeginCallback(caller, method_index, argv);
-        });
+    dispatchSignalSpyCallbacks(table->slotBegin, monitoredSender, caller, method_index, argv);
 }
 
 static void slot_end_callback(QObject *caller, int method_index)
 {
-    if (method_index == 0 || !Probe::instance())
+    if (method_index == 0 || !s_signalSpyDispatch.load())
+        return;
+    const CallbackReadGuard guard;
+    const auto table = s_signalSpyDispatch.loadAcquire();
+    if (!table || !Probe::instance())
+        return;
+
+    bool monitoredSender;
+    if (!needsSignalSpyDispatch(table->slotEnd, caller, &monitoredSender))
         return;
+    GAMMARAY_PROFILE_SCOPE("Probe", "slot end callbacks");
 
     QMutexLocker locker(Probe::objectLock());
     if (!Probe::instance()->isValidObject(caller)) // implies filterObject()
         return; // deleted in the slot
     locker.unlock();
 
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
-            if (callbacks.slotEndCallback)
-                callbacks.slotEndCallback(caller, method_index);
-        });
+    dispatchSignalSpyCallbacks(table->slotEnd, monitoredSender, caller, method_index);
+}
+
+namespace {
+enum SignalSpyHook {
+    SignalBeginHook = 1,
+    SignalEndHook = 2,
+    SlotBeginHook = 4,
+    SlotEndHook = 8,
+    SignalSpyHookCombinations = 16
+};
+}
+
+static QSignalSpyCallbackSet signalSpyCallbackSet(int hooks)
+{
+    QSignalSpyCallbackSet cbs = {
+        (hooks & SignalBeginHook) ? signal_begin_callback : nullptr,
+        (hooks & SlotBeginHook) ? slot_begin_callback : nullptr,
+        (hooks & SignalEndHook) ? signal_end_callback : nullptr,
+        (hooks & SlotEndHook) ? slot_end_callback : nullptr
+    };
+    return cbs;
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+namespace {
+struct SignalSpyCallbackSets
+{
+    SignalSpyCallbackSets()
+    {
+        for (int hooks = 0; hooks < SignalSpyHookCombinations; ++hooks)
+            sets[hooks] = signalSpyCallbackSet(hooks);
+    }
+    QSignalSpyCallbackSet sets[SignalSpyHookCombinations];
+};
+}
+#endif
+
+// Merges the object changes done during its lifetime into ranged row changes in the object models.
+class ObjectModelBatch
+{
+public:
+    ObjectModelBatch(ObjectListModel *listModel, ObjectTreeModel *treeModel)
+        : m_listModel(listModel)
+        , m_treeModel(treeModel)
+    {
+        m_listModel->beginBatch();
+        m_treeModel->beginBatch();
+    }
+    ~ObjectModelBatch()
+    {
+        m_treeModel->endBatch();
+        m_listModel->endBatch();
+    }
+
+private:
+    Q_DISABLE_COPY(ObjectModelBatch)
+    ObjectListModel *m_listModel;
+    ObjectTreeModel *m_treeModel;
+};
+
 static QItemSelectionModel *selectionModelFactory(QAbstractItemModel *model)
 {
     Q_ASSERT(!model->objectName().isEmpty());
@@ -264,6 +440,13 @@ Probe::~Probe()
     };
     qt_register_signal_spy_callbacks(prevCallbacks);
 #endif
+    const auto table = s_signalSpyDispatch.fetchAndStoreOrdered(nullptr);
+    // callbacks still running in other threads may use any of the tables
+    CallbackReadGuard::synchronize();
+    delete table;
+    for (const auto &retired : qAsConst(s_retiredSignalSpyDispatchTables))
+        delete retired.table;
+    s_retiredSignalSpyDispatchTables.clear();
 
     ObjectBroker::clear();
     ProbeSettings::resetLauncherIdentifier();
@@ -339,6 +522,7 @@ void Probe::createProbe(bool findExisting)
         Q_ASSERT(!instance());
 
         s_instance = QAtomicPointer<Probe>(probe);
+        ObjectModelBatch batch(probe->m_objectListModel, probe->m_objectTreeModel);
 
         // add objects to the probe that were tracked before its creation
         foreach (QObject *obj, s_listener()->addedBeforeProbeInstance) {
@@ -541,6 +725,7 @@ QMutex *Probe::objectLock()
  */
 void Probe::objectAdded(QObject *obj, bool fromCtor)
 {
+    GAMMARAY_PROFILE_SCOPE("Probe", "objectAdded");
     QMutexLocker lock(s_lock());
 
     // attempt to ignore objects created by GammaRay itself, especially short-lived ones
@@ -623,6 +808,7 @@ void Probe::processQueuedObjectChanges()
     // must be called from the main thread via timeout
     Q_ASSERT(QThread::currentThread() == thread());
 
+    ObjectModelBatch batch(m_objectListModel, m_objectTreeModel);
     const auto queuedObjectChanges = m_queuedObjectChanges; // copy, in case this gets modified while we iterate (which can actually happen)
     for (const auto &change : queuedObjectChanges) {
         switch (change.type) {
@@ -654,6 +840,7 @@ void Probe::processQueuedObjectChanges()
 // pre-condition: lock is held already, our thread
 void Probe::objectFullyConstructed(QObject *obj)
 {
+    GAMMARAY_PROFILE_SCOPE("Probe", "objectCreated notification");
     Q_ASSERT(thread() == QThread::currentThread());
 
     if (!m_validObjects.contains(obj)) {
@@ -700,6 +887,11 @@ void Probe::objectFullyConstructed(QObject *obj)
  */
 void Probe::objectRemoved(QObject *obj)
 {
+    GAMMARAY_PROFILE_SCOPE("Probe", "objectRemoved");
+    auto signalSpySenders = s_signalSpySenders();
+    if (signalSpySenders && !signalSpySenders->isEmpty())
+        signalSpySenders->remove(obj);
+
     QMutexLocker lock(s_lock());
 
     if (!isInitialized()) {
@@ -811,6 +1003,7 @@ void Probe::notifyQueuedObjectChanges()
 
 bool Probe::eventFilter(QObject *receiver, QEvent *event)
 {
+    GAMMARAY_PROFILE_SCOPE("Probe", "global event filter");
     if (ProbeGuard::insideProbe() && receiver->thread() == QThread::currentThread())
         return QObject::eventFilter(receiver, event);
 
@@ -966,31 +1159,68 @@ void Probe::registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks)
     setupSignalSpyCallbacks();
 }
 
+void Probe::unregisterSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks)
+{
+    const auto it = std::find(m_signalSpyCallbacks.begin(), m_signalSpyCallbacks.end(), callbacks);
+    if (it == m_signalSpyCallbacks.end())
+        return;
+    m_signalSpyCallbacks.erase(it);
+    setupSignalSpyCallbacks();
+}
+
+void Probe::addSignalSpySender(const QObject *sender)
+{
+    s_signalSpySenders()->add(sender);
+}
+
+void Probe::removeSignalSpySender(const QObject *sender)
+{
+    s_signalSpySenders()->remove(sender);
+}
+
 void Probe::setupSignalSpyCallbacks()
 {
-    // memory management is with us for Qt >= 5.14, therefore static here!
-    static QSignalSpyCallbackSet cbs = { nullptr, nullptr, nullptr, nullptr };
-    foreach (const auto &it, m_signalSpyCallbacks) {
-        if (it.signalBeginCallback) cbs.signal_begin_callback = signal_begin_callback;
-        if (it.signalEndCallback) cbs.signal_end_callback = signal_end_callback;
-        if (it.slotBeginCallback) cbs.slot_begin_callback = slot_begin_callback;
-        if (it.slotEndCallback) cbs.slot_end_callback = slot_end_callback;
+    auto table = new SignalSpyDispatchTable;
+    for (const auto &it : qAsConst(m_signalSpyCallbacks)) {
+        addSignalSpyCallback(table->signalBegin, it.signalBeginCallback, it.monitoredSendersOnly);
+        addSignalSpyCallback(table->signalEnd, it.signalEndCallback, it.monitoredSendersOnly);
+        addSignalSpyCallback(table->slotBegin, it.slotBeginCallback, it.monitoredSendersOnly);
+        addSignalSpyCallback(table->slotEnd, it.slotEndCallback, it.monitoredSendersOnly);
+    }
+    const auto current = s_signalSpyDispatch.loadAcquire();
+    if (current && *current == *table) { // nothing to dispatch differently, keep the hooks as they are
+        delete table;
+        return;
     }
+    if (auto previous = s_signalSpyDispatch.fetchAndStoreOrdered(table))
+        s_retiredSignalSpyDispatchTables.push_back({ previous, CallbackGracePeriod() });
+    freeRetiredSignalSpyDispatchTables();
+
+    // only install the hooks somebody actually needs, Qt skips null callbacks at no cost
+    int hooks = 0;
+    if (!table->signalBegin.isEmpty())
+        hooks |= SignalBeginHook;
+    if (!table->signalEnd.isEmpty())
+        hooks |= SignalEndHook;
+    if (!table->slotBegin.isEmpty())
+        hooks |= SlotBeginHook;
+    if (!table->slotEnd.isEmpty())
+        hooks |= SlotEndHook;
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    qt_register_signal_spy_callbacks(&cbs);
+    if (m_signalSpyCallbacks.isEmpty()) {
+        qt_register_signal_spy_callbacks(m_previousSignalSpyCallbackSet);
+        return;
+    }
+    // memory management is with us for Qt >= 5.14, and Qt reads the set from any thread
+    // without locking, so a registered set must never change, we switch between
+    // immutable sets for all hook combinations instead
+    static SignalSpyCallbackSets callbackSets;
+    qt_register_signal_spy_callbacks(&callbackSets.sets[hooks]);
 #else
-    qt_register_signal_spy_callbacks(cbs);
+    qt_register_signal_spy_callbacks(signalSpyCallbackSet(hooks));
 #endif
 }
 
-template<typename Func>
-void Probe::executeSignalCallback(const Func &func)
-{
-    std::for_each(instance()->m_signalSpyCallbacks.constBegin(),
-                  instance()->m_signalSpyCallbacks.constEnd(),
-                  func);
-}
-
 SourceLocation Probe::objectCreationSourceLocation(QObject *object) const
 {
   if (!s_listener()->constructionBacktracesForObjects.contains(object)) {
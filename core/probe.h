@@ -175,6 +175,27 @@ public:
      * @since 2.2
      */
     void registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks);
+    /*!
+     * Unregister a signal spy callback set previously registered with registerSignalSpyCallbackSet().
+     * Once no callback set is left, the probe removes its hooks from Qt entirely.
+     * Tools should use this to only pay for signal tracing while being monitored.
+     *
+     * @since 2.12
+     */
+    void unregisterSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks);
+    /*!
+     * Opt @p sender in for signal spy callback sets with SignalSpyCallbackSet::monitoredSendersOnly set.
+     * Senders are removed automatically on destruction. Thread-safe.
+     *
+     * @since 2.12
+     */
+    void addSignalSpySender(const QObject *sender);
+    /*!
+     * Opt @p sender out again from callback sets added with addSignalSpySender(). Thread-safe.
+     *
+     * @since 2.12
+     */
+    void removeSignalSpySender(const QObject *sender);
 
     /*! Returns the source code location @p object was created at. */
     SourceLocation objectCreationSourceLocation(QObject *object) const;
@@ -215,7 +236,6 @@ public:
 
     ///@cond internal
     static void startupHookReceived();
-    template<typename Func> static void executeSignalCallback(const Func &func);
     ///@endcond
 
     ProblemCollector *problemCollector() const;
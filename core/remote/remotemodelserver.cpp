@@ -32,6 +32,7 @@
 #include <common/protocol.h>
 #include <common/message.h>
 #include <common/modelevent.h>
+#include <common/profilingpoint.h>
 #include <common/sourcelocation.h>
 
 #include <compat/qasconst.h>
@@ -165,12 +166,14 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
             const QModelIndex qmIndex = Protocol::toQModelIndex(m_model, index);
 
             qint32 rowCount = -1, columnCount = -1;
+            bool canFetchMore = false;
             if (index.isEmpty() || qmIndex.isValid()) {
                 rowCount = m_model->rowCount(qmIndex);
                 columnCount = m_model->columnCount(qmIndex);
+                canFetchMore = m_model->canFetchMore(qmIndex);
             }
 
-            reply << index << rowCount << columnCount;
+            reply << index << rowCount << columnCount << canFetchMore;
         }
         sendMessage(reply);
         break;
@@ -195,12 +198,16 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
         if (indexes.isEmpty())
             break;
 
+        static ProfilingPoint serializationPoint("Remote", "model content serialization");
+        ScopedProfilingTimer timer(serializationPoint);
         Message msg(m_myAddress, Protocol::ModelContentReply);
         msg << quint32(indexes.size());
         for (const auto &qmIndex : qAsConst(indexes))
             msg << Protocol::fromQModelIndex(qmIndex)
                           << filterItemData(m_model->itemData(qmIndex))
                           << qint32(m_model->flags(qmIndex));
+        if (ProfilingPoint::isEnabled())
+            serializationPoint.addBytes(msg.size());
 
         sendMessage(msg);
         break;
@@ -248,6 +255,26 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
         break;
     }
 
+    case Protocol::ModelFetchMoreRequest:
+    {
+        Protocol::ModelIndex index;
+        msg >> index;
+        const QModelIndex qmIndex = Protocol::toQModelIndex(m_model, index);
+
+        // one fetchMore() per request, the client asks again as long as its views want more
+        bool canFetchMore = false;
+        if (index.isEmpty() || qmIndex.isValid()) {
+            if (m_model->canFetchMore(qmIndex))
+                m_model->fetchMore(qmIndex);
+            canFetchMore = m_model->canFetchMore(qmIndex);
+        }
+
+        Message reply(m_myAddress, Protocol::ModelFetchMoreReply);
+        reply << index << canFetchMore;
+        sendMessage(reply);
+        break;
+    }
+
     case Protocol::ModelSyncBarrier:
     {
         qint32 barrierId;
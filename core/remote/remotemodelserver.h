@@ -29,6 +29,8 @@
 #ifndef GAMMARAY_REMOTEMODELSERVER_H
 #define GAMMARAY_REMOTEMODELSERVER_H
 
+#include "gammaray_core_export.h"
+
 #include <common/protocol.h>
 
 #include <QObject>
@@ -47,7 +49,7 @@ class Message;
  *  If the source model is a QSortFilterProxyModel, this also forwards properties for configuring
  *  the proxy behavior, enabling server-side searching and sorting.
  */
-class RemoteModelServer : public QObject
+class GAMMARAY_CORE_EXPORT RemoteModelServer : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool dynamicSortFilter READ proxyDynamicSortFilter WRITE setProxyDynamicSortFilter)
@@ -28,6 +28,7 @@
 
 #include "remoteviewserver.h"
 
+#include <common/profilingpoint.h>
 #include <common/remoteviewframe.h>
 
 #include <core/remote/server.h>
@@ -98,6 +99,10 @@ void RemoteViewServer::setGrabberReady(bool ready)
 
 void RemoteViewServer::sendFrame(const RemoteViewFrame &frame)
 {
+    static ProfilingPoint sendFramePoint("Remote View", "frame transmission");
+    ScopedProfilingTimer timer(sendFramePoint);
+    if (ProfilingPoint::isEnabled())
+        sendFramePoint.addBytes(frame.image().bytesPerLine() * frame.image().height());
     m_clientReady = false;
 
     const QSize frameImageSize = frame.image().size() / frame.image().devicePixelRatio();
@@ -35,3 +35,10 @@ bool SignalSpyCallbackSet::isNull() const
     return signalBeginCallback == nullptr && signalEndCallback == nullptr && slotBeginCallback == nullptr
            && slotEndCallback == nullptr;
 }
+
+bool SignalSpyCallbackSet::operator==(const SignalSpyCallbackSet &other) const
+{
+    return signalBeginCallback == other.signalBeginCallback && signalEndCallback == other.signalEndCallback
+           && slotBeginCallback == other.slotBeginCallback && slotEndCallback == other.slotEndCallback
+           && monitoredSendersOnly == other.monitoredSendersOnly;
+}
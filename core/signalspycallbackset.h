@@ -46,6 +46,7 @@ struct GAMMARAY_CORE_EXPORT SignalSpyCallbackSet
 {
     SignalSpyCallbackSet() = default;
     bool isNull() const;
+    bool operator==(const SignalSpyCallbackSet &other) const;
 
     using BeginCallback = void (*)(QObject *, int, void **);
     using EndCallback = void (*)(QObject *, int);
@@ -54,6 +55,12 @@ struct GAMMARAY_CORE_EXPORT SignalSpyCallbackSet
     EndCallback signalEndCallback = nullptr;
     BeginCallback slotBeginCallback = nullptr;
     EndCallback slotEndCallback = nullptr;
+
+    /** Only invoke these callbacks for senders opted in via Probe::addSignalSpySender().
+     *  The sender check is a cheap pre-filter and allows false positives.
+     *  @since 2.12
+     */
+    bool monitoredSendersOnly = false;
 };
 }
 
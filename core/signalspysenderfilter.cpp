@@ -0,0 +1,114 @@
+/*
+  signalspysenderfilter.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signalspysenderfilter.h"
+
+#include <compat/qasconst.h>
+
+#include <QMutexLocker>
+
+using namespace GammaRay;
+
+SignalSpySenderFilter::SignalSpySenderFilter()
+    : m_bits(new Bitmap)
+    , m_staleCount(0)
+{
+}
+
+SignalSpySenderFilter::~SignalSpySenderFilter()
+{
+    CallbackReadGuard::synchronize();
+    delete m_bits.loadAcquire();
+    for (const auto &retired : qAsConst(m_retiredBits))
+        delete retired.bits;
+}
+
+void SignalSpySenderFilter::setBit(Bitmap &bits, quint32 h)
+{
+    h &= BitCount - 1;
+    bits.words[h / 32].fetchAndOrRelease(1u << (h % 32));
+}
+
+void SignalSpySenderFilter::add(const QObject *sender)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_senders.contains(sender))
+        return;
+    m_senders.insert(sender);
+    m_size.storeRelease(m_senders.size());
+
+    auto bits = m_bits.loadAcquire();
+    const auto h = hash(sender);
+    setBit(*bits, h);
+    setBit(*bits, h >> 16);
+}
+
+void SignalSpySenderFilter::remove(const QObject *sender)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_senders.remove(sender))
+        return;
+    m_size.storeRelease(m_senders.size());
+
+    // bits can't be cleared individually, rebuild once they start to cause too many false positives
+    if (++m_staleCount > qMax(64, m_senders.size()))
+        rebuild();
+}
+
+void SignalSpySenderFilter::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_senders.clear();
+    m_size.storeRelease(0);
+    rebuild();
+}
+
+void SignalSpySenderFilter::rebuild()
+{
+    // lookups in flight keep working on the old bitmap, it's only freed after their grace period
+    auto bits = new Bitmap;
+    for (auto sender : qAsConst(m_senders)) {
+        const auto h = hash(sender);
+        setBit(*bits, h);
+        setBit(*bits, h >> 16);
+    }
+    m_retiredBits.push_back({ m_bits.fetchAndStoreOrdered(bits), CallbackGracePeriod() });
+    m_staleCount = 0;
+    freeRetiredBitmaps();
+}
+
+void SignalSpySenderFilter::freeRetiredBitmaps()
+{
+    for (auto it = m_retiredBits.begin(); it != m_retiredBits.end();) {
+        if (it->gracePeriod.hasElapsed()) {
+            delete it->bits;
+            it = m_retiredBits.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+  signalspysenderfilter.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_SIGNALSPYSENDERFILTER_H
+#define GAMMARAY_SIGNALSPYSENDERFILTER_H
+
+#include "gammaray_core_export.h"
+#include "callbackreadguard.h"
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** @brief Set of senders signal spy callbacks opted in to, optimized for the negative lookup.
+ *
+ *  Lookups are lock-free and go through a bloom filter, so they can yield false positives
+ *  but never false negatives. Callbacks still need to check the sender themselves.
+ *  Modifications are serialized, removal rebuilds the filter once enough stale bits piled up.
+ *  A rebuild publishes a new bitmap, the old one is freed once no CallbackReadGuard that
+ *  could still be reading it is alive.
+ */
+class GAMMARAY_CORE_EXPORT SignalSpySenderFilter
+{
+public:
+    SignalSpySenderFilter();
+    ~SignalSpySenderFilter();
+
+    void add(const QObject *sender);
+    void remove(const QObject *sender);
+    void clear();
+
+    /** Returns @c false if @p sender has definitely not been added.
+     *  Thread-safe, as long as the calling thread holds a CallbackReadGuard.
+     */
+    bool mayContain(const QObject *sender) const
+    {
+        const Bitmap *bits = m_bits.loadAcquire();
+        const auto h = hash(sender);
+        return testBit(*bits, h) && testBit(*bits, h >> 16);
+    }
+
+    /** Returns @c true if no sender has been added, ie. nothing needs to be removed. Thread-safe. */
+    bool isEmpty() const
+    {
+        return m_size.loadAcquire() == 0;
+    }
+
+private:
+    Q_DISABLE_COPY(SignalSpySenderFilter)
+
+    enum {
+        BitCount = 1 << 16,
+        WordCount = BitCount / 32
+    };
+    struct Bitmap
+    {
+        QAtomicInteger<quint32> words[WordCount];
+    };
+    struct RetiredBitmap
+    {
+        Bitmap *bits;
+        CallbackGracePeriod gracePeriod;
+    };
+
+    static quint32 hash(const QObject *sender)
+    {
+        // objects are at least pointer aligned, scramble the rest (Fibonacci hashing)
+        const auto p = quint64(reinterpret_cast<quintptr>(sender)) >> 3;
+        return quint32((p * Q_UINT64_C(11400714819323198485)) >> 32);
+    }
+    static bool testBit(const Bitmap &bits, quint32 h)
+    {
+        h &= BitCount - 1;
+        return bits.words[h / 32].load() & (1u << (h % 32));
+    }
+    static void setBit(Bitmap &bits, quint32 h);
+    void rebuild();
+    void freeRetiredBitmaps();
+
+    QAtomicPointer<Bitmap> m_bits;
+    QAtomicInt m_size;
+    int m_staleCount;
+    QMutex m_mutex; // protects modifications, m_senders and m_retiredBits
+    QSet<const QObject *> m_senders;
+    QVector<RetiredBitmap> m_retiredBits;
+};
+}
+
+#endif // GAMMARAY_SIGNALSPYSENDERFILTER_H
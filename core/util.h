@@ -164,6 +164,35 @@ GAMMARAY_CORE_EXPORT void drawTransparencyPattern(QPainter *painter, const QRect
  */
 GAMMARAY_CORE_EXPORT int signalIndexToMethodIndex(const QMetaObject *metaObject, int signalIndex);
 
+/*!
+ * Converts a duration in nanoseconds into milliseconds, rounded down to
+ * full microseconds, for display.
+ * @since 2.12
+ */
+inline double nsecsToMSecs(qint64 nsecs)
+{
+    return double(nsecs / 1000) / 1000.0;
+}
+
+/*!
+ * Converts a duration in nanoseconds into microseconds, rounded down to
+ * 10 nanoseconds, for display.
+ * @since 2.12
+ */
+inline double nsecsToUSecs(qint64 nsecs)
+{
+    return double(nsecs / 10) / 100.0;
+}
+
+/*!
+ * Converts a duration in microseconds into milliseconds, for display.
+ * @since 2.12
+ */
+inline double usecsToMSecs(qint64 usecs)
+{
+    return double(usecs) / 1000.0;
+}
+
 /*!
  * Checks if the given pointer should be considered a nullptr.
  * One would assume this to be trivial, but there are some interesting hacks
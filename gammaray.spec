@@ -126,6 +126,7 @@ cmake . -DCMAKE_INSTALL_PREFIX=/usr -DCMAKE_BUILD_TYPE=Release -DKDE_INSTALL_USE
 %{_libdir}/gammaray/*/*/gammaray_actioninspector*
 %{_libdir}/gammaray/*/*/gammaray_bluetooth*
 %{_libdir}/gammaray/*/*/gammaray_codecbrowser*
+%{_libdir}/gammaray/*/*/gammaray_eventloopmonitor*
 %{_libdir}/gammaray/*/*/gammaray_eventmonitor*
 %{_libdir}/gammaray/*/*/gammaray_fontbrowser*
 %{_libdir}/gammaray/*/*/gammaray_guisupport*
@@ -134,6 +135,7 @@ cmake . -DCMAKE_INSTALL_PREFIX=/usr -DCMAKE_BUILD_TYPE=Release -DKDE_INSTALL_USE
 %{_libdir}/gammaray/*/*/gammaray_modelinspector*
 %{_libdir}/gammaray/*/*/gammaray_network*
 %{_libdir}/gammaray/*/*/gammaray_objectvisualizer*
+%{_libdir}/gammaray/*/*/gammaray_probeperformance*
 %{_libdir}/gammaray/*/*/gammaray_qmlsupport*
 %{_libdir}/gammaray/*/*/gammaray_qtivi_ui*
 %{_libdir}/gammaray/*/*/gammaray_quickinspector*
@@ -0,0 +1,129 @@
+/*
+  eventloopmonitor.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopmonitor.h"
+#include "eventloopwatchdog.h"
+#include "stallmodel.h"
+#include "threadlatencymodel.h"
+
+#include <core/callbackreadguard.h>
+#include <core/probe.h>
+#include <core/stacktracemodel.h>
+
+#include <common/objectbroker.h>
+
+#include <QAtomicPointer>
+#include <QItemSelectionModel>
+#include <QTimer>
+
+using namespace GammaRay;
+
+static QAtomicPointer<EventLoopWatchdog> s_watchdog;
+
+static bool eventCallback(void **data)
+{
+    if (!s_watchdog.load())
+        return false;
+
+    const CallbackReadGuard guard;
+    if (EventLoopWatchdog *watchdog = s_watchdog.loadAcquire()) {
+        QObject *receiver = reinterpret_cast<QObject*>(data[0]);
+        QEvent *event = reinterpret_cast<QEvent*>(data[1]);
+        watchdog->eventNotify(receiver, event);
+    }
+    return false;
+}
+
+EventLoopMonitor::EventLoopMonitor(Probe *probe, QObject *parent)
+    : EventLoopMonitorInterface(parent)
+    , m_watchdog(new EventLoopWatchdog(this))
+    , m_stallModel(new StallModel(this))
+    , m_threadModel(new ThreadLatencyModel(this))
+    , m_stackTraceModel(new StackTraceModel(this))
+    , m_updateTimer(new QTimer(this))
+{
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.EventLoopStallModel"), m_stallModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.EventLoopThreadModel"), m_threadModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.EventLoopStackTraceModel"), m_stackTraceModel);
+
+    auto selModel = ObjectBroker::selectionModel(m_stallModel);
+    connect(selModel, &QItemSelectionModel::selectionChanged, this, &EventLoopMonitor::stallSelected);
+
+    // stalls are reported from the stalled thread once it recovers
+    connect(m_watchdog, &EventLoopWatchdog::stallDetected, m_stallModel, &StallModel::addStall, Qt::QueuedConnection);
+    m_watchdog->setThreshold(stallThreshold());
+    connect(this, &EventLoopMonitorInterface::stallThresholdChanged, m_watchdog, &EventLoopWatchdog::setThreshold);
+
+    m_updateTimer->setInterval(500);
+    connect(m_updateTimer, &QTimer::timeout, this, &EventLoopMonitor::updateThreadLatencies);
+    m_updateTimer->start();
+
+    Q_ASSERT(s_watchdog.loadAcquire() == nullptr);
+    s_watchdog.storeRelease(m_watchdog);
+    QInternal::registerCallback(QInternal::EventNotifyCallback, eventCallback);
+    m_watchdog->start(QThread::HighPriority);
+}
+
+EventLoopMonitor::~EventLoopMonitor()
+{
+    QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventCallback);
+    s_watchdog.fetchAndStoreOrdered(nullptr);
+    // other threads can still be inside eventCallback() with the old pointer, the watchdog
+    // is deleted after this as our child, so wait for them to leave first
+    CallbackReadGuard::synchronize();
+    m_watchdog->stop();
+}
+
+void EventLoopMonitor::clearHistory()
+{
+    m_stallModel->clear();
+    m_watchdog->resetStatistics();
+    updateThreadLatencies();
+}
+
+void EventLoopMonitor::updateThreadLatencies()
+{
+    m_threadModel->setLatencies(m_watchdog->threadLatencies());
+}
+
+void EventLoopMonitor::stallSelected(const QItemSelection &selection)
+{
+    if (selection.isEmpty()) {
+        m_stackTraceModel->setStackTrace(Execution::Trace());
+        setStackTraceAvailable(false);
+        return;
+    }
+
+    const auto idx = selection.at(0).topLeft();
+    m_stackTraceModel->setStackTrace(m_stallModel->stackTrace(idx.row()));
+    setStackTraceAvailable(m_stackTraceModel->rowCount() > 0);
+}
+
+EventLoopMonitorFactory::EventLoopMonitorFactory(QObject *parent)
+    : QObject(parent)
+{
+}
@@ -0,0 +1,81 @@
+/*
+  eventloopmonitor.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITOR_H
+#define GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITOR_H
+
+#include "eventloopmonitorinterface.h"
+
+#include <core/toolfactory.h>
+
+QT_BEGIN_NAMESPACE
+class QItemSelection;
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class EventLoopWatchdog;
+class StackTraceModel;
+class StallModel;
+class ThreadLatencyModel;
+
+class EventLoopMonitor : public EventLoopMonitorInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::EventLoopMonitorInterface)
+
+public:
+    explicit EventLoopMonitor(Probe *probe, QObject *parent = nullptr);
+    ~EventLoopMonitor() override;
+
+public slots:
+    void clearHistory() override;
+
+private slots:
+    void updateThreadLatencies();
+    void stallSelected(const QItemSelection &selection);
+
+private:
+    EventLoopWatchdog *m_watchdog;
+    StallModel *m_stallModel;
+    ThreadLatencyModel *m_threadModel;
+    StackTraceModel *m_stackTraceModel;
+    QTimer *m_updateTimer;
+};
+
+class EventLoopMonitorFactory : public QObject, public StandardToolFactory<QObject, EventLoopMonitor>
+{
+    Q_OBJECT
+    Q_INTERFACES(GammaRay::ToolFactory)
+    Q_PLUGIN_METADATA(IID "com.kdab.GammaRay.ToolFactory" FILE "gammaray_eventloopmonitor.json")
+
+public:
+    explicit EventLoopMonitorFactory(QObject *parent = nullptr);
+};
+}
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITOR_H
@@ -0,0 +1,69 @@
+/*
+  eventloopmonitorinterface.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITORINTERFACE_H
+#define GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITORINTERFACE_H
+
+#include <QObject>
+
+namespace GammaRay {
+class EventLoopMonitorInterface : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int stallThreshold READ stallThreshold WRITE setStallThreshold NOTIFY stallThresholdChanged)
+    Q_PROPERTY(bool stackTraceAvailable READ stackTraceAvailable WRITE setStackTraceAvailable NOTIFY stackTraceAvailableChanged)
+
+public:
+    explicit EventLoopMonitorInterface(QObject *parent = nullptr);
+    ~EventLoopMonitorInterface() override;
+
+    /// Event loop latency in milliseconds above which a stall is reported.
+    int stallThreshold() const;
+    void setStallThreshold(int msecs);
+
+    bool stackTraceAvailable() const;
+    void setStackTraceAvailable(bool available);
+
+public slots:
+    virtual void clearHistory() = 0;
+
+signals:
+    void stallThresholdChanged(int msecs);
+    void stackTraceAvailableChanged(bool available);
+
+private:
+    int m_stallThreshold;
+    bool m_stackTraceAvailable;
+};
+}
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_INTERFACE(GammaRay::EventLoopMonitorInterface,
+                    "com.kdab.GammaRay.EventLoopMonitorInterface/1.0")
+QT_END_NAMESPACE
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMONITORINTERFACE_H
@@ -0,0 +1,106 @@
+/*
+  eventloopmonitorwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopmonitorwidget.h"
+#include "ui_eventloopmonitorwidget.h"
+#include "eventloopmonitorclient.h"
+
+#include <ui/contextmenuextension.h>
+#include <ui/propertyeditor/propertyeditordelegate.h>
+
+#include <common/objectbroker.h>
+#include <common/sourcelocation.h>
+
+#include <QMenu>
+
+using namespace GammaRay;
+
+static QObject *createEventLoopMonitorClient(const QString & /*name*/, QObject *parent)
+{
+    return new EventLoopMonitorClient(parent);
+}
+
+EventLoopMonitorWidget::EventLoopMonitorWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::EventLoopMonitorWidget)
+    , m_stateManager(this)
+{
+    ui->setupUi(this);
+
+    ObjectBroker::registerClientObjectFactoryCallback<EventLoopMonitorInterface *>(
+        createEventLoopMonitorClient);
+    m_interface = ObjectBroker::object<EventLoopMonitorInterface *>();
+
+    ui->threadView->header()->setObjectName("threadViewHeader");
+    ui->threadView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    for (int i = 1; i < 5; ++i)
+        ui->threadView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->threadView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventLoopThreadModel")));
+
+    ui->stallView->header()->setObjectName("stallViewHeader");
+    for (int i = 0; i < 4; ++i)
+        ui->stallView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    auto stallModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventLoopStallModel"));
+    ui->stallView->setModel(stallModel);
+    ui->stallView->setSelectionModel(ObjectBroker::selectionModel(stallModel));
+
+    ui->backtraceView->header()->setObjectName("backtraceViewHeader");
+    ui->backtraceView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventLoopStackTraceModel")));
+    ui->backtraceView->setItemDelegate(new PropertyEditorDelegate(ui->backtraceView));
+    ui->backtraceView->setVisible(m_interface->stackTraceAvailable());
+    connect(m_interface, &EventLoopMonitorInterface::stackTraceAvailableChanged, ui->backtraceView, &QWidget::setVisible);
+    connect(ui->backtraceView, &QWidget::customContextMenuRequested, this, &EventLoopMonitorWidget::stackTraceContextMenu);
+
+    ui->thresholdBox->setValue(m_interface->stallThreshold());
+    connect(m_interface, &EventLoopMonitorInterface::stallThresholdChanged, ui->thresholdBox, &QSpinBox::setValue);
+    connect(ui->thresholdBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            m_interface, &EventLoopMonitorInterface::setStallThreshold);
+
+    connect(ui->clearButton, &QAbstractButton::clicked, m_interface, &EventLoopMonitorInterface::clearHistory);
+
+    m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "33%" << "67%");
+    m_stateManager.setDefaultSizes(ui->stallSplitter, UISizeVector() << "60%" << "40%");
+}
+
+EventLoopMonitorWidget::~EventLoopMonitorWidget() = default;
+
+void EventLoopMonitorWidget::stackTraceContextMenu(QPoint pos)
+{
+    const auto idx = ui->backtraceView->indexAt(pos);
+    if (!idx.isValid())
+        return;
+
+    const auto loc = idx.sibling(idx.row(), 1).data().value<SourceLocation>();
+    if (!loc.isValid())
+        return;
+
+    QMenu contextMenu;
+    ContextMenuExtension cme;
+    cme.setLocation(ContextMenuExtension::ShowSource, loc);
+    cme.populateMenu(&contextMenu);
+    contextMenu.exec(ui->backtraceView->viewport()->mapToGlobal(pos));
+}
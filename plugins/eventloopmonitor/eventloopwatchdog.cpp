@@ -0,0 +1,325 @@
+/*
+  eventloopwatchdog.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopwatchdog.h"
+
+#include <core/probe.h>
+#include <core/probeguard.h>
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <QAbstractEventDispatcher>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QThreadStorage>
+
+using namespace GammaRay;
+
+static const int MaxStackDepth = 32;
+
+namespace GammaRay {
+class EventLoopHeartbeat : public QObject
+{
+public:
+    explicit EventLoopHeartbeat(EventLoopWatchdog *watchdog, EventLoopThreadState *state)
+        : m_watchdog(watchdog)
+        , m_state(state)
+    {
+    }
+
+    static QEvent::Type eventType()
+    {
+        static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+        return type;
+    }
+
+    void detach()
+    {
+        m_watchdog.storeRelease(nullptr);
+    }
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() != eventType())
+            return QObject::event(event);
+        if (auto watchdog = m_watchdog.loadAcquire())
+            watchdog->heartbeatReceived(m_state);
+        return true;
+    }
+
+private:
+    QAtomicPointer<EventLoopWatchdog> m_watchdog;
+    EventLoopThreadState *m_state;
+};
+
+struct EventLoopThreadState
+{
+    EventLoopWatchdog *watchdog = nullptr;
+    EventLoopHeartbeat *heartbeat = nullptr;
+
+    // written by the event notify hook of the thread, read by the watchdog
+    QAtomicInt eventType;
+    QAtomicPointer<QObject> receiver;
+    QAtomicInt sampleRequested;
+    QAtomicInt alive;
+
+    // guarded by EventLoopWatchdog::m_mutex
+    qint64 heartbeatPosted = -1;
+    bool stalled = false;
+    int stallEventType = QEvent::None;
+    QObject *stallReceiver = nullptr;
+    Execution::Trace trace;
+    EventLoopThreadLatency stats;
+};
+}
+
+namespace {
+// marks the thread state as dead when the thread exits
+struct ThreadStateRef
+{
+    ~ThreadStateRef()
+    {
+        state->alive.storeRelease(0);
+    }
+
+    QSharedPointer<EventLoopThreadState> state;
+};
+}
+
+static QThreadStorage<ThreadStateRef *> s_threadStates;
+
+EventLoopWatchdog::EventLoopWatchdog(QObject *parent)
+    : QThread(parent)
+    , m_threshold(200 * 1000000LL)
+    , m_stop(false)
+{
+    qRegisterMetaType<EventLoopStall>();
+    setObjectName(QStringLiteral("GammaRay event loop watchdog"));
+    m_clock.start();
+}
+
+EventLoopWatchdog::~EventLoopWatchdog()
+{
+    stop();
+
+    QMutexLocker lock(&m_mutex);
+    for (const auto &state : qAsConst(m_threads)) {
+        state->heartbeat->detach();
+        QCoreApplication::removePostedEvents(state->heartbeat, EventLoopHeartbeat::eventType());
+        if (state->alive.loadAcquire())
+            state->heartbeat->deleteLater();
+        else
+            delete state->heartbeat;
+    }
+    m_threads.clear();
+}
+
+int EventLoopWatchdog::threshold() const
+{
+    QMutexLocker lock(&m_mutex);
+    return int(m_threshold / 1000000);
+}
+
+void EventLoopWatchdog::setThreshold(int msecs)
+{
+    QMutexLocker lock(&m_mutex);
+    m_threshold = qMax(1, msecs) * 1000000LL;
+    m_condition.wakeAll();
+}
+
+void EventLoopWatchdog::stop()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stop = true;
+        m_condition.wakeAll();
+    }
+    wait();
+}
+
+void EventLoopWatchdog::resetStatistics()
+{
+    QMutexLocker lock(&m_mutex);
+    for (const auto &state : qAsConst(m_threads)) {
+        EventLoopThreadLatency stats;
+        stats.threadId = state->stats.threadId;
+        stats.thread = state->stats.thread;
+        state->stats = stats;
+    }
+}
+
+QVector<EventLoopThreadLatency> EventLoopWatchdog::threadLatencies() const
+{
+    QMutexLocker lock(&m_mutex);
+    const qint64 now = m_clock.nsecsElapsed();
+    QVector<EventLoopThreadLatency> result;
+    result.reserve(m_threads.size());
+    for (const auto &state : qAsConst(m_threads)) {
+        if (!state->alive.loadAcquire())
+            continue;
+        EventLoopThreadLatency stats = state->stats;
+        stats.stalled = state->stalled;
+        if (state->stalled) // still waiting for the heartbeat
+            stats.lastLatency = now - state->heartbeatPosted;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void EventLoopWatchdog::eventNotify(QObject *receiver, QEvent *event)
+{
+    EventLoopThreadState *state = s_threadStates.hasLocalData() ? s_threadStates.localData()->state.data() : nullptr;
+    if (!state || state->watchdog != this) {
+        // heartbeats would never arrive on a thread without an event loop
+        if (!QAbstractEventDispatcher::instance())
+            return;
+        state = registerThread();
+    }
+
+    // a stalled thread dispatching nested events is the one chance to see where it is stuck
+    // without interrupting it from the outside, the first such event is usually the heartbeat
+    if (state->sampleRequested.testAndSetOrdered(1, 0)) {
+        const Execution::Trace trace = Execution::stackTrace(MaxStackDepth, 1);
+        QMutexLocker lock(&m_mutex);
+        if (state->stalled && state->trace.empty())
+            state->trace = trace;
+    }
+
+    if (receiver == state->heartbeat)
+        return;
+
+    state->eventType.storeRelease(event->type());
+    state->receiver.storeRelease(receiver);
+}
+
+EventLoopThreadState *EventLoopWatchdog::registerThread()
+{
+    ProbeGuard guard; // keeps the heartbeat object out of the object models
+
+    QSharedPointer<EventLoopThreadState> state(new EventLoopThreadState);
+    state->watchdog = this;
+    state->heartbeat = new EventLoopHeartbeat(this, state.data());
+    state->alive.storeRelease(1);
+
+    QThread *thread = QThread::currentThread();
+    state->stats.threadId = reinterpret_cast<quintptr>(thread);
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        state->stats.thread = tr("Main Thread");
+    else if (!thread->objectName().isEmpty())
+        state->stats.thread = thread->objectName();
+    else
+        state->stats.thread = Util::addressToString(thread);
+
+    auto ref = new ThreadStateRef;
+    ref->state = state;
+    s_threadStates.setLocalData(ref);
+
+    QMutexLocker lock(&m_mutex);
+    m_threads.push_back(state);
+    return state.data();
+}
+
+void EventLoopWatchdog::heartbeatReceived(EventLoopThreadState *state)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    EventLoopStall stall;
+    QObject *receiver = nullptr;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (state->heartbeatPosted < 0)
+            return;
+
+        const qint64 latency = now - state->heartbeatPosted;
+        state->heartbeatPosted = -1;
+
+        auto &stats = state->stats;
+        stats.lastLatency = latency;
+        stats.maxLatency = qMax(stats.maxLatency, latency);
+        stats.totalLatency += latency;
+        ++stats.heartbeats;
+
+        const bool stalled = state->stalled || latency >= m_threshold;
+        state->stalled = false;
+        state->sampleRequested.storeRelease(0);
+        if (stalled) {
+            ++stats.stalls;
+            stall.thread = stats.thread;
+            stall.duration = latency;
+            stall.eventType = state->stallEventType;
+            stall.trace = state->trace;
+            receiver = state->stallReceiver;
+        }
+        state->stallEventType = QEvent::None;
+        state->stallReceiver = nullptr;
+        state->trace = Execution::Trace();
+        if (!stalled)
+            return;
+    }
+
+    stall.time = QTime::currentTime().addMSecs(-int(stall.duration / 1000000));
+    if (receiver) {
+        QMutexLocker lock(Probe::objectLock());
+        if (Probe::instance() && Probe::instance()->isValidObject(receiver))
+            stall.receiver = Util::displayString(receiver);
+        else
+            stall.receiver = Util::addressToString(receiver);
+    }
+    emit stallDetected(stall);
+}
+
+void EventLoopWatchdog::run()
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_stop) {
+        const qint64 now = m_clock.nsecsElapsed();
+        for (auto it = m_threads.begin(); it != m_threads.end();) {
+            EventLoopThreadState *state = it->data();
+            if (!state->alive.loadAcquire()) {
+                // the thread is gone, and so is any chance of delivering its heartbeat
+                delete state->heartbeat;
+                it = m_threads.erase(it);
+                continue;
+            }
+
+            if (state->heartbeatPosted < 0) {
+                state->heartbeatPosted = now;
+                QCoreApplication::postEvent(state->heartbeat, new QEvent(EventLoopHeartbeat::eventType()));
+            } else if (!state->stalled && now - state->heartbeatPosted >= m_threshold) {
+                state->stalled = true;
+                state->stallEventType = state->eventType.loadAcquire();
+                state->stallReceiver = state->receiver.loadAcquire();
+                state->sampleRequested.storeRelease(1);
+            }
+            ++it;
+        }
+
+        // check often enough to notice a stall while it is still going on
+        m_condition.wait(&m_mutex, qBound<qint64>(10, m_threshold / 4000000, 100));
+    }
+}
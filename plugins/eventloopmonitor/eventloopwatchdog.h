@@ -0,0 +1,119 @@
+/*
+  eventloopwatchdog.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPWATCHDOG_H
+#define GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPWATCHDOG_H
+
+#include <core/execution.h>
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMetaType>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QTime>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace GammaRay {
+
+struct EventLoopThreadState;
+
+/** A event loop stall, ie. a heartbeat that took longer than the threshold to be delivered. */
+struct EventLoopStall
+{
+    QTime time;
+    QString thread;
+    qint64 duration = 0; // ns
+    int eventType = QEvent::None;
+    QString receiver;
+    Execution::Trace trace;
+};
+
+/** Event loop latency statistics of a single thread. */
+struct EventLoopThreadLatency
+{
+    quintptr threadId = 0;
+    QString thread;
+    qint64 lastLatency = 0; // ns
+    qint64 maxLatency = 0;
+    qint64 totalLatency = 0;
+    int heartbeats = 0;
+    int stalls = 0;
+    bool stalled = false;
+};
+
+/**
+ * Measures event loop latency of all threads that dispatch events.
+ *
+ * A background thread periodically posts heartbeat events to each thread,
+ * the time until they are delivered is the event loop latency. Heartbeats
+ * that are late by more than the threshold are reported as stalls, along with
+ * the event that was last dispatched on that thread when the stall was noticed.
+ */
+class EventLoopWatchdog : public QThread
+{
+    Q_OBJECT
+public:
+    explicit EventLoopWatchdog(QObject *parent = nullptr);
+    ~EventLoopWatchdog() override;
+
+    int threshold() const;
+    void setThreshold(int msecs);
+
+    void stop();
+    void resetStatistics();
+    QVector<EventLoopThreadLatency> threadLatencies() const;
+
+    /// Call from the event notify hook, on the thread dispatching @p event.
+    void eventNotify(QObject *receiver, QEvent *event);
+
+signals:
+    /// Emitted from the stalled thread once its event loop is responsive again.
+    void stallDetected(const GammaRay::EventLoopStall &stall);
+
+protected:
+    void run() override;
+
+private:
+    friend class EventLoopHeartbeat;
+    EventLoopThreadState *registerThread();
+    void heartbeatReceived(EventLoopThreadState *state);
+
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    QVector<QSharedPointer<EventLoopThreadState> > m_threads;
+    qint64 m_threshold; // ns
+    bool m_stop;
+};
+}
+
+Q_DECLARE_METATYPE(GammaRay::EventLoopStall)
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPWATCHDOG_H
@@ -0,0 +1,133 @@
+/*
+  stallmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stallmodel.h"
+
+#include <QMetaEnum>
+
+using namespace GammaRay;
+
+static const int MaximumStalls = 1000;
+
+StallModel::StallModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+StallModel::~StallModel() = default;
+
+Execution::Trace StallModel::stackTrace(int row) const
+{
+    if (row < 0 || row >= m_stalls.size())
+        return Execution::Trace();
+    return m_stalls.at(row).trace;
+}
+
+void StallModel::clear()
+{
+    if (m_stalls.isEmpty())
+        return;
+    beginResetModel();
+    m_stalls.clear();
+    endResetModel();
+}
+
+void StallModel::addStall(const EventLoopStall &stall)
+{
+    if (m_stalls.size() >= MaximumStalls) {
+        // drop an eighth at once rather than shifting the whole history for each new stall
+        const int count = MaximumStalls / 8;
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+        m_stalls.remove(0, count);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_stalls.size(), m_stalls.size());
+    m_stalls.push_back(stall);
+    endInsertRows();
+}
+
+int StallModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_stalls.size();
+}
+
+int StallModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QVariant StallModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const EventLoopStall &stall = m_stalls.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TimeColumn:
+            return stall.time.toString(QStringLiteral("hh:mm:ss.zzz"));
+        case ThreadColumn:
+            return stall.thread;
+        case DurationColumn:
+            return qRound64(stall.duration / 1e4) / 100.0;
+        case EventColumn: {
+            if (stall.eventType == QEvent::None)
+                return tr("unknown");
+            const char *key = QMetaEnum::fromType<QEvent::Type>().valueToKey(stall.eventType);
+            return key ? QString::fromLatin1(key) : QString::number(stall.eventType);
+        }
+        case ReceiverColumn:
+            return stall.receiver;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == EventColumn && stall.trace.empty()) {
+        return tr("No stack trace, the thread did not dispatch any events while it was stalled.");
+    }
+    return QVariant();
+}
+
+QVariant StallModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case TimeColumn:
+            return tr("Time");
+        case ThreadColumn:
+            return tr("Thread");
+        case DurationColumn:
+            return tr("Duration [ms]");
+        case EventColumn:
+            return tr("Event");
+        case ReceiverColumn:
+            return tr("Receiver");
+        }
+    }
+    return QVariant();
+}
@@ -0,0 +1,71 @@
+/*
+  stallmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_STALLMODEL_H
+#define GAMMARAY_EVENTLOOPMONITOR_STALLMODEL_H
+
+#include "eventloopwatchdog.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+namespace GammaRay {
+
+/** Bounded history of event loop stalls. */
+class StallModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        TimeColumn,
+        ThreadColumn,
+        DurationColumn,
+        EventColumn,
+        ReceiverColumn,
+        ColumnCount
+    };
+
+    explicit StallModel(QObject *parent = nullptr);
+    ~StallModel() override;
+
+    Execution::Trace stackTrace(int row) const;
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public slots:
+    void addStall(const GammaRay::EventLoopStall &stall);
+
+private:
+    QVector<EventLoopStall> m_stalls;
+};
+}
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_STALLMODEL_H
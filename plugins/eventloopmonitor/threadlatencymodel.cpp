@@ -0,0 +1,125 @@
+/*
+  threadlatencymodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "threadlatencymodel.h"
+
+#include <QBrush>
+#include <QColor>
+
+using namespace GammaRay;
+
+static QVariant toMSecs(qint64 nsecs)
+{
+    return qRound64(nsecs / 1e4) / 100.0;
+}
+
+ThreadLatencyModel::ThreadLatencyModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+ThreadLatencyModel::~ThreadLatencyModel() = default;
+
+void ThreadLatencyModel::setLatencies(const QVector<EventLoopThreadLatency> &latencies)
+{
+    bool sameThreads = latencies.size() == m_latencies.size();
+    for (int i = 0; sameThreads && i < latencies.size(); ++i)
+        sameThreads = latencies.at(i).threadId == m_latencies.at(i).threadId;
+
+    if (!sameThreads) {
+        beginResetModel();
+        m_latencies = latencies;
+        endResetModel();
+        return;
+    }
+
+    if (m_latencies.isEmpty())
+        return;
+    m_latencies = latencies;
+    emit dataChanged(index(0, 0), index(m_latencies.size() - 1, ColumnCount - 1));
+}
+
+int ThreadLatencyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_latencies.size();
+}
+
+int ThreadLatencyModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QVariant ThreadLatencyModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const EventLoopThreadLatency &latency = m_latencies.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ThreadColumn:
+            return latency.thread;
+        case LatencyColumn:
+            return toMSecs(latency.lastLatency);
+        case MaximumColumn:
+            return toMSecs(latency.maxLatency);
+        case AverageColumn:
+            if (latency.heartbeats == 0)
+                return QVariant();
+            return toMSecs(latency.totalLatency / latency.heartbeats);
+        case StallsColumn:
+            return latency.stalls;
+        }
+    } else if (role == Qt::ForegroundRole && latency.stalled) {
+        return QBrush(Qt::red);
+    } else if (role == Qt::ToolTipRole && latency.stalled) {
+        return tr("This thread is currently not processing events.");
+    }
+    return QVariant();
+}
+
+QVariant ThreadLatencyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ThreadColumn:
+            return tr("Thread");
+        case LatencyColumn:
+            return tr("Latency [ms]");
+        case MaximumColumn:
+            return tr("Maximum [ms]");
+        case AverageColumn:
+            return tr("Average [ms]");
+        case StallsColumn:
+            return tr("Stalls");
+        }
+    }
+    return QVariant();
+}
@@ -33,6 +33,7 @@
 #include <core/util.h>
 #include <core/varianthandler.h>
 
+#include <common/modelevent.h>
 #include <common/objectid.h>
 
 #include <QMetaEnum>
@@ -49,6 +50,7 @@ static const int TopLevelId = std::numeric_limits<int>::max();
 EventModel::EventModel(QObject *parent)
     : QAbstractItemModel(parent)
     , m_pendingEventTimer(new QTimer(this))
+    , m_monitored(false)
 {
     qRegisterMetaType<EventData>();
 
@@ -73,6 +75,18 @@ void EventModel::addEvent(const EventData &event)
     }
 }
 
+void EventModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool monitored = static_cast<ModelEvent *>(event)->used();
+        if (monitored != m_monitored) {
+            m_monitored = monitored;
+            emit monitoredChanged(m_monitored);
+        }
+    }
+    QAbstractItemModel::customEvent(event);
+}
+
 void EventModel::clear()
 {
     beginResetModel();
@@ -81,10 +81,18 @@ public slots:
 
     void clear();
 
+signals:
+    /** Emitted when a client starts or stops looking at the recorded events. */
+    void monitoredChanged(bool monitored);
+
+protected:
+    void customEvent(QEvent *event) override;
+
 private:
     QVector<EventData> m_events;
     QVector<EventData> m_pendingEvents;
     QTimer *m_pendingEventTimer;
+    bool m_monitored;
 };
 }
 
@@ -43,6 +43,7 @@
 
 #include <common/objectbroker.h>
 #include <common/objectmodel.h>
+#include <common/profilingpoint.h>
 
 #include <QItemSelectionModel>
 #include <QMetaMethod>
@@ -288,6 +289,7 @@ void EventMonitor::addEvent(const GammaRay::EventData &event)
 
 static bool eventCallback(void **data)
 {
+    GAMMARAY_PROFILE_SCOPE("Events", "event notify callback");
     QEvent *event = reinterpret_cast<QEvent*>(data[1]);
     QObject *receiver = reinterpret_cast<QObject*>(data[0]);
 
@@ -359,6 +361,8 @@ EventMonitor::EventMonitor(Probe *probe, QObject *parent)
     , m_eventModel(new EventModel(this))
     , m_eventTypeModel(new EventTypeModel(this))
     , m_eventPropertyModel(new AggregatedPropertyModel(this))
+    , m_propagationListener(nullptr)
+    , m_monitored(false)
 {
     Q_ASSERT(s_model == nullptr);
     s_model = m_eventModel;
@@ -369,8 +373,9 @@ EventMonitor::EventMonitor(Probe *probe, QObject *parent)
     Q_ASSERT(s_eventMonitor == nullptr);
     s_eventMonitor = this;
 
-    QInternal::registerCallback(QInternal::EventNotifyCallback, eventCallback);
-    QCoreApplication::instance()->installEventFilter(new EventPropagationListener(this));
+    // event recording is only hooked in while the event model is being looked at
+    m_propagationListener = new EventPropagationListener(this);
+    connect(m_eventModel, &EventModel::monitoredChanged, this, &EventMonitor::setMonitored);
 
     auto filterProxy = new ServerProxyModel<EventTypeFilter>(this);
     filterProxy->setEventTypeModel(m_eventTypeModel);
@@ -400,10 +405,26 @@ void EventMonitor::eventSelected(const QItemSelection &selection)
 }
 
 EventMonitor::~EventMonitor() {
+    setMonitored(false);
     s_model = nullptr;
     s_eventTypeModel = nullptr;
     s_eventMonitor = nullptr;
-    QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventCallback);
+}
+
+void EventMonitor::setMonitored(bool monitored)
+{
+    if (m_monitored == monitored)
+        return;
+    m_monitored = monitored;
+
+    if (m_monitored) {
+        QInternal::registerCallback(QInternal::EventNotifyCallback, eventCallback);
+        QCoreApplication::instance()->installEventFilter(m_propagationListener);
+    } else {
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventCallback);
+        if (QCoreApplication::instance())
+            QCoreApplication::instance()->removeEventFilter(m_propagationListener);
+    }
 }
 
 void EventMonitor::clearHistory()
@@ -78,11 +78,14 @@ public slots:
 
 private slots:
     void eventSelected(const QItemSelection &selection);
+    void setMonitored(bool monitored);
 
 private:
     EventModel *m_eventModel;
     EventTypeModel *m_eventTypeModel;
     AggregatedPropertyModel *m_eventPropertyModel;
+    EventPropagationListener *m_propagationListener;
+    bool m_monitored;
 };
 
 
@@ -31,15 +31,19 @@
 #include <QDebug>
 #include <QFontDatabase>
 #include <QStringList>
+#include <QTimer>
 
+#include <algorithm>
 #include <limits>
 
 using namespace GammaRay;
 
 static const int TopLevelId = std::numeric_limits<int>::max();
+static const int FamilyChunkSize = 256;
 
 FontDatabaseModel::FontDatabaseModel(QObject *parent)
     : QAbstractItemModel(parent)
+    , m_populating(false)
 {
 }
 
@@ -146,27 +150,73 @@ QString FontDatabaseModel::smoothSizeString(const QString &family, const QString
     return sizes.join(QStringLiteral(" "));
 }
 
-void FontDatabaseModel::ensureModelPopulated() const
+bool FontDatabaseModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return rowCount(parent) > 0 || !m_pendingFamilies.isEmpty();
+    if (parent.internalId() != TopLevelId || parent.column() != 0)
+        return false;
+    // assume every family has styles until we know better, that's the common case
+    return !m_stylesFetched.at(parent.row()) || !m_styles.at(parent.row()).isEmpty();
+}
+
+bool FontDatabaseModel::canFetchMore(const QModelIndex &parent) const
 {
-    if (!m_families.isEmpty())
+    // top-level rows are populated in chunks by populateChunk()
+    if (!parent.isValid() || parent.internalId() != TopLevelId || parent.column() != 0)
+        return false;
+    return !m_stylesFetched.at(parent.row());
+}
+
+void FontDatabaseModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    const int family = parent.row();
+    m_stylesFetched[family] = true;
+    QFontDatabase database;
+    const auto styles = database.styles(m_families.at(family));
+    if (styles.isEmpty())
         return;
 
-    const_cast<FontDatabaseModel *>(this)->populateModel();
+    beginInsertRows(parent, 0, styles.size() - 1);
+    m_styles[family].reserve(styles.size());
+    for (const auto &style : styles)
+        m_styles[family].push_back(style);
+    endInsertRows();
 }
 
-void FontDatabaseModel::populateModel()
+void FontDatabaseModel::ensureModelPopulated() const
 {
+    if (m_populating)
+        return;
+
+    auto that = const_cast<FontDatabaseModel *>(this);
+    that->m_populating = true;
     QFontDatabase database;
-    const auto families = database.families();
-    m_families.reserve(families.size());
-    m_styles.resize(families.size());
-    for (int i = 0; i < families.size(); ++i) {
-        const auto &family = families.at(i);
-        m_families.push_back(family);
-
-        const auto styles = database.styles(family);
-        m_styles[i].reserve(styles.size());
-        foreach (const auto &style, database.styles(family))
-            m_styles[i].push_back(style);
-    }
+    that->m_pendingFamilies = database.families();
+    // can't change the row count in here, we are called from rowCount()
+    QTimer::singleShot(0, that, &FontDatabaseModel::populateChunk);
+}
+
+void FontDatabaseModel::populateChunk()
+{
+    if (m_pendingFamilies.isEmpty())
+        return;
+
+    const int count = std::min(FamilyChunkSize, m_pendingFamilies.size());
+    const int first = m_families.size();
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    m_families.reserve(first + count);
+    for (int i = 0; i < count; ++i)
+        m_families.push_back(m_pendingFamilies.at(i));
+    m_styles.resize(first + count);
+    m_stylesFetched.resize(first + count);
+    endInsertRows();
+    m_pendingFamilies.erase(m_pendingFamilies.begin(), m_pendingFamilies.begin() + count);
+
+    // continue in the next event loop iteration, to keep the application responsive
+    if (!m_pendingFamilies.isEmpty())
+        QTimer::singleShot(0, this, &FontDatabaseModel::populateChunk);
 }
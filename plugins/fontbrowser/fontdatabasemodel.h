@@ -31,10 +31,16 @@
 
 #include <QAbstractItemModel>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 namespace GammaRay {
-/** Font families and font styles. */
+/**
+ * Font families and font styles.
+ *
+ * Families are added in chunks from the event loop, styles are fetched
+ * per family on demand via fetchMore().
+ */
 class FontDatabaseModel : public QAbstractItemModel
 {
     Q_OBJECT
@@ -50,15 +56,23 @@ public:
     QModelIndex index(int row, int column,
                       const QModelIndex &parent = QModelIndex()) const override;
     QModelIndex parent(const QModelIndex &child) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private slots:
+    void populateChunk();
 
 private:
     void ensureModelPopulated() const;
-    void populateModel();
 
     QString smoothSizeString(const QString &family, const QString &style) const;
 
     QVector<QString> m_families;
     QVector<QVector<QString> > m_styles;
+    QVector<bool> m_stylesFetched;
+    QStringList m_pendingFamilies;
+    bool m_populating;
 };
 }
 
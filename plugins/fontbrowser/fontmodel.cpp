@@ -32,6 +32,8 @@
 #include <QPixmap>
 #include <QPainter>
 
+#include <algorithm>
+
 using namespace GammaRay;
 
 FontModel::FontModel(QObject *parent)
@@ -40,6 +42,7 @@ FontModel::FontModel(QObject *parent)
     , m_bold(false)
     , m_italic(false)
     , m_underline(false)
+    , m_previewCache(8 * 1024) // in kB
 {
 }
 
@@ -78,6 +81,7 @@ void FontModel::updateText(const QString &text)
     if (text == m_text)
         return;
     m_text = text;
+    m_previewRects.clear();
     fontDataChanged();
 }
 
@@ -116,21 +120,10 @@ QVariant FontModel::data(const QModelIndex &index, int role) const
         if (role == Qt::DisplayRole)
             return m_fonts.at(index.row()).styleName();
     } else if (index.column() == 2) {
-        if (role == Qt::DecorationRole || role == Qt::SizeHintRole) {
-            const QFont &font = m_fonts.at(index.row());
-            QFontMetrics metrics(font);
-            const QString text = m_text.isEmpty() ? tr("<no text>") : m_text;
-            const QRect rect = metrics.boundingRect(text.left(100));
-            if (role == Qt::SizeHintRole)
-                return rect.size();
-            QPixmap pixmap(rect.size());
-            pixmap.fill(m_background);
-            QPainter painter(&pixmap);
-            painter.setPen(m_foreground);
-            painter.setFont(font);
-            painter.drawText(0, -rect.y(), text);
-            return pixmap;
-        }
+        if (role == Qt::SizeHintRole)
+            return previewRect(m_fonts.at(index.row())).size();
+        if (role == Qt::DecorationRole)
+            return preview(m_fonts.at(index.row()));
     }
 
     return QVariant();
@@ -204,5 +197,47 @@ void FontModel::fontDataChanged()
     if (m_fonts.isEmpty())
         return;
 
-    emit dataChanged(index(0, 2), index(rowCount() - 1, 2));
+    emit dataChanged(index(0, 2), index(rowCount() - 1, 2),
+                     QVector<int>() << Qt::DecorationRole << Qt::SizeHintRole);
+}
+
+QString FontModel::previewText() const
+{
+    return m_text.isEmpty() ? tr("<no text>") : m_text;
+}
+
+QRect FontModel::previewRect(const QFont &font) const
+{
+    // only measures the text, so size hints don't need to render anything
+    const auto fontKey = font.key();
+    auto it = m_previewRects.constFind(fontKey);
+    if (it == m_previewRects.constEnd()) {
+        QFontMetrics metrics(font);
+        it = m_previewRects.insert(fontKey, metrics.boundingRect(previewText().left(100)));
+    }
+    return it.value();
+}
+
+QPixmap FontModel::preview(const QFont &font) const
+{
+    PreviewKey key;
+    key.font = font.key();
+    key.text = m_text;
+    key.foreground = m_foreground.rgba();
+    key.background = m_background.rgba();
+    if (auto pixmap = m_previewCache.object(key))
+        return *pixmap;
+
+    const QRect rect = previewRect(font);
+    QPixmap pixmap(rect.size());
+    pixmap.fill(m_background);
+    QPainter painter(&pixmap);
+    painter.setPen(m_foreground);
+    painter.setFont(font);
+    painter.drawText(0, -rect.y(), previewText());
+    painter.end();
+
+    const int cost = std::max(1, rect.width() * rect.height() * 4 / 1024);
+    m_previewCache.insert(key, new QPixmap(pixmap), cost);
+    return pixmap;
 }
@@ -30,8 +30,11 @@
 #define GAMMARAY_FONTBROWSER_FONTMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCache>
 #include <QFont>
 #include <QColor>
+#include <QHash>
+#include <QPixmap>
 #include <QVector>
 
 namespace GammaRay {
@@ -61,7 +64,29 @@ public slots:
     void setColors(const QColor &foreground, const QColor &background);
 
 private:
+    struct PreviewKey
+    {
+        QString font;
+        QString text;
+        QRgb foreground;
+        QRgb background;
+
+        bool operator==(const PreviewKey &other) const
+        {
+            return font == other.font && text == other.text
+                   && foreground == other.foreground && background == other.background;
+        }
+        friend uint qHash(const PreviewKey &key, uint seed = 0)
+        {
+            return ::qHash(key.font, seed) ^ ::qHash(key.text, seed)
+                   ^ ::qHash(key.foreground, seed) ^ ::qHash(key.background << 8, seed);
+        }
+    };
+
     void fontDataChanged();
+    QString previewText() const;
+    QRect previewRect(const QFont &font) const;
+    QPixmap preview(const QFont &font) const;
 
     QVector<QFont> m_fonts;
     QString m_text;
@@ -71,6 +96,10 @@ private:
     bool m_underline;
     QColor m_foreground;
     QColor m_background;
+
+    /// bounding rects of the preview text, by font key, for the current text
+    mutable QHash<QString, QRect> m_previewRects;
+    mutable QCache<PreviewKey, QPixmap> m_previewCache;
 };
 }
 
@@ -33,6 +33,9 @@
 
 #include <QGuiApplication>
 #include <QPalette>
+#include <QTimer>
+
+#include <algorithm>
 
 using namespace GammaRay;
 
@@ -40,16 +43,21 @@ using namespace GammaRay;
  * TODO
  * - show job hierarchy
  * - show all job info messages
- * - show progress information
  * - allow to cancel/suspend if job supports that
- * - track runtime
  * - allow to clear the model
  * - tooltips with additional information (capabilities etc)
  */
 
 KJobModel::KJobModel(QObject *parent)
     : QAbstractTableModel(parent)
+    , m_updateTimer(new QTimer(this))
+    , m_runningCount(0)
+    , m_finishedCount(0)
+    , m_maxFinishedJobs(1000)
 {
+    m_clock.start();
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, &QTimer::timeout, this, &KJobModel::updateRunningJobs);
 }
 
 QVariant KJobModel::data(const QModelIndex &index, int role) const
@@ -60,21 +68,34 @@ QVariant KJobModel::data(const QModelIndex &index, int role) const
     const KJobInfo &job = m_data.at(index.row());
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
-        case 0:
+        case NameColumn:
             return job.name;
-        case 1:
+        case TypeColumn:
             return job.type;
-        case 2:
+        case StatusColumn:
             return job.statusText;
+        case DurationColumn:
+            return duration(job);
+        case ProcessedColumn:
+            if (job.processedBytes)
+                return job.processedBytes;
+            break;
+        case ThroughputColumn:
+        {
+            const auto msecs = duration(job);
+            if (job.processedBytes && msecs > 0)
+                return qRound(double(job.processedBytes) * 10000.0 / 1024.0 / msecs) / 10.0;
+            break;
+        }
         }
     } else if (role == Qt::ForegroundRole) {
         switch (job.state) {
-        case KJobInfo::Finished:
-        case KJobInfo::Deleted:
+        case Finished:
+        case Deleted:
             return qApp->palette().brush(QPalette::Disabled, QPalette::Foreground);
-        case KJobInfo::Error:
+        case Error:
             return QVariant::fromValue<QColor>(Qt::red);
-        case KJobInfo::Killed:
+        case Killed:
             return qApp->palette().link();
         default:
             return QVariant();
@@ -87,7 +108,7 @@ QVariant KJobModel::data(const QModelIndex &index, int role) const
 int KJobModel::columnCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return 3;
+    return ColumnCount;
 }
 
 int KJobModel::rowCount(const QModelIndex &parent) const
@@ -101,17 +122,34 @@ QVariant KJobModel::headerData(int section, Qt::Orientation orientation, int rol
 {
     if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
         switch (section) {
-        case 0:
+        case NameColumn:
             return tr("Job");
-        case 1:
+        case TypeColumn:
             return tr("Type");
-        case 2:
+        case StatusColumn:
             return tr("Status");
+        case DurationColumn:
+            return tr("Duration [ms]");
+        case ProcessedColumn:
+            return tr("Processed [B]");
+        case ThroughputColumn:
+            return tr("Throughput [KiB/s]");
         }
     }
     return QAbstractItemModel::headerData(section, orientation, role);
 }
 
+int KJobModel::maximumFinishedJobs() const
+{
+    return m_maxFinishedJobs;
+}
+
+void KJobModel::setMaximumFinishedJobs(int count)
+{
+    m_maxFinishedJobs = std::max(0, count);
+    evictFinishedJobs();
+}
+
 void KJobModel::objectAdded(QObject *obj)
 {
     KJob *job = qobject_cast<KJob *>(obj);
@@ -124,11 +162,21 @@ void KJobModel::objectAdded(QObject *obj)
     connect(job, &KJob::result, this, &KJobModel::jobResult);
     connect(job, &KJob::finished, this, &KJobModel::jobFinished);
     connect(job, &KJob::infoMessage, this, &KJobModel::jobInfo);
+    connect(job, &KJob::processedAmount, this, &KJobModel::jobProcessedAmount);
     jobInfo.name = obj->objectName().isEmpty() ? Util::addressToString(obj) : obj->objectName();
     jobInfo.type = obj->metaObject()->className();
-    jobInfo.state = KJobInfo::Running;
+    jobInfo.state = Running;
+    // we only see the job once its vtable is complete, that's close enough to its start
+    jobInfo.startTime = m_clock.elapsed();
+    jobInfo.endTime = -1;
+    jobInfo.processedBytes = 0;
+    jobInfo.completed = false;
+    m_rowMap.insert(job, m_data.size());
     m_data.push_back(jobInfo);
     endInsertRows();
+
+    if (m_runningCount++ == 0)
+        m_updateTimer->start();
 }
 
 void KJobModel::objectRemoved(QObject *obj)
@@ -136,16 +184,21 @@ void KJobModel::objectRemoved(QObject *obj)
     const int pos = indexOfJob(obj);
     if (pos < 0)
         return;
+    m_rowMap.remove(obj);
 
+    auto &info = m_data[pos];
+    info.job = nullptr;
     // KJob dtor emits finished, so this shouldn't happen, in theory
     // We however seem to get here for very short-lived jobs that emit before objectAdded()
     // is called (while we wait for the vtable to be complete), so we only see the result
     // of their deleteLater().
-    if (m_data.at(pos).state == KJobInfo::Running) {
-        m_data[pos].state = KJobInfo::Deleted;
-        m_data[pos].statusText = tr("Deleted");
-        emit dataChanged(index(pos, 0), index(pos, columnCount() - 1));
+    if (info.state == Running) {
+        setState(info, Deleted);
+        info.statusText = tr("Deleted");
+        emitRowChanged(pos);
     }
+    complete(info);
+    evictFinishedJobs();
 }
 
 void KJobModel::jobResult(KJob *job)
@@ -154,18 +207,21 @@ void KJobModel::jobResult(KJob *job)
     if (pos < 0)
         return;
 
+    auto &info = m_data[pos];
     if (job->error()) {
-        m_data[pos].state = KJobInfo::Error;
-        m_data[pos].statusText = job->errorString();
+        setState(info, Error);
+        info.statusText = job->errorString();
     } else {
-        if (m_data.at(pos).state == KJobInfo::Killed) {
+        if (info.state == Killed) {
             // we can get finished() before result(), which is perfectly fine
-            m_data[pos].statusText.clear();
+            info.statusText.clear();
         }
-        m_data[pos].state = KJobInfo::Finished;
+        setState(info, Finished);
     }
+    complete(info);
 
-    emit dataChanged(index(pos, 0), index(pos, columnCount()-1));
+    emitRowChanged(pos);
+    evictFinishedJobs();
 }
 
 void KJobModel::jobFinished(KJob *obj)
@@ -174,12 +230,14 @@ void KJobModel::jobFinished(KJob *obj)
     if (pos < 0)
         return;
 
-    if (m_data.at(pos).state == KJobInfo::Running) {
-        m_data[pos].state = KJobInfo::Killed;
-        m_data[pos].statusText = tr("Killed");
+    auto &info = m_data[pos];
+    if (info.state == Running) {
+        setState(info, Killed);
+        info.statusText = tr("Killed");
     }
 
-    emit dataChanged(index(pos, 0), index(pos, columnCount()-1));
+    emitRowChanged(pos);
+    evictFinishedJobs();
 }
 
 void KJobModel::jobInfo(KJob *job, const QString &plainMessage)
@@ -188,17 +246,117 @@ void KJobModel::jobInfo(KJob *job, const QString &plainMessage)
     if (pos < 0)
         return;
 
-    if (m_data.at(pos).state == KJobInfo::Running)
+    if (m_data.at(pos).state == Running)
         m_data[pos].statusText = plainMessage;
 
-    emit dataChanged(index(pos, 0), index(pos, columnCount()-1));
+    emitRowChanged(pos);
+}
+
+void KJobModel::jobProcessedAmount(KJob *job, KJob::Unit unit, qulonglong amount)
+{
+    if (unit != KJob::Bytes)
+        return;
+    const int pos = indexOfJob(job);
+    if (pos < 0)
+        return;
+
+    m_data[pos].processedBytes = amount;
+    emit dataChanged(index(pos, ProcessedColumn), index(pos, ThroughputColumn));
+}
+
+void KJobModel::updateRunningJobs()
+{
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < m_data.size(); ++i) {
+        if (m_data.at(i).state != Running)
+            continue;
+        if (first < 0)
+            first = i;
+        last = i;
+    }
+    if (first >= 0)
+        emit dataChanged(index(first, DurationColumn), index(last, ThroughputColumn));
 }
 
 int KJobModel::indexOfJob(QObject *obj) const
 {
+    return m_rowMap.value(obj, -1);
+}
+
+void KJobModel::emitRowChanged(int row)
+{
+    emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+}
+
+void KJobModel::setState(KJobInfo &info, JobState state)
+{
+    if (info.state == Running && state != Running) {
+        info.endTime = m_clock.elapsed();
+        ++m_finishedCount;
+        if (--m_runningCount == 0)
+            m_updateTimer->stop();
+    }
+    info.state = state;
+}
+
+qint64 KJobModel::duration(const KJobInfo &info) const
+{
+    return (info.endTime >= 0 ? info.endTime : m_clock.elapsed()) - info.startTime;
+}
+
+void KJobModel::complete(KJobInfo &info)
+{
+    if (info.completed)
+        return;
+    info.completed = true;
+    emit jobCompleted(info.type, info.state, duration(info), info.processedBytes);
+}
+
+void KJobModel::evictFinishedJobs()
+{
+    // evict in batches, so the row map doesn't need to be rebuilt for every finished job
+    if (m_finishedCount <= m_maxFinishedJobs + m_maxFinishedJobs / 8)
+        return;
+
+    const int evictCount = m_finishedCount - m_maxFinishedJobs;
+    QVector<int> rows;
+    rows.reserve(evictCount);
+    for (int i = 0; i < m_data.size() && rows.size() < evictCount; ++i) {
+        auto &info = m_data[i];
+        if (info.state == Running)
+            continue;
+        // finished() can arrive before result(), keep the job until its outcome is known
+        if (info.job && !info.completed)
+            continue;
+        if (info.job)
+            disconnect(info.job, nullptr, this, nullptr);
+        complete(info);
+        rows.push_back(i);
+    }
+
+    // remove back to front, in contiguous ranges
+    int last = rows.size() - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && rows.at(first - 1) == rows.at(first) - 1)
+            --first;
+        beginRemoveRows(QModelIndex(), rows.at(first), rows.at(last));
+        m_data.erase(m_data.begin() + rows.at(first), m_data.begin() + rows.at(last) + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    m_finishedCount -= rows.size();
+    rebuildRowMap();
+}
+
+void KJobModel::rebuildRowMap()
+{
+    m_rowMap.clear();
+    m_rowMap.reserve(m_data.size());
     for (int i = 0; i < m_data.size(); ++i) {
-        if (m_data.at(i).job == obj)
-            return i;
+        if (m_data.at(i).job)
+            m_rowMap.insert(m_data.at(i).job, i);
     }
-    return -1;
 }
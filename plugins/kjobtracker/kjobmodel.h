@@ -30,15 +30,39 @@
 #define GAMMARAY_KJOBTRACKER_KJOBMODEL_H
 
 #include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QVector>
 
-class KJob;
+#include <KJob>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
 
 namespace GammaRay {
 class KJobModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
+    enum Column {
+        NameColumn,
+        TypeColumn,
+        StatusColumn,
+        DurationColumn,
+        ProcessedColumn,
+        ThroughputColumn,
+        ColumnCount
+    };
+
+    enum JobState {
+        Running,
+        Finished,
+        Error,
+        Killed,
+        Deleted
+    };
+
     explicit KJobModel(QObject *parent = nullptr);
 
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -50,6 +74,15 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
 
+    /// maximum number of finished jobs to keep, older ones are evicted
+    int maximumFinishedJobs() const;
+    void setMaximumFinishedJobs(int count);
+
+signals:
+    /// emitted once per job when it reached its final state, or when it is evicted
+    void jobCompleted(const QString &type, GammaRay::KJobModel::JobState state,
+                      qint64 msecs, qulonglong bytes);
+
 public slots:
     void objectAdded(QObject *obj);
     void objectRemoved(QObject *obj);
@@ -58,24 +91,37 @@ private slots:
     void jobResult(KJob *job);
     void jobFinished(KJob *obj);
     void jobInfo(KJob *job, const QString &plainMessage);
+    void jobProcessedAmount(KJob *job, KJob::Unit unit, qulonglong amount);
+    void updateRunningJobs();
 
 private:
-    int indexOfJob(QObject *obj) const;
-
     struct KJobInfo {
         KJob *job;
         QString name;
         QString type;
         QString statusText;
-        enum {
-            Running,
-            Finished,
-            Error,
-            Killed,
-            Deleted
-        } state;
+        JobState state;
+        qint64 startTime;
+        qint64 endTime;
+        qulonglong processedBytes;
+        bool completed;
     };
+
+    int indexOfJob(QObject *obj) const;
+    void emitRowChanged(int row);
+    void setState(KJobInfo &info, JobState state);
+    qint64 duration(const KJobInfo &info) const;
+    void complete(KJobInfo &info);
+    void evictFinishedJobs();
+    void rebuildRowMap();
+
     QVector<KJobInfo> m_data;
+    QHash<QObject *, int> m_rowMap;
+    QElapsedTimer m_clock;
+    QTimer *m_updateTimer;
+    int m_runningCount;
+    int m_finishedCount;
+    int m_maxFinishedJobs;
 };
 }
 
@@ -0,0 +1,135 @@
+/*
+  kjobstatisticsmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "kjobstatisticsmodel.h"
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+KJobStatisticsModel::KJobStatisticsModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+KJobStatisticsModel::~KJobStatisticsModel() = default;
+
+int KJobStatisticsModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int KJobStatisticsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_stats.size();
+}
+
+QVariant KJobStatisticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const auto &stats = m_stats.at(index.row());
+    switch (index.column()) {
+    case TypeColumn:
+        return stats.type;
+    case CountColumn:
+        return stats.count;
+    case ErrorColumn:
+        return stats.errors;
+    case KilledColumn:
+        return stats.killed;
+    case MeanDurationColumn:
+        return stats.count ? stats.totalTime / stats.count : 0;
+    case MaxDurationColumn:
+        return stats.maxTime;
+    case ProcessedColumn:
+        return stats.bytes;
+    case ThroughputColumn:
+        if (stats.bytes && stats.byteTime > 0)
+            return qRound(double(stats.bytes) * 10000.0 / 1024.0 / stats.byteTime) / 10.0;
+        break;
+    }
+    return QVariant();
+}
+
+QVariant KJobStatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case TypeColumn:
+            return tr("Type");
+        case CountColumn:
+            return tr("Jobs");
+        case ErrorColumn:
+            return tr("Errors");
+        case KilledColumn:
+            return tr("Killed");
+        case MeanDurationColumn:
+            return tr("Mean [ms]");
+        case MaxDurationColumn:
+            return tr("Max [ms]");
+        case ProcessedColumn:
+            return tr("Processed [B]");
+        case ThroughputColumn:
+            return tr("Throughput [KiB/s]");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void KJobStatisticsModel::jobCompleted(const QString &type, KJobModel::JobState state,
+                                       qint64 msecs, qulonglong bytes)
+{
+    auto it = m_rowMap.constFind(type);
+    if (it == m_rowMap.constEnd()) {
+        beginInsertRows(QModelIndex(), m_stats.size(), m_stats.size());
+        Stats stats;
+        stats.type = type;
+        it = m_rowMap.insert(type, m_stats.size());
+        m_stats.push_back(stats);
+        endInsertRows();
+    }
+
+    const int row = it.value();
+    auto &stats = m_stats[row];
+    ++stats.count;
+    if (state == KJobModel::Error)
+        ++stats.errors;
+    else if (state == KJobModel::Killed || state == KJobModel::Deleted)
+        ++stats.killed;
+    stats.totalTime += msecs;
+    stats.maxTime = std::max(stats.maxTime, msecs);
+    if (bytes) {
+        stats.bytes += bytes;
+        stats.byteTime += msecs;
+    }
+    emit dataChanged(index(row, CountColumn), index(row, ColumnCount - 1));
+}
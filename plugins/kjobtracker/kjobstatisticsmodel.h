@@ -0,0 +1,89 @@
+/*
+  kjobstatisticsmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_KJOBTRACKER_KJOBSTATISTICSMODEL_H
+#define GAMMARAY_KJOBTRACKER_KJOBSTATISTICSMODEL_H
+
+#include "kjobmodel.h"
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+
+namespace GammaRay {
+/**
+ * Aggregated statistics of completed jobs, per job type.
+ *
+ * Unlike KJobModel this is not subject to any retention limit.
+ */
+class KJobStatisticsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        TypeColumn,
+        CountColumn,
+        ErrorColumn,
+        KilledColumn,
+        MeanDurationColumn,
+        MaxDurationColumn,
+        ProcessedColumn,
+        ThroughputColumn,
+        ColumnCount
+    };
+
+    explicit KJobStatisticsModel(QObject *parent = nullptr);
+    ~KJobStatisticsModel() override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+public slots:
+    void jobCompleted(const QString &type, GammaRay::KJobModel::JobState state, qint64 msecs,
+                      qulonglong bytes);
+
+private:
+    struct Stats
+    {
+        QString type;
+        int count = 0;
+        int errors = 0;
+        int killed = 0;
+        qint64 totalTime = 0;
+        qint64 maxTime = 0;
+        qulonglong bytes = 0;
+        qint64 byteTime = 0; // total duration of the jobs that reported processed bytes
+    };
+    QVector<Stats> m_stats;
+    QHash<QString, int> m_rowMap;
+};
+}
+
+#endif // GAMMARAY_KJOBTRACKER_KJOBSTATISTICSMODEL_H
@@ -28,6 +28,7 @@
 
 #include "kjobtracker.h"
 #include "kjobmodel.h"
+#include "kjobstatisticsmodel.h"
 
 #include <QDebug>
 #include <QSortFilterProxyModel>
@@ -38,6 +39,7 @@ using namespace GammaRay;
 KJobTracker::KJobTracker(Probe *probe, QObject *parent)
     : QObject(parent)
     , m_jobModel(new KJobModel(this))
+    , m_statisticsModel(new KJobStatisticsModel(this))
 {
     connect(probe, &Probe::objectCreated, m_jobModel, &KJobModel::objectAdded);
     connect(probe, &Probe::objectDestroyed, m_jobModel, &KJobModel::objectRemoved);
@@ -46,6 +48,12 @@ KJobTracker::KJobTracker(Probe *probe, QObject *parent)
     proxy->setSourceModel(m_jobModel);
 
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.KJobModel"), proxy);
+
+    connect(m_jobModel, &KJobModel::jobCompleted,
+            m_statisticsModel, &KJobStatisticsModel::jobCompleted);
+    auto statisticsProxy = new QSortFilterProxyModel(this);
+    statisticsProxy->setSourceModel(m_statisticsModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.KJobStatisticsModel"), statisticsProxy);
 }
 
 KJobTracker::~KJobTracker() = default;
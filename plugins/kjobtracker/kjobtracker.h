@@ -36,6 +36,7 @@
 class KJob;
 namespace GammaRay {
 class KJobModel;
+class KJobStatisticsModel;
 
 class KJobTracker : public QObject
 {
@@ -46,6 +47,7 @@ public:
 
 private:
     KJobModel *m_jobModel;
+    KJobStatisticsModel *m_statisticsModel;
 };
 
 class KJobTrackerFactory : public QObject, public StandardToolFactory<KJob, KJobTracker>
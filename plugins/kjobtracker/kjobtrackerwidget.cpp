@@ -51,6 +51,11 @@ KJobTrackerWidget::KJobTrackerWidget(QWidget *parent)
     new SearchLineController(ui->searchLine, model);
     ui->jobView->header()->setObjectName("jobViewHeader");
     ui->jobView->setModel(model);
+
+    ui->statisticsView->header()->setObjectName("statisticsViewHeader");
+    ui->statisticsView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.KJobStatisticsModel")));
+
+    m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "75%" << "25%");
 }
 
 KJobTrackerWidget::~KJobTrackerWidget() = default;
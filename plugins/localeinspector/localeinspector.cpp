@@ -55,9 +55,9 @@ LocaleInspector::LocaleInspector(Probe *probe, QObject *parent)
     auto *accessorModel = new LocaleAccessorModel(registry, this);
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.LocaleAccessorModel"), accessorModel);
 
-    auto tzModel = new TimezoneModel(this);
+    m_timezoneModel = new TimezoneModel(this);
     proxy = new ServerProxyModel<QSortFilterProxyModel>(this);
-    proxy->setSourceModel(tzModel);
+    proxy->setSourceModel(m_timezoneModel);
     proxy->addRole(TimezoneModelRoles::LocalZoneRole);
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.TimezoneModel"), proxy);
 
@@ -74,5 +74,5 @@ void LocaleInspector::timezoneSelected(const QItemSelection& selection)
         return;
     auto idx = selection.first().topLeft();
     idx = idx.sibling(idx.row(), 0);
-    m_offsetModel->setTimezone(QTimeZone(idx.data().toString().toUtf8()));
+    m_offsetModel->setTimezone(m_timezoneModel->timezone(idx.data().toByteArray()));
 }
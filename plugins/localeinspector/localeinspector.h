@@ -35,6 +35,7 @@ QT_END_NAMESPACE
 
 namespace GammaRay {
 
+class TimezoneModel;
 class TimezoneOffsetDataModel;
 
 class LocaleInspector : public QObject
@@ -46,6 +47,7 @@ public:
 private:
     void timezoneSelected(const QItemSelection &selection);
 
+    TimezoneModel *m_timezoneModel;
     TimezoneOffsetDataModel *m_offsetModel;
 };
 
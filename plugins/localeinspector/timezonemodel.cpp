@@ -36,6 +36,7 @@ using namespace GammaRay;
 
 TimezoneModel::TimezoneModel(QObject* parent)
     : QAbstractTableModel(parent)
+    , m_zones(32)
 {
 }
 
@@ -51,8 +52,11 @@ int TimezoneModel::rowCount(const QModelIndex& parent) const
 {
     if (parent.isValid())
         return 0;
-    if (m_ids.isEmpty())
+    if (m_ids.isEmpty()) {
         m_ids = QTimeZone::availableTimeZoneIds();
+        m_infos.resize(m_ids.size());
+        m_systemZoneId = QTimeZone::systemTimeZoneId();
+    }
     return m_ids.count();
 }
 
@@ -62,27 +66,52 @@ QVariant TimezoneModel::data(const QModelIndex& index, int role) const
         return QVariant();
 
     if (role == Qt::DisplayRole) {
-        const QTimeZone tz(m_ids.at(index.row()));
+        if (index.column() == TimezoneModelColumns::IanaIdColumn)
+            return m_ids.at(index.row());
+        const auto &info = zoneInfo(index.row());
         switch (index.column()) {
-            case TimezoneModelColumns::IanaIdColumn:
-                return tz.id();
             case TimezoneModelColumns::CountryColumn:
-                return QLocale::countryToString(tz.country());
+                return info.country;
             case TimezoneModelColumns::StandardDisplayNameColumn:
-                return tz.displayName(QTimeZone::StandardTime);
+                return info.displayName;
             case TimezoneModelColumns::DSTColumn:
-                return tz.hasDaylightTime();
+                return info.hasDaylightTime;
             case TimezoneModelColumns::WindowsIdColumn:
-                return QTimeZone::ianaIdToWindowsId(tz.id());
+                return info.windowsId;
         }
     } else if (role == Qt::ToolTipRole && index.column() == 0) {
-        const QTimeZone tz(m_ids.at(index.row()));
-        return tz.comment();
+        return zoneInfo(index.row()).comment;
     } else if (role == TimezoneModelRoles::LocalZoneRole && index.column() == 0) {
-        if (m_ids.at(index.row()) == QTimeZone::systemTimeZoneId())
+        if (m_ids.at(index.row()) == m_systemZoneId)
             return true;
         return QVariant();
     }
 
     return QVariant();
 }
+
+QTimeZone TimezoneModel::timezone(const QByteArray &id) const
+{
+    if (auto tz = m_zones.object(id))
+        return *tz;
+    const QTimeZone tz(id);
+    m_zones.insert(id, new QTimeZone(tz));
+    return tz;
+}
+
+const TimezoneModel::ZoneInfo &TimezoneModel::zoneInfo(int row) const
+{
+    auto &info = m_infos[row];
+    if (info.valid)
+        return info;
+
+    const auto &id = m_ids.at(row);
+    const auto tz = timezone(id);
+    info.country = QLocale::countryToString(tz.country());
+    info.displayName = tz.displayName(QTimeZone::StandardTime);
+    info.comment = tz.comment();
+    info.windowsId = QTimeZone::ianaIdToWindowsId(id);
+    info.hasDaylightTime = tz.hasDaylightTime();
+    info.valid = true;
+    return info;
+}
@@ -31,7 +31,10 @@
 
 #include <QAbstractTableModel>
 #include <QByteArray>
+#include <QCache>
 #include <QList>
+#include <QTimeZone>
+#include <QVector>
 
 namespace GammaRay {
 
@@ -46,8 +49,26 @@ public:
     int rowCount(const QModelIndex & parent) const override;
     QVariant data(const QModelIndex & index, int role) const override;
 
+    /// returns the time zone for @p id, constructing time zones is expensive so they are cached
+    QTimeZone timezone(const QByteArray &id) const;
+
 private:
+    struct ZoneInfo
+    {
+        QString country;
+        QString displayName;
+        QString comment;
+        QByteArray windowsId;
+        bool hasDaylightTime = false;
+        bool valid = false;
+    };
+    const ZoneInfo &zoneInfo(int row) const;
+
     mutable QList<QByteArray> m_ids;
+    /// display data per row, filled on first access
+    mutable QVector<ZoneInfo> m_infos;
+    mutable QCache<QByteArray, QTimeZone> m_zones;
+    mutable QByteArray m_systemZoneId;
 };
 
 }
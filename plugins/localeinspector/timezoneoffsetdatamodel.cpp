@@ -32,8 +32,15 @@
 
 using namespace GammaRay;
 
+static const int MaxTransitions = 30; // in either direction
+static const int WindowSize = 10;
+
 TimezoneOffsetDataModel::TimezoneOffsetDataModel(QObject* parent)
     : QAbstractTableModel(parent)
+    , m_previousCount(0)
+    , m_nextCount(0)
+    , m_previousDone(true)
+    , m_nextDone(true)
 {
 }
 
@@ -41,36 +48,69 @@ TimezoneOffsetDataModel::~TimezoneOffsetDataModel() = default;
 
 void TimezoneOffsetDataModel::setTimezone(const QTimeZone& tz)
 {
-    if (!m_offsets.isEmpty()) {
-        beginRemoveRows(QModelIndex(), 0, m_offsets.size() - 1);
-        m_offsets.clear();
-        endRemoveRows();
-    }
-
-    QVector<QTimeZone::OffsetData> offsets;
-    offsets.reserve(60);
+    beginResetModel();
+    m_timezone = tz;
+    m_start = QDateTime::currentDateTime();
+    m_offsets.clear();
+    m_previousCount = 0;
+    m_nextCount = 0;
+    m_previousDone = !tz.isValid() || !tz.hasTransitions();
+    m_nextDone = m_previousDone;
+    endResetModel();
+}
 
-    const auto start = QDateTime::currentDateTime();
+bool TimezoneOffsetDataModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return false;
+    return !m_previousDone || !m_nextDone;
+}
 
-    auto offset = tz.offsetData(start);
-    for (int i = 0; i < 30; ++i) {
-        offset = tz.previousTransition(offset.atUtc);
-        if (!offset.atUtc.isValid())
-            break;
-        offsets.prepend(offset);
+void TimezoneOffsetDataModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    // extend the window around the current time in both directions
+    QVector<QTimeZone::OffsetData> previous;
+    if (!m_previousDone) {
+        auto offset = m_previousCount == 0 ? m_timezone.offsetData(m_start) : m_offsets.first();
+        while (previous.size() < WindowSize && m_previousCount < MaxTransitions) {
+            offset = m_timezone.previousTransition(offset.atUtc);
+            if (!offset.atUtc.isValid()) {
+                m_previousDone = true;
+                break;
+            }
+            previous.prepend(offset);
+            ++m_previousCount;
+        }
+        if (m_previousCount >= MaxTransitions)
+            m_previousDone = true;
     }
-
-    offset = tz.offsetData(start);
-    for (int i = 0; i < 30; ++i) {
-        offset = tz.nextTransition(offset.atUtc);
-        if (!offset.atUtc.isValid())
-            break;
-        offsets.push_back(offset);
+    if (!previous.isEmpty()) {
+        beginInsertRows(QModelIndex(), 0, previous.size() - 1);
+        m_offsets = previous + m_offsets;
+        endInsertRows();
     }
 
-    if (!offsets.isEmpty()) {
-        beginInsertRows(QModelIndex(), 0, offsets.size() - 1);
-        m_offsets = offsets;
+    QVector<QTimeZone::OffsetData> next;
+    if (!m_nextDone) {
+        auto offset = m_nextCount == 0 ? m_timezone.offsetData(m_start) : m_offsets.last();
+        while (next.size() < WindowSize && m_nextCount < MaxTransitions) {
+            offset = m_timezone.nextTransition(offset.atUtc);
+            if (!offset.atUtc.isValid()) {
+                m_nextDone = true;
+                break;
+            }
+            next.push_back(offset);
+            ++m_nextCount;
+        }
+        if (m_nextCount >= MaxTransitions)
+            m_nextDone = true;
+    }
+    if (!next.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_offsets.size(), m_offsets.size() + next.size() - 1);
+        m_offsets += next;
         endInsertRows();
     }
 }
@@ -94,7 +134,7 @@ QVariant TimezoneOffsetDataModel::data(const QModelIndex& index, int role) const
         return QVariant();
 
     if (role == Qt::DisplayRole) {
-        const auto offset = m_offsets.at(index.row());
+        const auto &offset = m_offsets.at(index.row());
         switch (index.column()) {
             case 0:
                 return offset.atUtc;
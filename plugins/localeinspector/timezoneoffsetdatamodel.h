@@ -41,14 +41,23 @@ public:
     explicit TimezoneOffsetDataModel(QObject *parent = nullptr);
     ~TimezoneOffsetDataModel() override;
 
+    /// transitions are only computed once requested, see fetchMore()
     void setTimezone(const QTimeZone &tz);
 
     int columnCount(const QModelIndex & parent) const override;
     int rowCount(const QModelIndex & parent) const override;
     QVariant data(const QModelIndex & index, int role) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 private:
+    QTimeZone m_timezone;
+    QDateTime m_start;
     QVector<QTimeZone::OffsetData> m_offsets;
+    int m_previousCount;
+    int m_nextCount;
+    bool m_previousDone;
+    bool m_nextDone;
 };
 
 }
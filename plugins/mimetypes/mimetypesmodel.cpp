@@ -28,156 +28,213 @@
 
 #include "mimetypesmodel.h"
 
-#include <QDebug>
-#include <QMimeType>
+#include <compat/qasconst.h>
 
 using namespace GammaRay;
 
 MimeTypesModel::MimeTypesModel(QObject *parent)
-    : QStandardItemModel(parent)
-    , m_modelFilled(false)
+    : QAbstractItemModel(parent)
+    , m_indexBuilt(false)
 {
 }
 
 MimeTypesModel::~MimeTypesModel() = default;
 
-QVariant MimeTypesModel::data(const QModelIndex &index, int role) const
+int MimeTypesModel::columnCount(const QModelIndex &parent) const
 {
-    if (index.isValid() && role == Qt::DecorationRole && index.column() == 3) {
-        QStandardItem *item = itemFromIndex(index);
-        if (!item)
-            return QVariant();
-
-        // on-demand lookup of icons, too slow to do that all in one go
-        const QVariant v = item->data(Qt::DecorationRole);
-        if (v.isNull()) {
-            const QString iconName = item->data(IconNameRole).toString();
-            const QString genericIconName = item->data(GenericIconNameRole).toString();
-            if (iconName.isEmpty() && genericIconName.isEmpty())
-                return QVariant();
-
-            QIcon icon = QIcon::fromTheme(item->data(IconNameRole).toString());
-            if (icon.isNull())
-                icon = QIcon::fromTheme(item->data(GenericIconNameRole).toString());
-            const_cast<MimeTypesModel *>(this)->blockSignals(true);
-            item->setIcon(icon);
-            item->setData(QVariant(), IconNameRole); // reset to avoid trying to look up an icon multiple times
-            item->setData(QVariant(), GenericIconNameRole);
-            const_cast<MimeTypesModel *>(this)->blockSignals(false);
-            return icon;
-        } else {
-            return v;
-        }
-    }
-    return QStandardItemModel::data(index, role);
+    Q_UNUSED(parent);
+    return 6;
 }
 
-Qt::ItemFlags MimeTypesModel::flags(const QModelIndex &index) const
+int MimeTypesModel::rowCount(const QModelIndex &parent) const
 {
-    return QStandardItemModel::flags(index) & ~Qt::ItemIsEditable;
+    const_cast<MimeTypesModel *>(this)->buildIndex();
+    if (!parent.isValid())
+        return m_rootNodes.size();
+    if (parent.column() > 0)
+        return 0;
+    // no need to create the child nodes just for counting them
+    return m_types.at(m_nodes.at(parent.internalId()).type).children.size();
 }
 
-int MimeTypesModel::rowCount(const QModelIndex &parent) const
+bool MimeTypesModel::hasChildren(const QModelIndex &parent) const
+{
+    return rowCount(parent) > 0;
+}
+
+QModelIndex MimeTypesModel::index(int row, int column, const QModelIndex &parent) const
 {
-    const_cast<MimeTypesModel *>(this)->fillModel();
-    return QStandardItemModel::rowCount(parent);
+    if (row < 0 || column < 0 || column >= columnCount() || parent.column() > 0)
+        return QModelIndex();
+
+    auto self = const_cast<MimeTypesModel *>(this);
+    self->buildIndex();
+    const QVector<int> children = self->childNodes(parent.isValid() ? int(parent.internalId()) : -1);
+    if (row >= children.size())
+        return QModelIndex();
+    return createIndex(row, column, quintptr(children.at(row)));
 }
 
-QVector<QStandardItem *> MimeTypesModel::itemsForType(const QString &mimeTypeName)
+QModelIndex MimeTypesModel::parent(const QModelIndex &child) const
 {
-    if (m_mimeTypeNodes.contains(mimeTypeName))
-        return m_mimeTypeNodes.value(mimeTypeName);
+    if (!child.isValid())
+        return QModelIndex();
 
-    makeItemsForType(mimeTypeName);
-    return m_mimeTypeNodes.value(mimeTypeName);
+    const int parentNode = m_nodes.at(child.internalId()).parent;
+    if (parentNode < 0)
+        return QModelIndex();
+    return createIndex(m_nodes.at(parentNode).row, 0, quintptr(parentNode));
 }
 
-void MimeTypesModel::makeItemsForType(const QString &mimeTypeName)
+QVariant MimeTypesModel::data(const QModelIndex &index, int role) const
 {
-    const QMimeType mt = m_db.mimeTypeForName(mimeTypeName);
+    if (!index.isValid())
+        return QVariant();
+
+    const QMimeType &mt = m_types.at(m_nodes.at(index.internalId()).type).mimeType;
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case 0:
+            return mt.name();
+        case 1:
+            return mt.comment();
+        case 2:
+            return mt.globPatterns().join(QStringLiteral(", "));
+        case 3:
+            return QString(mt.iconName() + QLatin1String(" / ") + mt.genericIconName());
+        case 4: {
+            QString s = mt.suffixes().join(QStringLiteral(", "));
+            if (!mt.preferredSuffix().isEmpty() && mt.suffixes().size() > 1)
+                s += QLatin1String(" (") + mt.preferredSuffix() + QLatin1Char(')');
+            return s;
+        }
+        case 5:
+            return mt.aliases().join(QStringLiteral(", "));
+        }
+    } else if (role == Qt::DecorationRole && index.column() == 3) {
+        return icon(index.internalId());
+    }
+    return QVariant();
+}
 
-    if (mt.parentMimeTypes().isEmpty()) {
-        const QList<QStandardItem *> row = makeRowForType(mt);
-        appendRow(row);
-        m_mimeTypeNodes[mt.name()].push_back(row.first());
-    } else {
-        // parentMimeTypes contains duplicates and aliases
-        const QSet<QString> parentMimeTypeNames = normalizedMimeTypeNames(mt.parentMimeTypes());
-        for (const QString &parentTypeName : parentMimeTypeNames) {
-            foreach (QStandardItem *parentItem, itemsForType(parentTypeName)) {
-                const QList<QStandardItem *> row = makeRowForType(mt);
-                parentItem->appendRow(row);
-                m_mimeTypeNodes[mt.name()].push_back(row.first());
-            }
+QVariant MimeTypesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case 0:
+            return tr("Name");
+        case 1:
+            return tr("Comment");
+        case 2:
+            return tr("Glob Patterns");
+        case 3:
+            return tr("Icons");
+        case 4:
+            return tr("Suffixes");
+        case 5:
+            return tr("Aliases");
         }
     }
+    return QVariant();
 }
 
-QSet< QString > MimeTypesModel::normalizedMimeTypeNames(const QStringList &typeNames) const
+void MimeTypesModel::buildIndex()
 {
-    QSet<QString> res;
-    for (const QString &typeName : typeNames) {
-        const QMimeType mt = m_db.mimeTypeForName(typeName);
-        res.insert(mt.name());
+    if (m_indexBuilt)
+        return;
+    m_indexBuilt = true;
+
+    const QList<QMimeType> mimeTypes = m_db.allMimeTypes();
+    QHash<QString, int> typeIds;
+    typeIds.reserve(mimeTypes.size());
+    m_types.reserve(mimeTypes.size());
+    for (const QMimeType &mt : mimeTypes) {
+        typeIds.insert(mt.name(), m_types.size());
+        m_types.push_back({ mt, QVector<int>() });
     }
 
-    return res;
+    for (int i = 0; i < m_types.size(); ++i) {
+        // parentMimeTypes contains duplicates and aliases
+        QVector<int> parents;
+        foreach (const QString &parentName, m_types.at(i).mimeType.parentMimeTypes()) {
+            int parent = typeIds.value(parentName, -1);
+            if (parent < 0)
+                parent = typeIds.value(m_db.mimeTypeForName(parentName).name(), -1);
+            if (parent < 0 || parent == i || parents.contains(parent))
+                continue;
+            parents.push_back(parent);
+        }
+
+        if (parents.isEmpty())
+            m_rootNodes.push_back(createNode(i, -1, m_rootNodes.size()));
+        for (int parent : qAsConst(parents))
+            m_types[parent].children.push_back(i);
+    }
 }
 
-QList<QStandardItem *> MimeTypesModel::makeRowForType(const QMimeType &mt)
+int MimeTypesModel::createNode(int type, int parent, int row)
 {
-    QList<QStandardItem *> row;
-    auto *item = new QStandardItem;
-    item->setText(mt.name());
-    row.push_back(item);
-
-    item = new QStandardItem;
-    item->setText(mt.comment());
-    row.push_back(item);
-
-    item = new QStandardItem;
-    item->setText(mt.globPatterns().join(QStringLiteral(", ")));
-    row.push_back(item);
-
-    item = new QStandardItem;
-    item->setText(mt.iconName() + QLatin1String(" / ") + mt.genericIconName());
-    item->setData(mt.iconName(), IconNameRole);
-    item->setData(mt.genericIconName(), GenericIconNameRole);
-    row.push_back(item);
-
-    item = new QStandardItem;
-    QString s = mt.suffixes().join(QStringLiteral(", "));
-    if (!mt.preferredSuffix().isEmpty() && mt.suffixes().size() > 1)
-        s += QLatin1String(" (") + mt.preferredSuffix() + QLatin1Char(')');
-    item->setText(s);
-    row.push_back(item);
-
-    item = new QStandardItem;
-    item->setText(mt.aliases().join(QStringLiteral(", ")));
-    row.push_back(item);
-
-    return row;
+    m_nodes.push_back({ type, parent, row, false, QVector<int>() });
+    return m_nodes.size() - 1;
 }
 
-void MimeTypesModel::fillModel()
+QVector<int> MimeTypesModel::childNodes(int node)
 {
-    if (m_modelFilled)
-        return;
-    m_modelFilled = true;
-
-    blockSignals(true);
-    setHorizontalHeaderLabels(QStringList() << tr("Name")
-                                            << tr("Comment")
-                                            << tr("Glob Patterns")
-                                            << tr("Icons")
-                                            << tr("Suffixes")
-                                            << tr("Aliases"));
-
-    foreach (const QMimeType &mt, m_db.allMimeTypes()) {
-        if (!m_mimeTypeNodes.contains(mt.name()))
-            makeItemsForType(mt.name());
+    if (node < 0)
+        return m_rootNodes;
+
+    if (!m_nodes.at(node).populated) {
+        // copy, createNode() can reallocate m_nodes
+        const QVector<int> types = m_types.at(m_nodes.at(node).type).children;
+        QVector<int> children;
+        children.reserve(types.size());
+        for (int row = 0; row < types.size(); ++row)
+            children.push_back(createNode(types.at(row), node, row));
+        m_nodes[node].children = children;
+        m_nodes[node].populated = true;
     }
+    return m_nodes.at(node).children;
+}
+
+QString MimeTypesModel::iconKey(const QMimeType &mt)
+{
+    return mt.iconName() + QLatin1Char('\n') + mt.genericIconName();
+}
 
-    m_mimeTypeNodes.clear();
-    blockSignals(false);
+QVariant MimeTypesModel::icon(int node) const
+{
+    const QMimeType &mt = m_types.at(m_nodes.at(node).type).mimeType;
+    if (mt.iconName().isEmpty() && mt.genericIconName().isEmpty())
+        return QVariant();
+
+    const auto it = m_icons.constFind(iconKey(mt));
+    if (it != m_icons.constEnd())
+        return it.value();
+
+    // theme lookups are slow, collect the requests and resolve them in one go
+    auto self = const_cast<MimeTypesModel *>(this);
+    if (m_pendingIconNodes.isEmpty())
+        QMetaObject::invokeMethod(self, "lookupIcons", Qt::QueuedConnection);
+    self->m_pendingIconNodes.insert(node);
+    return QVariant();
+}
+
+void MimeTypesModel::lookupIcons()
+{
+    const QSet<int> nodes = m_pendingIconNodes;
+    m_pendingIconNodes.clear();
+
+    for (int node : nodes) {
+        const QMimeType &mt = m_types.at(m_nodes.at(node).type).mimeType;
+        const QString key = iconKey(mt);
+        if (!m_icons.contains(key)) {
+            QIcon icon = QIcon::fromTheme(mt.iconName());
+            if (icon.isNull())
+                icon = QIcon::fromTheme(mt.genericIconName());
+            m_icons.insert(key, icon);
+        }
+
+        const QModelIndex idx = createIndex(m_nodes.at(node).row, 3, quintptr(node));
+        emit dataChanged(idx, idx, QVector<int>() << Qt::DecorationRole);
+    }
 }
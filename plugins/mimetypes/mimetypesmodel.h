@@ -29,38 +29,67 @@
 #ifndef GAMMARAY_MIMETYPES_MIMETYPESMODEL_H
 #define GAMMARAY_MIMETYPES_MIMETYPESMODEL_H
 
-#include "common/modelroles.h"
-
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
 #include <QMimeDatabase>
-#include <QStandardItemModel>
+#include <QMimeType>
+#include <QSet>
+#include <QVector>
 
 namespace GammaRay {
-class MimeTypesModel : public QStandardItemModel
+/**
+ * The MIME type hierarchy.
+ *
+ * The parent/child relations are resolved once into an index of the MIME
+ * database, tree nodes are only created when they are first accessed. Types
+ * with several parent types appear once under each of them.
+ */
+class MimeTypesModel : public QAbstractItemModel
 {
     Q_OBJECT
 public:
-    enum Roles {
-        IconNameRole = UserRole + 1,
-        GenericIconNameRole
-    };
-
     explicit MimeTypesModel(QObject *parent = nullptr);
     ~MimeTypesModel() override;
 
-    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
-    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void lookupIcons();
 
 private:
-    void fillModel();
-    QVector<QStandardItem *> itemsForType(const QString &mimeTypeName);
-    void makeItemsForType(const QString &mimeTypeName);
-    static QList<QStandardItem *> makeRowForType(const QMimeType &mt);
-    QSet<QString> normalizedMimeTypeNames(const QStringList &typeNames) const;
+    struct MimeTypeInfo {
+        QMimeType mimeType;
+        QVector<int> children; // indexes into m_types
+    };
+
+    struct Node {
+        int type; // index into m_types
+        int parent; // index into m_nodes, -1 for top-level nodes
+        int row;
+        bool populated;
+        QVector<int> children; // indexes into m_nodes
+    };
+
+    void buildIndex();
+    int createNode(int type, int parent, int row);
+    QVector<int> childNodes(int node);
+    QVariant icon(int node) const;
+    static QString iconKey(const QMimeType &mt);
 
-    QHash<QString, QVector<QStandardItem *> > m_mimeTypeNodes;
     QMimeDatabase m_db;
-    bool m_modelFilled;
+    QVector<MimeTypeInfo> m_types;
+    QVector<Node> m_nodes;
+    QVector<int> m_rootNodes;
+    QHash<QString, QIcon> m_icons;
+    QSet<int> m_pendingIconNodes;
+    bool m_indexBuilt;
 };
 }
 
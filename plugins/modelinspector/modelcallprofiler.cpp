@@ -0,0 +1,642 @@
+/*
+  modelcallprofiler.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "modelcallprofiler.h"
+#include "modelcellmodel.h"
+
+#include <core/probeguard.h>
+#include <core/problemcollector.h>
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <QTimer>
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(Q_OS_LINUX) && defined(Q_PROCESSOR_X86) && !defined(Q_CC_MSVC)
+#define GAMMARAY_MODEL_CALL_INTERCEPTION
+#endif
+
+#ifdef GAMMARAY_MODEL_CALL_INTERCEPTION
+#include <QFile>
+
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace GammaRay;
+
+#ifdef GAMMARAY_MODEL_CALL_INTERCEPTION
+namespace {
+// the original entries of a vtable we patched, calls through the hooks might still be running
+// in other threads at any time, so these are never modified or freed once published
+struct PatchedVTable
+{
+    void **vtable;
+    void *originals[ModelCallProfiler::CallTypeCount];
+    PatchedVTable *next;
+};
+
+// there is only one profiler, intercepting calls for one model at a time
+struct Interception
+{
+    QAtomicPointer<const QAbstractItemModel> model;
+    QAtomicPointer<ModelCallProfiler> profiler;
+    QAtomicPointer<PatchedVTable> patchedVTables;
+    PatchedVTable *current;
+    int vtableSlots[ModelCallProfiler::CallTypeCount];
+    void *hooks[ModelCallProfiler::CallTypeCount];
+};
+static Interception s_interception;
+
+static const PatchedVTable *patchedVTable(void **vtable)
+{
+    auto patched = s_interception.patchedVTables.loadAcquire();
+    while (patched && patched->vtable != vtable)
+        patched = patched->next;
+    return patched;
+}
+
+// looked up by the vtable the call went through, rather than the currently profiled model
+template<typename Func>
+static Func original(const QAbstractItemModel *model, ModelCallProfiler::CallType type)
+{
+    const auto patched = patchedVTable(*reinterpret_cast<void **const *>(model));
+    Q_ASSERT(patched);
+    Func func;
+    memcpy(&func, &patched->originals[type], sizeof(func));
+    return func;
+}
+
+class CallTimer
+{
+public:
+    CallTimer(const QAbstractItemModel *model, ModelCallProfiler::CallType type, int role = -1)
+        : m_profiler(model == s_interception.model.load() ? s_interception.profiler.load() : nullptr)
+        , m_type(type)
+        , m_role(role)
+    {
+        // skip our own traffic, e.g. the model content view or the cell inspector
+        if (m_profiler && ProbeGuard::insideProbe())
+            m_profiler = nullptr;
+        if (m_profiler)
+            m_timer.start();
+    }
+    ~CallTimer()
+    {
+        if (m_profiler)
+            m_profiler->recordCall(m_type, m_role, m_timer.nsecsElapsed());
+    }
+
+private:
+    Q_DISABLE_COPY(CallTimer)
+    ModelCallProfiler *m_profiler;
+    ModelCallProfiler::CallType m_type;
+    int m_role;
+    QElapsedTimer m_timer;
+};
+
+// With the Itanium C++ ABI, a member function takes this as its first argument (after the
+// return value pointer, if any), so these can stand in for the corresponding vtable entries.
+static QVariant hookedData(const QAbstractItemModel *model, const QModelIndex &index, int role)
+{
+    CallTimer timer(model, ModelCallProfiler::DataCall, role);
+    return original<QVariant (*)(const QAbstractItemModel *, const QModelIndex &, int)>(
+        model, ModelCallProfiler::DataCall)(model, index, role);
+}
+
+static int hookedRowCount(const QAbstractItemModel *model, const QModelIndex &parent)
+{
+    CallTimer timer(model, ModelCallProfiler::RowCountCall);
+    return original<int (*)(const QAbstractItemModel *, const QModelIndex &)>(
+        model, ModelCallProfiler::RowCountCall)(model, parent);
+}
+
+static QModelIndex hookedIndex(const QAbstractItemModel *model, int row, int column, const QModelIndex &parent)
+{
+    CallTimer timer(model, ModelCallProfiler::IndexCall);
+    return original<QModelIndex (*)(const QAbstractItemModel *, int, int, const QModelIndex &)>(
+        model, ModelCallProfiler::IndexCall)(model, row, column, parent);
+}
+
+static QModelIndex hookedParent(const QAbstractItemModel *model, const QModelIndex &child)
+{
+    CallTimer timer(model, ModelCallProfiler::ParentCall);
+    return original<QModelIndex (*)(const QAbstractItemModel *, const QModelIndex &)>(
+        model, ModelCallProfiler::ParentCall)(model, child);
+}
+
+static void hookedFetchMore(QAbstractItemModel *model, const QModelIndex &parent)
+{
+    CallTimer timer(model, ModelCallProfiler::FetchMoreCall);
+    original<void (*)(QAbstractItemModel *, const QModelIndex &)>(
+        model, ModelCallProfiler::FetchMoreCall)(model, parent);
+}
+
+static bool hookedCanFetchMore(const QAbstractItemModel *model, const QModelIndex &parent)
+{
+    CallTimer timer(model, ModelCallProfiler::CanFetchMoreCall);
+    return original<bool (*)(const QAbstractItemModel *, const QModelIndex &)>(
+        model, ModelCallProfiler::CanFetchMoreCall)(model, parent);
+}
+
+static void hookedSort(QAbstractItemModel *model, int column, Qt::SortOrder order)
+{
+    CallTimer timer(model, ModelCallProfiler::SortCall);
+    original<void (*)(QAbstractItemModel *, int, Qt::SortOrder)>(
+        model, ModelCallProfiler::SortCall)(model, column, order);
+}
+
+template<typename Func>
+static void *toVoidPointer(Func func)
+{
+    void *ptr;
+    static_assert(sizeof(func) == sizeof(ptr), "unexpected function pointer size");
+    memcpy(&ptr, &func, sizeof(ptr));
+    return ptr;
+}
+
+// Itanium C++ ABI: a pointer to a virtual member function holds 1 + the vtable offset in bytes
+template<typename Method>
+static int vtableSlot(Method method)
+{
+    quintptr pmf[2];
+    static_assert(sizeof(method) == sizeof(pmf), "unexpected member function pointer layout");
+    memcpy(pmf, &method, sizeof(pmf));
+    if (!(pmf[0] & 1))
+        return -1;
+    return int((pmf[0] - 1) / sizeof(void *));
+}
+
+static void initHooks()
+{
+    auto &i = s_interception;
+    i.vtableSlots[ModelCallProfiler::DataCall] = vtableSlot(&QAbstractItemModel::data);
+    i.hooks[ModelCallProfiler::DataCall] = toVoidPointer(&hookedData);
+    i.vtableSlots[ModelCallProfiler::RowCountCall] = vtableSlot(&QAbstractItemModel::rowCount);
+    i.hooks[ModelCallProfiler::RowCountCall] = toVoidPointer(&hookedRowCount);
+    i.vtableSlots[ModelCallProfiler::IndexCall] = vtableSlot(&QAbstractItemModel::index);
+    i.hooks[ModelCallProfiler::IndexCall] = toVoidPointer(&hookedIndex);
+    i.vtableSlots[ModelCallProfiler::ParentCall] = vtableSlot(
+        static_cast<QModelIndex (QAbstractItemModel::*)(const QModelIndex &) const>(&QAbstractItemModel::parent));
+    i.hooks[ModelCallProfiler::ParentCall] = toVoidPointer(&hookedParent);
+    i.vtableSlots[ModelCallProfiler::FetchMoreCall] = vtableSlot(&QAbstractItemModel::fetchMore);
+    i.hooks[ModelCallProfiler::FetchMoreCall] = toVoidPointer(&hookedFetchMore);
+    i.vtableSlots[ModelCallProfiler::CanFetchMoreCall] = vtableSlot(&QAbstractItemModel::canFetchMore);
+    i.hooks[ModelCallProfiler::CanFetchMoreCall] = toVoidPointer(&hookedCanFetchMore);
+    i.vtableSlots[ModelCallProfiler::SortCall] = vtableSlot(&QAbstractItemModel::sort);
+    i.hooks[ModelCallProfiler::SortCall] = toVoidPointer(&hookedSort);
+}
+
+// PROT_* flags of the mapping containing @p address, -1 if not found
+static int mappingProtection(const void *address)
+{
+    QFile maps(QStringLiteral("/proc/self/maps"));
+    if (!maps.open(QIODevice::ReadOnly))
+        return -1;
+    const auto addr = reinterpret_cast<quintptr>(address);
+    // procfs reports a size of 0, so we can't rely on atEnd() here
+    const auto lines = maps.readAll().split('\n');
+    for (const auto &line : lines) {
+        // begin-end perms offset dev inode path
+        const int dash = line.indexOf('-');
+        const int space = line.indexOf(' ');
+        if (dash <= 0 || space <= dash || line.size() < space + 4)
+            continue;
+        bool beginOk = false, endOk = false;
+        const auto begin = line.left(dash).toULongLong(&beginOk, 16);
+        const auto end = line.mid(dash + 1, space - dash - 1).toULongLong(&endOk, 16);
+        if (!beginOk || !endOk || addr < begin || addr >= end)
+            continue;
+        int prot = PROT_NONE;
+        if (line.at(space + 1) == 'r')
+            prot |= PROT_READ;
+        if (line.at(space + 2) == 'w')
+            prot |= PROT_WRITE;
+        if (line.at(space + 3) == 'x')
+            prot |= PROT_EXEC;
+        return prot;
+    }
+    return -1;
+}
+
+// vtables usually end up in relocation read-only memory, restore that afterwards
+static bool writeVTableEntry(void **entry, void *value)
+{
+    const int prot = mappingProtection(entry);
+    if (prot < 0 || !(prot & PROT_READ))
+        return false;
+    if (prot & PROT_WRITE) {
+        *entry = value;
+        return true;
+    }
+
+    const auto pageSize = quintptr(sysconf(_SC_PAGESIZE));
+    void *page = reinterpret_cast<void *>(reinterpret_cast<quintptr>(entry) & ~(pageSize - 1));
+    if (mprotect(page, pageSize, prot | PROT_WRITE) != 0)
+        return false;
+    *entry = value;
+    mprotect(page, pageSize, prot);
+    return true;
+}
+
+static void uninstallHooks()
+{
+    auto &i = s_interception;
+    if (!i.current)
+        return;
+
+    i.model = nullptr;
+    i.profiler = nullptr;
+    for (int type = 0; type < ModelCallProfiler::CallTypeCount; ++type) {
+        void **entry = i.current->vtable + i.vtableSlots[type];
+        if (*entry == i.hooks[type])
+            writeVTableEntry(entry, i.current->originals[type]);
+    }
+    i.current = nullptr;
+}
+
+static bool installHooks(const QAbstractItemModel *model, ModelCallProfiler *profiler)
+{
+    auto &i = s_interception;
+    Q_ASSERT(!i.current);
+    if (!i.hooks[0])
+        initHooks();
+    for (int type = 0; type < ModelCallProfiler::CallTypeCount; ++type) {
+        if (i.vtableSlots[type] < 0)
+            return false;
+    }
+
+    // patches the vtable of the model's class, calls to other instances are just forwarded
+    void **vtable = *reinterpret_cast<void **const *>(model);
+    auto patched = const_cast<PatchedVTable *>(patchedVTable(vtable));
+    if (!patched) {
+        for (int type = 0; type < ModelCallProfiler::CallTypeCount; ++type) {
+            if (vtable[i.vtableSlots[type]] == i.hooks[type])
+                return false; // shouldn't happen, but would make us call ourselves
+        }
+        patched = new PatchedVTable;
+        patched->vtable = vtable;
+        for (int type = 0; type < ModelCallProfiler::CallTypeCount; ++type)
+            patched->originals[type] = vtable[i.vtableSlots[type]];
+        patched->next = i.patchedVTables.load();
+        i.patchedVTables.storeRelease(patched);
+    }
+    i.current = patched;
+    i.profiler = profiler;
+    i.model = model;
+
+    for (int type = 0; type < ModelCallProfiler::CallTypeCount; ++type) {
+        if (!writeVTableEntry(vtable + i.vtableSlots[type], i.hooks[type])) {
+            uninstallHooks();
+            return false;
+        }
+    }
+    return true;
+}
+}
+#endif
+
+void ModelCallProfiler::Stats::add(qint64 time, qint64 span)
+{
+    ++count;
+    if (time >= 0) {
+        totalTime += time;
+        maxTime = std::max(maxTime, time);
+    }
+    if (span >= 0) {
+        totalSpan += span;
+        maxSpan = std::max(maxSpan, span);
+    }
+}
+
+ModelCallProfiler::ModelCallProfiler(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_enabled(false)
+    , m_intercepting(false)
+    , m_refreshTimer(new QTimer(this))
+    , m_rowCountBeforeReset(0)
+{
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &ModelCallProfiler::refresh);
+}
+
+ModelCallProfiler::~ModelCallProfiler()
+{
+    stop();
+}
+
+bool ModelCallProfiler::isCallInterceptionSupported()
+{
+#ifdef GAMMARAY_MODEL_CALL_INTERCEPTION
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ModelCallProfiler::setModel(QAbstractItemModel *model)
+{
+    if (m_model == model)
+        return;
+    stop();
+    m_model = model;
+    clear();
+    start();
+}
+
+void ModelCallProfiler::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    stop();
+    m_enabled = enabled;
+    clear();
+    start();
+}
+
+void ModelCallProfiler::start()
+{
+    if (!m_enabled || !m_model)
+        return;
+
+    m_elapsed.start();
+    m_refreshTimer->start();
+
+#ifdef GAMMARAY_MODEL_CALL_INTERCEPTION
+    m_intercepting = installHooks(m_model, this);
+#endif
+
+    QAbstractItemModel *model = m_model;
+    m_connections.push_back(connect(model, &QObject::destroyed, this, [this]() {
+        setModel(nullptr);
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::dataChanged, this,
+                                    [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        recordSignal(DataChangedSignal, qint64(bottomRight.row() - topLeft.row() + 1)
+                     * (bottomRight.column() - topLeft.column() + 1));
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, [this]() {
+        m_layoutChangeTimer.start();
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::layoutChanged, this, [this]() {
+        recordSignal(LayoutChangedSignal, -1,
+                     m_layoutChangeTimer.isValid() ? m_layoutChangeTimer.nsecsElapsed() : -1);
+        m_layoutChangeTimer.invalidate();
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+        ProbeGuard guard;
+        m_rowCountBeforeReset = m_model->rowCount();
+        m_resetTimer.start();
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+        recordSignal(ModelResetSignal, m_rowCountBeforeReset,
+                     m_resetTimer.isValid() ? m_resetTimer.nsecsElapsed() : -1);
+        m_resetTimer.invalidate();
+        if (m_rowCountBeforeReset >= LargeModelRowCount)
+            reportLargeReset(m_rowCountBeforeReset);
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::rowsInserted, this,
+                                    [this](const QModelIndex &, int first, int last) {
+        recordSignal(RowsInsertedSignal, last - first + 1);
+    }));
+    m_connections.push_back(connect(model, &QAbstractItemModel::rowsRemoved, this,
+                                    [this](const QModelIndex &, int first, int last) {
+        recordSignal(RowsRemovedSignal, last - first + 1);
+    }));
+}
+
+void ModelCallProfiler::stop()
+{
+#ifdef GAMMARAY_MODEL_CALL_INTERCEPTION
+    if (m_intercepting)
+        uninstallHooks();
+#endif
+    m_intercepting = false;
+
+    for (const auto &connection : qAsConst(m_connections))
+        disconnect(connection);
+    m_connections.clear();
+    m_refreshTimer->stop();
+}
+
+void ModelCallProfiler::clear()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_dataStats.clear();
+        std::fill(std::begin(m_callStats), std::end(m_callStats), Stats());
+    }
+    std::fill(std::begin(m_signalStats), std::end(m_signalStats), Stats());
+    m_layoutChangeTimer.invalidate();
+    m_resetTimer.invalidate();
+
+    if (m_rows.isEmpty())
+        return;
+    beginResetModel();
+    m_rows.clear();
+    endResetModel();
+}
+
+void ModelCallProfiler::recordCall(CallType type, int role, qint64 nsecs)
+{
+    QMutexLocker lock(&m_mutex);
+    if (type == DataCall)
+        m_dataStats[role].add(nsecs, -1);
+    else
+        m_callStats[type].add(nsecs, -1);
+}
+
+void ModelCallProfiler::recordSignal(SignalType type, qint64 span, qint64 time)
+{
+    m_signalStats[type].add(time, span);
+}
+
+void ModelCallProfiler::reportLargeReset(int rowCount)
+{
+    Problem p;
+    p.severity = Problem::Warning;
+    p.description = tr("%1 was reset while containing %2 rows. Views have to rebuild their entire state on "
+                       "a reset, emitting more fine-grained change notifications is usually much cheaper.")
+                    .arg(Util::displayString(m_model), QString::number(rowCount));
+    p.object = ObjectId(m_model);
+    p.problemId = QStringLiteral("com.kdab.GammaRay.ModelInspector.LargeModelReset:%1")
+                  .arg(reinterpret_cast<quintptr>(m_model.data()));
+    p.findingCategory = Problem::Live;
+    ProblemCollector::addProblem(p);
+}
+
+void ModelCallProfiler::refresh()
+{
+    if (!m_model)
+        return;
+
+    QHash<int, QString> roleNames;
+    for (const auto &role : ModelCellModel::rolesForModel(m_model))
+        roleNames.insert(role.first, role.second);
+
+    QVector<Row> rows;
+    {
+        QMutexLocker lock(&m_mutex);
+        auto roles = m_dataStats.keys();
+        std::sort(roles.begin(), roles.end());
+        for (const auto role : qAsConst(roles)) {
+            Row row;
+            row.name = tr("data(%1)").arg(roleNames.value(role, QString::number(role)));
+            row.stats = m_dataStats.value(role);
+            row.hasTime = true;
+            rows.push_back(row);
+        }
+
+        static const char * const callNames[] = {
+            "data()", "rowCount()", "index()", "parent()", "fetchMore()", "canFetchMore()", "sort()"
+        };
+        static_assert(sizeof(callNames) / sizeof(callNames[0]) == CallTypeCount, "call name missing");
+        for (int type = RowCountCall; type < CallTypeCount; ++type) {
+            if (!m_callStats[type].count)
+                continue;
+            Row row;
+            row.name = QString::fromLatin1(callNames[type]);
+            row.stats = m_callStats[type];
+            row.hasTime = true;
+            rows.push_back(row);
+        }
+    }
+
+    static const char * const signalNames[] = {
+        "dataChanged", "layoutChanged", "modelReset", "rowsInserted", "rowsRemoved"
+    };
+    static_assert(sizeof(signalNames) / sizeof(signalNames[0]) == SignalTypeCount, "signal name missing");
+    for (int type = 0; type < SignalTypeCount; ++type) {
+        if (!m_signalStats[type].count)
+            continue;
+        Row row;
+        row.name = QString::fromLatin1(signalNames[type]);
+        row.stats = m_signalStats[type];
+        row.hasTime = type == LayoutChangedSignal || type == ModelResetSignal;
+        row.hasSpan = type != LayoutChangedSignal;
+        rows.push_back(row);
+    }
+
+    bool sameRows = rows.size() == m_rows.size();
+    for (int i = 0; sameRows && i < rows.size(); ++i)
+        sameRows = rows.at(i).name == m_rows.at(i).name;
+
+    if (!sameRows) {
+        beginResetModel();
+        m_rows = rows;
+        endResetModel();
+    } else if (!rows.isEmpty()) {
+        m_rows = rows;
+        emit dataChanged(index(0, CountColumn), index(m_rows.size() - 1, ColumnCount - 1));
+    }
+}
+
+int ModelCallProfiler::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int ModelCallProfiler::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant ModelCallProfiler::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const auto &row = m_rows.at(index.row());
+    const auto &stats = row.stats;
+    switch (index.column()) {
+    case NameColumn:
+        return row.name;
+    case CountColumn:
+        return stats.count;
+    case RateColumn:
+    {
+        const auto secs = m_elapsed.isValid() ? m_elapsed.elapsed() / 1000.0 : 0.0;
+        return secs > 0.0 ? QVariant(qRound(stats.count / secs * 10.0) / 10.0) : QVariant();
+    }
+    case TotalTimeColumn:
+        return row.hasTime ? Util::nsecsToMSecs(stats.totalTime) : QVariant();
+    case MeanTimeColumn:
+        return row.hasTime && stats.count ? Util::nsecsToUSecs(stats.totalTime / qint64(stats.count)) : QVariant();
+    case MaxTimeColumn:
+        return row.hasTime ? Util::nsecsToUSecs(stats.maxTime) : QVariant();
+    case MeanSpanColumn:
+        return row.hasSpan && stats.count ? QVariant(double(stats.totalSpan) / stats.count) : QVariant();
+    case MaxSpanColumn:
+        return row.hasSpan ? QVariant(stats.maxSpan) : QVariant();
+    }
+    return QVariant();
+}
+
+QVariant ModelCallProfiler::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        switch (section) {
+        case NameColumn:
+            return tr("Call / Signal");
+        case CountColumn:
+            return tr("Count");
+        case RateColumn:
+            return tr("Rate [1/s]");
+        case TotalTimeColumn:
+            return tr("Total [ms]");
+        case MeanTimeColumn:
+            return tr("Mean [µs]");
+        case MaxTimeColumn:
+            return tr("Max [µs]");
+        case MeanSpanColumn:
+            return tr("Mean Span");
+        case MaxSpanColumn:
+            return tr("Max Span");
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (section) {
+        case TotalTimeColumn:
+        case MeanTimeColumn:
+        case MaxTimeColumn:
+            return tr("Time spent in the call, or between the begin and end notification of a layout change or reset.");
+        case MeanSpanColumn:
+        case MaxSpanColumn:
+            return tr("Number of cells changed, rows inserted or removed, or rows contained before a reset.");
+        }
+    }
+    return QVariant();
+}
@@ -0,0 +1,157 @@
+/*
+  modelcallprofiler.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
+#define GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/**
+ * Counts and times the calls made to a single item model, as well as the change
+ * notifications it emits.
+ *
+ * Calls are intercepted by temporarily replacing the corresponding entries in the
+ * virtual table of the model's class, which is only supported for the Itanium C++ ABI
+ * on x86 Linux. Elsewhere, only change notifications are recorded.
+ */
+class ModelCallProfiler : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        NameColumn,
+        CountColumn,
+        RateColumn,
+        TotalTimeColumn,
+        MeanTimeColumn,
+        MaxTimeColumn,
+        MeanSpanColumn,
+        MaxSpanColumn,
+        ColumnCount
+    };
+
+    enum CallType {
+        DataCall,
+        RowCountCall,
+        IndexCall,
+        ParentCall,
+        FetchMoreCall,
+        CanFetchMoreCall,
+        SortCall,
+        CallTypeCount
+    };
+
+    enum SignalType {
+        DataChangedSignal,
+        LayoutChangedSignal,
+        ModelResetSignal,
+        RowsInsertedSignal,
+        RowsRemovedSignal,
+        SignalTypeCount
+    };
+
+    explicit ModelCallProfiler(QObject *parent = nullptr);
+    ~ModelCallProfiler() override;
+
+    /// Models with at least that many rows are reported as problem when being reset.
+    enum { LargeModelRowCount = 1000 };
+
+    static bool isCallInterceptionSupported();
+
+    void setModel(QAbstractItemModel *model);
+    void setEnabled(bool enabled);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    /// @internal called from the intercepted methods, in any thread
+    void recordCall(CallType type, int role, qint64 nsecs);
+
+private slots:
+    void refresh();
+
+private:
+    struct Stats
+    {
+        quint64 count = 0;
+        qint64 totalTime = 0;
+        qint64 maxTime = 0;
+        qint64 totalSpan = 0;
+        qint64 maxSpan = 0;
+
+        void add(qint64 time, qint64 span);
+    };
+    struct Row
+    {
+        QString name;
+        Stats stats;
+        bool hasTime = false;
+        bool hasSpan = false;
+    };
+
+    void start();
+    void stop();
+    void clear();
+    void recordSignal(SignalType type, qint64 span, qint64 time = -1);
+    void reportLargeReset(int rowCount);
+
+    QPointer<QAbstractItemModel> m_model;
+    bool m_enabled;
+    bool m_intercepting;
+    QVector<QMetaObject::Connection> m_connections;
+    QTimer *m_refreshTimer;
+    QElapsedTimer m_elapsed;
+
+    // written from the intercepted calls, protected by m_mutex
+    QMutex m_mutex;
+    QHash<int, Stats> m_dataStats;
+    Stats m_callStats[CallTypeCount];
+
+    // change notifications, main thread only
+    Stats m_signalStats[SignalTypeCount];
+    QElapsedTimer m_layoutChangeTimer;
+    QElapsedTimer m_resetTimer;
+    int m_rowCountBeforeReset;
+
+    QVector<Row> m_rows;
+};
+}
+
+#endif // GAMMARAY_MODELINSPECTOR_MODELCALLPROFILER_H
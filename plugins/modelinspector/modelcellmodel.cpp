@@ -28,11 +28,12 @@
 
 #include "modelcellmodel.h"
 
-#include <compat/qasconst.h>
-
+#include <core/probeguard.h>
 #include <core/varianthandler.h>
 
 #include <QAbstractProxyModel>
+#include <QHash>
+#include <QMap>
 
 using namespace GammaRay;
 
@@ -51,75 +52,139 @@ static bool sourceIsQQmlListModel(const QAbstractItemModel *model)
 
 void ModelCellModel::setModelIndex(const QModelIndex &idx)
 {
-    const auto newRoles = rolesForModel(idx.model());
+    if (m_model != idx.model()) {
+        if (m_model)
+            disconnect(m_model, nullptr, this, nullptr);
+        m_model = idx.model();
+        m_modelRoles.clear();
+        if (m_model) {
+            connect(m_model, &QAbstractItemModel::modelReset, this, &ModelCellModel::sourceModelReset);
+            connect(m_model, &QAbstractItemModel::dataChanged, this, &ModelCellModel::sourceDataChanged);
+            connect(m_model, &QAbstractItemModel::rowsRemoved, this, &ModelCellModel::sourceIndexInvalidated);
+            connect(m_model, &QAbstractItemModel::columnsRemoved, this, &ModelCellModel::sourceIndexInvalidated);
+            connect(m_model, &QAbstractItemModel::layoutChanged, this, &ModelCellModel::sourceIndexInvalidated);
+            connect(m_model, &QAbstractItemModel::modelReset, this, &ModelCellModel::sourceIndexInvalidated);
+        }
+    }
+
+    if (idx.isValid() && m_modelRoles.isEmpty())
+        m_modelRoles = rolesForModel(m_model);
+    const auto newRoles = idx.isValid() ? m_modelRoles : QVector<RoleInfo>();
     if (newRoles != m_roles) {
         if (!m_roles.isEmpty()) {
             beginRemoveRows(QModelIndex(), 0, m_roles.size() - 1);
             m_roles.clear();
+            m_values.clear();
+            m_valueCached.clear();
             endRemoveRows();
         }
         m_index = idx;
         if (!newRoles.isEmpty()) {
             beginInsertRows(QModelIndex(), 0, newRoles.size() - 1);
             m_roles = newRoles;
+            m_values.fill(QVariant(), m_roles.size());
+            m_valueCached.fill(false, m_roles.size());
             endInsertRows();
         }
     } else {
         m_index = idx;
         if (!m_roles.isEmpty()) {
-            emit dataChanged(index(0, 1), index(rowCount() - 1, 1));
+            m_valueCached.fill(false);
+            emit dataChanged(index(0, 1), index(rowCount() - 1, 2));
         }
     }
 }
 
+void ModelCellModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                       const QVector<int> &roles)
+{
+    if (!m_index.isValid() || m_roles.isEmpty() || topLeft.parent() != m_index.parent()
+        || m_index.row() < topLeft.row() || m_index.row() > bottomRight.row()
+        || m_index.column() < topLeft.column() || m_index.column() > bottomRight.column())
+        return;
+
+    // only report the roles whose value actually changed, in as few ranges as possible
+    ProbeGuard guard;
+    int firstChanged = -1;
+    for (int row = 0; row <= m_roles.size(); ++row) {
+        bool changed = false;
+        if (row < m_roles.size() && m_valueCached.at(row)
+            && (roles.isEmpty() || roles.contains(m_roles.at(row).first))) {
+            const auto value = m_index.data(m_roles.at(row).first);
+            changed = value.userType() != m_values.at(row).userType() || value != m_values.at(row);
+            m_values[row] = value;
+        }
+        if (changed && firstChanged < 0) {
+            firstChanged = row;
+        } else if (!changed && firstChanged >= 0) {
+            emit dataChanged(index(firstChanged, 1), index(row - 1, 2));
+            firstChanged = -1;
+        }
+    }
+}
+
+void ModelCellModel::sourceModelReset()
+{
+    // role names might change along with a reset
+    m_modelRoles.clear();
+}
+
+void ModelCellModel::sourceIndexInvalidated()
+{
+    if (!m_index.isValid() && !m_roles.isEmpty())
+        setModelIndex(QModelIndex());
+}
+
+QVariant ModelCellModel::cellValue(int row) const
+{
+    if (!m_valueCached.at(row)) {
+        m_values[row] = m_index.data(m_roles.at(row).first);
+        m_valueCached[row] = true;
+    }
+    return m_values.at(row);
+}
+
 QVector<ModelCellModel::RoleInfo> ModelCellModel::rolesForModel(const QAbstractItemModel *model)
 {
-    QVector<RoleInfo> roles;
     if (!model)
-        return roles;
+        return QVector<RoleInfo>();
+
+    QMap<int, QString> roles;
 
     // add built-in roles
-    const auto hasDefaultRoles = !sourceIsQQmlListModel(model);
-    if (hasDefaultRoles) {
-#define R(x) qMakePair<int, QString>(x, QStringLiteral(#x))
-        roles << R(Qt::DisplayRole)
-              << R(Qt::DecorationRole)
-              << R(Qt::EditRole)
-              << R(Qt::ToolTipRole)
-              << R(Qt::StatusTipRole)
-              << R(Qt::WhatsThisRole)
-              << R(Qt::FontRole)
-              << R(Qt::TextAlignmentRole)
-              << R(Qt::BackgroundRole)
-              << R(Qt::ForegroundRole)
-              << R(Qt::CheckStateRole)
-              << R(Qt::AccessibleTextRole)
-              << R(Qt::AccessibleDescriptionRole)
-              << R(Qt::SizeHintRole)
-              << R(Qt::InitialSortOrderRole)
-          ;
+    if (!sourceIsQQmlListModel(model)) {
+#define R(x) roles.insert(x, QStringLiteral(#x))
+        R(Qt::DisplayRole);
+        R(Qt::DecorationRole);
+        R(Qt::EditRole);
+        R(Qt::ToolTipRole);
+        R(Qt::StatusTipRole);
+        R(Qt::WhatsThisRole);
+        R(Qt::FontRole);
+        R(Qt::TextAlignmentRole);
+        R(Qt::BackgroundRole);
+        R(Qt::ForegroundRole);
+        R(Qt::CheckStateRole);
+        R(Qt::AccessibleTextRole);
+        R(Qt::AccessibleDescriptionRole);
+        R(Qt::SizeHintRole);
+        R(Qt::InitialSortOrderRole);
 #undef R
     }
 
     // add custom roles
     const auto roleNames = model->roleNames();
-
     for (auto it = roleNames.constBegin(); it != roleNames.constEnd(); ++it) {
-        bool roleFound = false;
-        for (const auto &role : qAsConst(roles)) {
-            if (role.first == it.key()) {
-                roleFound = true;
-                break;
-            }
-        }
-        if (!roleFound) {
-            const auto name = it.value().isEmpty() ? tr("Role #%1").arg(it.key()) : QString::fromLatin1(it.value());
-            roles.push_back(qMakePair(it.key(), name));
-        }
+        if (roles.contains(it.key()))
+            continue;
+        roles.insert(it.key(), it.value().isEmpty() ? tr("Role #%1").arg(it.key()) : QString::fromLatin1(it.value()));
     }
 
-    std::sort(roles.begin(), roles.end(), [] (const RoleInfo& lhs, const RoleInfo& rhs){return lhs.first < rhs.first;});
-    return roles;
+    QVector<RoleInfo> result;
+    result.reserve(roles.size());
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it)
+        result.push_back(qMakePair(it.key(), it.value()));
+    return result;
 }
 
 QVariant ModelCellModel::data(const QModelIndex &index, int role) const
@@ -128,21 +193,20 @@ QVariant ModelCellModel::data(const QModelIndex &index, int role) const
         return QVariant();
 
     Q_ASSERT(index.row() < m_roles.size());
-    const QVariant value = m_index.data(m_roles.at(index.row()).first);
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case 0:
             return m_roles.at(index.row()).second;
         case 1:
-            return VariantHandler::displayString(value);
+            return VariantHandler::displayString(cellValue(index.row()));
         case 2:
-            return value.typeName();
+            return cellValue(index.row()).typeName();
         }
     } else if (role == Qt::EditRole) {
         if (index.column() == 1)
-            return value;
+            return cellValue(index.row());
     } else if (role == Qt::DecorationRole && index.column() == 1) {
-        return VariantHandler::decoration(value);
+        return VariantHandler::decoration(cellValue(index.row()));
     }
 
     return QVariant();
@@ -180,7 +244,7 @@ int ModelCellModel::columnCount(const QModelIndex &parent) const
 
 int ModelCellModel::rowCount(const QModelIndex &parent) const
 {
-    if (parent.isValid() || !m_index.isValid())
+    if (parent.isValid())
         return 0;
     return m_roles.size();
 }
@@ -30,6 +30,7 @@
 #define GAMMARAY_MODELINSPECTOR_MODELCELLMODEL_H
 
 #include <QAbstractTableModel>
+#include <QPointer>
 #include <QVector>
 
 namespace GammaRay {
@@ -49,12 +50,26 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
 
-private:
     typedef QPair<int, QString> RoleInfo;
+    /// Built-in and custom roles of @p model, along with their names, sorted by role.
     static QVector<RoleInfo> rolesForModel(const QAbstractItemModel *model);
 
+private slots:
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                           const QVector<int> &roles);
+    void sourceModelReset();
+    void sourceIndexInvalidated();
+
+private:
+    QVariant cellValue(int row) const;
+
+    QPointer<const QAbstractItemModel> m_model;
+    QVector<RoleInfo> m_modelRoles; // roles of m_model, built on first use
     QPersistentModelIndex m_index;
     QVector<RoleInfo> m_roles;
+    // values are only queried once they are needed, and then kept until they change
+    mutable QVector<QVariant> m_values;
+    mutable QVector<bool> m_valueCached;
 };
 }
 
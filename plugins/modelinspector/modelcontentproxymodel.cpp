@@ -122,6 +122,12 @@ QMap<int, QVariant> ModelContentProxyModel::itemData(const QModelIndex &index) c
     return d;
 }
 
+bool ModelContentProxyModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return false;
+}
+
 void ModelContentProxyModel::emitDataChangedForSelection(const QItemSelection &selection)
 {
     for (const auto &range : selection) {
@@ -64,6 +64,8 @@ public:
     QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     QMap<int, QVariant> itemData(const QModelIndex &index) const override;
+    /*! Never fetch on behalf of the client, that would change the inspected model. */
+    bool canFetchMore(const QModelIndex &parent) const override;
 
 private slots:
     void selectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
@@ -29,6 +29,7 @@
 #include "modelinspector.h"
 
 #include "modelmodel.h"
+#include "modelcallprofiler.h"
 #include "modelcellmodel.h"
 #include "modelcontentproxymodel.h"
 #include "selectionmodelmodel.h"
@@ -81,6 +82,12 @@ ModelInspector::ModelInspector(Probe *probe, QObject *parent)
     m_cellModel = new ModelCellModel(this);
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelCellModel"), m_cellModel);
 
+    m_callProfiler = new ModelCallProfiler(this);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.ModelCallProfile"), m_callProfiler);
+    connect(this, &ModelInspectorInterface::callProfilingEnabledChanged, this, [this]() {
+        m_callProfiler->setEnabled(isCallProfilingEnabled());
+    });
+
     if (m_probe->needsObjectDiscovery())
         connect(m_probe, &Probe::objectCreated, this, &ModelInspector::objectCreated);
 }
@@ -97,9 +104,11 @@ void ModelInspector::modelSelected(const QItemSelection &selected)
         Q_ASSERT(model);
         m_selectionModelsModel->setModel(model);
         m_modelContentProxyModel->setSourceModel(model);
+        m_callProfiler->setModel(model);
     } else {
         m_selectionModelsModel->setModel(nullptr);
         m_modelContentProxyModel->setSourceModel(nullptr);
+        m_callProfiler->setModel(nullptr);
     }
 
     // clear the cell info box
@@ -44,6 +44,7 @@ class QModelIndex;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class ModelCallProfiler;
 class ModelCellModel;
 class ModelContentProxyModel;
 class SelectionModelModel;
@@ -75,6 +76,7 @@ private:
     ModelContentProxyModel *m_modelContentProxyModel;
 
     ModelCellModel *m_cellModel;
+    ModelCallProfiler *m_callProfiler;
 };
 
 class ModelInspectorFactory : public QObject,
@@ -81,3 +81,16 @@ void ModelInspectorInterface::setCurrentCellData(const ModelCellData& cellData)
     m_currentCellData = cellData;
     emit currentCellDataChanged();
 }
+
+bool ModelInspectorInterface::isCallProfilingEnabled() const
+{
+    return m_callProfilingEnabled;
+}
+
+void ModelInspectorInterface::setCallProfilingEnabled(bool enabled)
+{
+    if (m_callProfilingEnabled == enabled)
+        return;
+    m_callProfilingEnabled = enabled;
+    emit callProfilingEnabledChanged();
+}
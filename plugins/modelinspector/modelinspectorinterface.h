@@ -50,6 +50,7 @@ class ModelInspectorInterface : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(GammaRay::ModelCellData cellData READ currentCellData WRITE setCurrentCellData NOTIFY currentCellDataChanged)
+    Q_PROPERTY(bool callProfilingEnabled READ isCallProfilingEnabled WRITE setCallProfilingEnabled NOTIFY callProfilingEnabledChanged)
 public:
     explicit ModelInspectorInterface(QObject *parent = nullptr);
     ~ModelInspectorInterface() override;
@@ -57,11 +58,16 @@ public:
     ModelCellData currentCellData() const;
     void setCurrentCellData(const ModelCellData &cellData);
 
+    bool isCallProfilingEnabled() const;
+    void setCallProfilingEnabled(bool enabled);
+
 signals:
     void currentCellDataChanged();
+    void callProfilingEnabledChanged();
 
 private:
     ModelCellData m_currentCellData;
+    bool m_callProfilingEnabled = false;
 };
 }
 
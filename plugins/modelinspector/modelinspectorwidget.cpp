@@ -44,6 +44,7 @@
 
 #include <QDebug>
 #include <QMenu>
+#include <QSortFilterProxyModel>
 
 using namespace GammaRay;
 
@@ -98,6 +99,16 @@ ModelInspectorWidget::ModelInspectorWidget(QWidget *parent)
     ui->modelCellView->setModel(ObjectBroker::model(QStringLiteral(
                                                         "com.kdab.GammaRay.ModelCellModel")));
 
+    auto callProfileProxy = new QSortFilterProxyModel(this);
+    callProfileProxy->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ModelCallProfile")));
+    ui->callProfileView->setModel(callProfileProxy);
+    ui->callProfileView->header()->setObjectName("callProfileViewHeader");
+    ui->callProfileView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    ui->callProfileView->sortByColumn(3, Qt::DescendingOrder); // total time
+    ui->callProfilingBox->setChecked(m_interface->isCallProfilingEnabled());
+    connect(ui->callProfilingBox, &QAbstractButton::toggled,
+            m_interface, &ModelInspectorInterface::setCallProfilingEnabled);
+
     m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "33%" << "33%" << "33%");
 
     cellDataChanged();
@@ -48,126 +48,150 @@ QVariant ModelModel::data(const QModelIndex &index, int role) const
 
 int ModelModel::rowCount(const QModelIndex &parent) const
 {
-    if (parent.isValid()) {
-        if (parent.column() > 0)
-            return 0;
-        QAbstractItemModel *sourceModel = static_cast<QAbstractItemModel*>(parent.internalPointer());
-        Q_ASSERT(sourceModel);
-        const QVector<QAbstractProxyModel*> proxies = proxiesForModel(sourceModel);
-        return proxies.size();
-    }
-
-    return m_models.size();
+    if (parent.column() > 0)
+        return 0;
+    QAbstractItemModel *sourceModel = static_cast<QAbstractItemModel *>(parent.internalPointer());
+    return m_proxies.value(sourceModel).size();
 }
 
 QModelIndex ModelModel::parent(const QModelIndex &child) const
 {
     QAbstractItemModel *model = static_cast<QAbstractItemModel *>(child.internalPointer());
     Q_ASSERT(model);
-    if (m_models.contains(model))
-        return {};
-
-    QAbstractProxyModel *proxy = qobject_cast<QAbstractProxyModel *>(model);
-    Q_ASSERT(proxy);
-    return indexForModel(proxy->sourceModel());
+    Q_ASSERT(m_nodes.contains(model));
+    return indexForModel(m_nodes.value(model).sourceModel);
 }
 
 QModelIndex ModelModel::index(int row, int column, const QModelIndex &parent) const
 {
-    if (parent.isValid()) {
-        QAbstractItemModel *model = static_cast<QAbstractItemModel *>(parent.internalPointer());
-        const QVector<QAbstractProxyModel *> proxies = proxiesForModel(model);
-        if (proxies.size() <= row)
-            return {};
-        return createIndex(row, column, proxies.at(row));
-    }
-    return createIndex(row, column, m_models.at(row));
+    QAbstractItemModel *sourceModel = static_cast<QAbstractItemModel *>(parent.internalPointer());
+    const auto it = m_proxies.constFind(sourceModel);
+    if (it == m_proxies.constEnd() || row < 0 || column < 0 || row >= it.value().size()
+        || column >= columnCount())
+        return {};
+    return createIndex(row, column, it.value().at(row));
 }
 
 void ModelModel::objectAdded(QObject *obj)
 {
+    QAbstractItemModel *model = qobject_cast<QAbstractItemModel *>(obj);
+    if (!model || m_nodes.contains(model))
+        return;
+
     QAbstractProxyModel *proxy = qobject_cast<QAbstractProxyModel *>(obj);
     if (proxy) {
-        beginResetModel(); // FIXME
-        if (proxy->sourceModel())
-            m_proxies.push_back(proxy);
-        else
-            m_models.push_back(proxy);
-
         connect(proxy, &QAbstractProxyModel::sourceModelChanged, this, [this, proxy]() {
-            beginResetModel(); // FIXME
-            if (proxy->sourceModel()) {
-                const auto i = m_models.indexOf(proxy);
-                if (i >= 0)
-                    m_models.remove(i);
-                m_proxies.push_back(proxy);
-            } else {
-                const auto i = m_proxies.indexOf(proxy);
-                if (i >= 0)
-                    m_proxies.remove(i);
-                m_models.push_back(proxy);
-            }
-            endResetModel();
+            sourceModelChanged(proxy);
         });
-        endResetModel();
-        return;
     }
 
-    QAbstractItemModel *model = qobject_cast<QAbstractItemModel *>(obj);
-    if (model) {
-        beginInsertRows(QModelIndex(), m_models.size(), m_models.size());
-        m_models.push_back(model);
-        endInsertRows();
-    }
+    // proxies of this model we saw already come along with it
+    attach(model, proxy ? proxy->sourceModel() : nullptr);
 }
 
 void ModelModel::objectRemoved(QObject *obj)
 {
-    int index = m_models.indexOf(static_cast<QAbstractItemModel *>(obj));
-    if (index >= 0 && index < m_models.size()) {
-        beginRemoveRows(QModelIndex(), index, index);
-        m_models.remove(index);
-        endRemoveRows();
+    QAbstractItemModel *model = static_cast<QAbstractItemModel *>(obj);
+    if (m_nodes.contains(model)) {
+        detach(model);
+        m_nodes.remove(model);
     }
 
-    for (auto it = m_proxies.begin();
-         it != m_proxies.end(); ++it) {
-        if (*it == obj) {
-            beginResetModel(); // FIXME
-            m_proxies.erase(it);
-            endResetModel();
+    // the source model is gone, which also takes its proxies out of the tree
+    const auto proxies = m_proxies.take(model);
+    for (QAbstractItemModel *proxy : proxies) {
+        auto &node = m_nodes[proxy];
+        node.sourceModel = nullptr;
+        node.row = -1;
+    }
+}
+
+void ModelModel::sourceModelChanged(QAbstractProxyModel *proxy)
+{
+    const auto it = m_nodes.constFind(proxy);
+    if (it == m_nodes.constEnd())
+        return;
+    const Node node = it.value();
+    QAbstractItemModel *newSource = proxy->sourceModel();
+    if (node.row >= 0 && node.sourceModel == newSource)
+        return;
+
+    // move the proxy along with all its proxies, if possible
+    if (node.row >= 0 && isVisible(proxy) && (!newSource || isVisible(newSource))) {
+        // make sure both exist, so taking references to them doesn't rehash
+        m_proxies[node.sourceModel];
+        auto &newSiblings = m_proxies[newSource];
+        auto &oldSiblings = m_proxies[node.sourceModel];
+        if (beginMoveRows(indexForModel(node.sourceModel), node.row, node.row,
+                          indexForModel(newSource), newSiblings.size())) {
+            oldSiblings.remove(node.row);
+            m_nodes[proxy] = { newSource, newSiblings.size() };
+            newSiblings.push_back(proxy);
+            updateRows(node.sourceModel, node.row);
+            endMoveRows();
             return;
         }
     }
+
+    detach(proxy);
+    attach(proxy, newSource);
 }
 
 QModelIndex ModelModel::indexForModel(QAbstractItemModel *model) const
 {
-    if (!model)
+    if (!model || !isVisible(model))
         return {};
-    QAbstractProxyModel *proxy = qobject_cast<QAbstractProxyModel *>(model);
-    if (!proxy) {
-        Q_ASSERT(m_models.contains(model));
-        return index(m_models.indexOf(model), 0, QModelIndex());
+    return createIndex(m_nodes.value(model).row, 0, model);
+}
+
+bool ModelModel::isVisible(QAbstractItemModel *model) const
+{
+    // the depth limit guards against proxy cycles
+    for (int depth = 0; model; ++depth) {
+        if (depth > m_nodes.size())
+            return false;
+        const auto it = m_nodes.constFind(model);
+        if (it == m_nodes.constEnd() || it.value().row < 0)
+            return false;
+        model = it.value().sourceModel;
     }
+    return true;
+}
 
-    QAbstractItemModel *sourceModel = proxy->sourceModel();
-    const QModelIndex parentIndex = indexForModel(sourceModel);
-    const QVector<QAbstractProxyModel *> proxies = proxiesForModel(sourceModel);
-    Q_ASSERT(proxies.contains(proxy));
-    return index(proxies.indexOf(proxy), 0, parentIndex);
+void ModelModel::attach(QAbstractItemModel *model, QAbstractItemModel *sourceModel)
+{
+    const bool visible = !sourceModel || isVisible(sourceModel);
+    auto &siblings = m_proxies[sourceModel];
+    const int row = siblings.size();
+    if (visible)
+        beginInsertRows(indexForModel(sourceModel), row, row);
+    siblings.push_back(model);
+    m_nodes.insert(model, { sourceModel, row });
+    if (visible)
+        endInsertRows();
 }
 
-QVector<QAbstractProxyModel *> ModelModel::proxiesForModel(QAbstractItemModel *model) const
+void ModelModel::detach(QAbstractItemModel *model)
 {
-    QVector<QAbstractProxyModel *> proxies;
-    if (!model)
-        return proxies;
+    const Node node = m_nodes.value(model);
+    if (node.row < 0)
+        return;
 
-    for (QAbstractProxyModel *proxy : m_proxies) {
-        if (proxy && proxy->sourceModel() == model)
-            proxies.push_back(proxy);
-    }
+    const bool visible = isVisible(model);
+    if (visible)
+        beginRemoveRows(indexForModel(node.sourceModel), node.row, node.row);
+    m_proxies[node.sourceModel].remove(node.row);
+    m_nodes[model].row = -1;
+    updateRows(node.sourceModel, node.row);
+    if (visible)
+        endRemoveRows();
+}
 
-    return proxies;
+void ModelModel::updateRows(QAbstractItemModel *sourceModel, int firstRow)
+{
+    const auto it = m_proxies.constFind(sourceModel);
+    if (it == m_proxies.constEnd())
+        return;
+    for (int row = firstRow; row < it.value().size(); ++row)
+        m_nodes[it.value().at(row)].row = row;
 }
@@ -33,6 +33,7 @@
 
 #include <QAbstractItemModel>
 #include <QAbstractProxyModel>
+#include <QHash>
 #include <QVector>
 
 namespace GammaRay {
@@ -52,12 +53,24 @@ public slots:
     void objectRemoved(QObject *obj);
 
 private:
+    void sourceModelChanged(QAbstractProxyModel *proxy);
+
     QModelIndex indexForModel(QAbstractItemModel *model) const;
-    QVector<QAbstractProxyModel *> proxiesForModel(QAbstractItemModel *model) const;
+    bool isVisible(QAbstractItemModel *model) const;
+    void attach(QAbstractItemModel *model, QAbstractItemModel *sourceModel);
+    void detach(QAbstractItemModel *model);
+    void updateRows(QAbstractItemModel *sourceModel, int firstRow);
 
 private:
-    QVector<QAbstractItemModel *> m_models;
-    QVector<QAbstractProxyModel *> m_proxies;
+    struct Node
+    {
+        QAbstractItemModel *sourceModel; // nullptr for top-level models
+        int row; // -1 if detached, ie. its source model is gone
+    };
+    QHash<QAbstractItemModel *, Node> m_nodes;
+    // source model -> proxies, in insertion order, top-level models are listed under nullptr.
+    // Proxies of source models we don't know (yet) are kept here as well.
+    QHash<QAbstractItemModel *, QVector<QAbstractItemModel *> > m_proxies;
 };
 }
 
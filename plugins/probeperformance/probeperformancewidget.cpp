@@ -0,0 +1,59 @@
+/*
+  probeperformancewidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "probeperformancewidget.h"
+#include "ui_probeperformancewidget.h"
+
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+
+#include <3rdparty/kde/krecursivefilterproxymodel.h>
+
+using namespace GammaRay;
+
+ProbePerformanceWidget::ProbePerformanceWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::ProbePerformanceWidget)
+    , m_stateManager(this)
+{
+    ui->setupUi(this);
+
+    auto proxy = new KRecursiveFilterProxyModel(this);
+    proxy->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ProbePerformanceModel")));
+    proxy->setDynamicSortFilter(true);
+    ui->profilingView->setModel(proxy);
+    new SearchLineController(ui->searchLine, proxy);
+
+    ui->profilingView->header()->setObjectName("profilingViewHeader");
+    ui->profilingView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    for (int i = 1; i < 8; ++i)
+        ui->profilingView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->profilingView->sortByColumn(2, Qt::DescendingOrder); // total time
+}
+
+ProbePerformanceWidget::~ProbePerformanceWidget() = default;
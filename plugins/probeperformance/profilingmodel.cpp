@@ -0,0 +1,239 @@
+/*
+  profilingmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profilingmodel.h"
+
+#include <common/modelevent.h>
+#include <common/profilingpoint.h>
+
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+static const quintptr TopLevelId = 0;
+
+ProfilingModel::ProfilingModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &ProfilingModel::refresh);
+    m_tools = collectTools();
+}
+
+ProfilingModel::~ProfilingModel()
+{
+    ProfilingPoint::setEnabled(false);
+}
+
+int ProfilingModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int ProfilingModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_tools.size();
+    if (parent.internalId() == TopLevelId && parent.column() == 0)
+        return m_tools.at(parent.row()).points.size();
+    return 0;
+}
+
+QModelIndex ProfilingModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    if (!parent.isValid())
+        return createIndex(row, column, TopLevelId);
+    // children carry the row of their tool, offset by one
+    return createIndex(row, column, parent.row() + 1);
+}
+
+QModelIndex ProfilingModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == TopLevelId)
+        return QModelIndex();
+    return createIndex(int(child.internalId() - 1), 0, TopLevelId);
+}
+
+QVariant ProfilingModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    if (index.internalId() == TopLevelId)
+        return toolData(m_tools.at(index.row()), index.column());
+    const auto &tool = m_tools.at(int(index.internalId() - 1));
+    return pointData(tool.points.at(index.row()), index.column());
+}
+
+QVariant ProfilingModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section) {
+    case NameColumn:
+        return tr("Tool / Hot Path");
+    case CallsColumn:
+        return tr("Calls");
+    case TotalColumn:
+        return tr("Total [ms]");
+    case MeanColumn:
+        return tr("Mean [µs]");
+    case MaxColumn:
+        return tr("Max [µs]");
+    case P90Column:
+        return tr("90% [µs]");
+    case P99Column:
+        return tr("99% [µs]");
+    case DataColumn:
+        return tr("Data [kB]");
+    }
+    return QVariant();
+}
+
+void ProfilingModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool used = static_cast<ModelEvent *>(event)->used();
+        ProfilingPoint::setEnabled(used);
+        if (used) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    }
+    QAbstractItemModel::customEvent(event);
+}
+
+void ProfilingModel::refresh()
+{
+    auto tools = collectTools();
+
+    bool sameStructure = tools.size() == m_tools.size();
+    for (int i = 0; sameStructure && i < tools.size(); ++i)
+        sameStructure = tools.at(i).points == m_tools.at(i).points;
+
+    if (!sameStructure) {
+        beginResetModel();
+        m_tools = std::move(tools);
+        endResetModel();
+        return;
+    }
+
+    for (int i = 0; i < m_tools.size(); ++i) {
+        const auto toolIndex = index(i, 0);
+        emit dataChanged(index(i, CallsColumn), index(i, ColumnCount - 1));
+        const auto pointCount = m_tools.at(i).points.size();
+        if (pointCount > 0)
+            emit dataChanged(index(0, CallsColumn, toolIndex), index(pointCount - 1, ColumnCount - 1, toolIndex));
+    }
+}
+
+QVector<ProfilingModel::ToolEntry> ProfilingModel::collectTools()
+{
+    auto points = ProfilingPoint::points();
+    std::sort(points.begin(), points.end(), [](const ProfilingPoint *lhs, const ProfilingPoint *rhs) {
+        const int cmp = qstrcmp(lhs->tool(), rhs->tool());
+        if (cmp != 0)
+            return cmp < 0;
+        return qstrcmp(lhs->name(), rhs->name()) < 0;
+    });
+
+    QVector<ToolEntry> tools;
+    for (auto point : qAsConst(points)) {
+        if (tools.isEmpty() || tools.last().name != point->tool())
+            tools.push_back({ QByteArray(point->tool()), {} });
+        tools.last().points.push_back(point);
+    }
+    return tools;
+}
+
+QVariant ProfilingModel::toolData(const ToolEntry &tool, int column) const
+{
+    if (column == NameColumn)
+        return QString::fromUtf8(tool.name);
+
+    quint64 count = 0;
+    quint64 total = 0;
+    quint64 max = 0;
+    quint64 bytes = 0;
+    for (const auto point : tool.points) {
+        count += point->count();
+        total += point->totalNSecs();
+        max = std::max(max, point->maxNSecs());
+        bytes += point->bytes();
+    }
+
+    switch (column) {
+    case CallsColumn:
+        return count;
+    case TotalColumn:
+        return Util::nsecsToMSecs(total);
+    case MeanColumn:
+        return count ? Util::nsecsToUSecs(total / count) : QVariant();
+    case MaxColumn:
+        return Util::nsecsToUSecs(max);
+    case DataColumn:
+        return bytes ? QVariant(bytes / 1024) : QVariant();
+    }
+    return QVariant();
+}
+
+QVariant ProfilingModel::pointData(const ProfilingPoint *point, int column) const
+{
+    const auto count = point->count();
+    switch (column) {
+    case NameColumn:
+        return QString::fromUtf8(point->name());
+    case CallsColumn:
+        return count;
+    case TotalColumn:
+        return Util::nsecsToMSecs(point->totalNSecs());
+    case MeanColumn:
+        return count ? Util::nsecsToUSecs(point->totalNSecs() / count) : QVariant();
+    case MaxColumn:
+        return Util::nsecsToUSecs(point->maxNSecs());
+    case P90Column:
+        return count ? Util::nsecsToUSecs(point->percentileNSecs(0.9)) : QVariant();
+    case P99Column:
+        return count ? Util::nsecsToUSecs(point->percentileNSecs(0.99)) : QVariant();
+    case DataColumn:
+        return point->bytes() ? QVariant(point->bytes() / 1024) : QVariant();
+    }
+    return QVariant();
+}
@@ -0,0 +1,90 @@
+/*
+  profilingmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_PROFILINGMODEL_H
+#define GAMMARAY_PROFILINGMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class ProfilingPoint;
+
+/** Per-tool aggregation of the probe's internal profiling points.
+ *  Collection is only enabled while a client is looking at this model.
+ */
+class ProfilingModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        NameColumn,
+        CallsColumn,
+        TotalColumn,
+        MeanColumn,
+        MaxColumn,
+        P90Column,
+        P99Column,
+        DataColumn,
+        ColumnCount
+    };
+
+    explicit ProfilingModel(QObject *parent = nullptr);
+    ~ProfilingModel() override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    void customEvent(QEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    struct ToolEntry {
+        QByteArray name;
+        QVector<ProfilingPoint*> points;
+    };
+    static QVector<ToolEntry> collectTools();
+    QVariant toolData(const ToolEntry &tool, int column) const;
+    QVariant pointData(const ProfilingPoint *point, int column) const;
+
+    QVector<ToolEntry> m_tools;
+    QTimer *m_refreshTimer;
+};
+}
+
+#endif // GAMMARAY_PROFILINGMODEL_H
@@ -29,6 +29,7 @@
 #include "3dinspector.h"
 #include "qt3dentitytreemodel.h"
 #include "framegraphmodel.h"
+#include "framestatisticsmodel.h"
 #include "geometryextension/qt3dgeometryextension.h"
 #include "paintanalyzerextension/qt3dpaintedtextureanalyzerextension.h"
 
@@ -94,6 +95,7 @@ Qt3DInspector::Qt3DInspector(Probe *probe, QObject *parent)
     , m_frameGraphPropertyController(new PropertyController(QStringLiteral(
                                                                 "com.kdab.GammaRay.Qt3DInspector.frameGraphPropertyController"),
                                                             this))
+    , m_statisticsModel(new FrameStatisticsModel(this))
 {
     registerCoreMetaTypes();
     registerInputMetaTypes();
@@ -130,6 +132,14 @@ Qt3DInspector::Qt3DInspector(Probe *probe, QObject *parent)
     connect(m_frameGraphSelectionModel, &QItemSelectionModel::selectionChanged, this,
             &Qt3DInspector::frameGraphSelectionChanged);
 
+    connect(probe, &Probe::objectCreated, m_statisticsModel, &FrameStatisticsModel::objectCreated);
+    connect(probe, &Probe::objectDestroyed, m_statisticsModel, &FrameStatisticsModel::objectDestroyed);
+    connect(probe, &Probe::objectReparented, m_statisticsModel, &FrameStatisticsModel::objectReparented);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.Qt3DInspector.frameStatisticsModel"), m_statisticsModel);
+    connect(this, &Qt3DInspectorInterface::statisticsEnabledChanged, this, [this]() {
+        m_statisticsModel->setEnabled(isStatisticsEnabled());
+    });
+
     connect(probe, &Probe::objectSelected, this, &Qt3DInspector::objectSelected);
 }
 
@@ -156,6 +166,7 @@ void Qt3DInspector::selectEngine(Qt3DCore::QAspectEngine *engine)
 
     m_engine = engine;
     m_entityModel->setEngine(engine);
+    m_statisticsModel->setEngine(engine);
     if (!engine)
         return;
 
@@ -191,6 +202,7 @@ void Qt3DInspector::selectEntity(Qt3DCore::QEntity *entity)
     m_entitryPropertyController->setObject(entity);
 
     // update selelction if we got here via object navigation
+    m_entityModel->fetchEntity(entity);
     const auto model = m_entitySelectionModel->model();
     Model::used(model);
 
@@ -227,6 +239,7 @@ void Qt3DInspector::selectFrameGraphNode(Qt3DRender::QFrameGraphNode *node)
     m_frameGraphPropertyController->setObject(node);
 
     // update selelction if we got here via object navigation
+    m_frameGraphModel->fetchNode(node);
     const auto model = m_frameGraphSelectionModel->model();
     Model::used(model);
 
@@ -51,6 +51,7 @@ namespace GammaRay {
 class PropertyController;
 class Qt3DEntityTreeModel;
 class FrameGraphModel;
+class FrameStatisticsModel;
 
 class Qt3DInspector : public Qt3DInspectorInterface
 {
@@ -92,6 +93,8 @@ private:
     QItemSelectionModel *m_frameGraphSelectionModel;
     Qt3DRender::QFrameGraphNode *m_currentFrameGraphNode;
     PropertyController *m_frameGraphPropertyController;
+
+    FrameStatisticsModel *m_statisticsModel;
 };
 
 class Qt3DInspectorFactory : public QObject,
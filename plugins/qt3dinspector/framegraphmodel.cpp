@@ -31,14 +31,22 @@
 #include <Qt3DRender/QFrameGraphNode>
 #include <Qt3DRender/QRenderSettings>
 
+#include <QTimer>
+
 #include <algorithm>
 
 using namespace GammaRay;
 
+static const int FetchChunkSize = 256;
+
 FrameGraphModel::FrameGraphModel(QObject *parent)
     : ObjectModelBase<QAbstractItemModel>(parent)
     , m_settings(nullptr)
+    , m_insertTimer(new QTimer(this))
 {
+    m_insertTimer->setSingleShot(true);
+    m_insertTimer->setInterval(0);
+    connect(m_insertTimer, &QTimer::timeout, this, &FrameGraphModel::insertPendingNodes);
 }
 
 FrameGraphModel::~FrameGraphModel()
@@ -51,8 +59,15 @@ void FrameGraphModel::setRenderSettings(Qt3DRender::QRenderSettings *settings)
     clear();
     m_settings = settings;
     // TODO monitor m_settings->activeFrameGraph changed
-    if (m_settings)
-        populateFromNode(m_settings->activeFrameGraph());
+    // only the root node is added here, everything below it is populated on demand
+    auto root = m_settings ? m_settings->activeFrameGraph() : nullptr;
+    if (root) {
+        m_parentChildMap[nullptr].push_back(root);
+        m_childParentMap.insert(root, nullptr);
+        m_childRowMap.insert(root, 0);
+        m_unpopulated.insert(root);
+        connectNode(root);
+    }
     endResetModel();
 }
 
@@ -60,37 +75,56 @@ void FrameGraphModel::clear()
 {
     for (auto it = m_childParentMap.constBegin(); it != m_childParentMap.constEnd(); ++it)
         disconnectNode(it.key());
+    m_insertTimer->stop();
     m_childParentMap.clear();
     m_parentChildMap.clear();
+    m_childRowMap.clear();
+    m_unpopulated.clear();
+    m_pendingChildren.clear();
+    m_pendingParentMap.clear();
+    m_dirtyParents.clear();
 }
 
-void FrameGraphModel::populateFromNode(Qt3DRender::QFrameGraphNode *node)
+void FrameGraphModel::populateChildren(Qt3DRender::QFrameGraphNode *node) const
 {
-    if (!node)
+    if (!m_unpopulated.remove(node))
         return;
 
-    m_childParentMap[node] = node->parentFrameGraphNode();
-    m_parentChildMap[node->parentFrameGraphNode()].push_back(node);
-    connectNode(node);
-
     foreach (auto child, node->childNodes()) {
-        if (auto childNode = qobject_cast<Qt3DRender::QFrameGraphNode *>(child))
-            populateFromNode(childNode);
+        auto childNode = qobject_cast<Qt3DRender::QFrameGraphNode *>(child);
+        // can be known already if reparented but we didn't get notified about that yet
+        if (!childNode || isKnown(childNode))
+            continue;
+        m_pendingChildren[node].push_back(childNode);
+        m_pendingParentMap.insert(childNode, node);
     }
+}
 
-    auto &children = m_parentChildMap[node->parentFrameGraphNode()];
-    std::sort(children.begin(), children.end());
+bool FrameGraphModel::isKnown(Qt3DRender::QFrameGraphNode *node) const
+{
+    return m_childParentMap.contains(node) || m_pendingParentMap.contains(node);
 }
 
-int FrameGraphModel::rowCount(const QModelIndex &parent) const
+void FrameGraphModel::fetchNode(Qt3DRender::QFrameGraphNode *node)
 {
-    auto parentNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(parent.internalPointer());
-    return m_parentChildMap.value(parentNode).size();
+    if (!m_settings || !node || m_childParentMap.contains(node))
+        return;
+
+    auto parentNode = node->parentFrameGraphNode();
+    if (!parentNode)
+        return;
+    fetchNode(parentNode);
+    if (!m_childParentMap.contains(parentNode))
+        return; // not part of our tree
+
+    const auto parentIndex = indexForNode(parentNode);
+    while (!m_childParentMap.contains(node) && canFetchMore(parentIndex))
+        fetchMore(parentIndex);
 }
 
 QVariant FrameGraphModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid())
+    if (!index.isValid() || !m_settings)
         return QVariant();
 
     auto node = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(index.internalPointer());
@@ -102,6 +136,16 @@ QVariant FrameGraphModel::data(const QModelIndex &index, int role) const
     return dataForObject(node, index, role);
 }
 
+int FrameGraphModel::rowCount(const QModelIndex &parent) const
+{
+    if (!m_settings || parent.column() > 0)
+        return 0;
+
+    auto parentNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(parent.internalPointer());
+    const auto it = m_parentChildMap.constFind(parentNode);
+    return it == m_parentChildMap.constEnd() ? 0 : it.value().size();
+}
+
 QModelIndex FrameGraphModel::parent(const QModelIndex &child) const
 {
     auto childNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(child.internalPointer());
@@ -111,10 +155,46 @@ QModelIndex FrameGraphModel::parent(const QModelIndex &child) const
 QModelIndex FrameGraphModel::index(int row, int column, const QModelIndex &parent) const
 {
     auto parentNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(parent.internalPointer());
-    const auto children = m_parentChildMap.value(parentNode);
-    if (row < 0 || column < 0 || row >= children.size() || column >= columnCount())
+    const auto it = m_parentChildMap.constFind(parentNode);
+    if (it == m_parentChildMap.constEnd() || row < 0 || column < 0 || row >= it.value().size() || column >= columnCount())
         return QModelIndex();
-    return createIndex(row, column, children.at(row));
+    return createIndex(row, column, it.value().at(row));
+}
+
+bool FrameGraphModel::hasChildren(const QModelIndex &parent) const
+{
+    if (rowCount(parent) > 0)
+        return true;
+    return canFetchMore(parent);
+}
+
+bool FrameGraphModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!m_settings || parent.column() > 0)
+        return false;
+
+    auto parentNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(parent.internalPointer());
+    if (parentNode)
+        populateChildren(parentNode);
+    return m_pendingChildren.contains(parentNode);
+}
+
+void FrameGraphModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    auto parentNode = reinterpret_cast<Qt3DRender::QFrameGraphNode *>(parent.internalPointer());
+    auto it = m_pendingChildren.find(parentNode);
+    auto &pending = it.value();
+    const int count = std::min(pending.size(), FetchChunkSize);
+    const auto chunk = pending.mid(0, count);
+    pending.remove(0, count);
+    if (pending.isEmpty()) {
+        m_pendingChildren.erase(it);
+        m_dirtyParents.remove(parentNode);
+    }
+    insertNodes(parentNode, chunk);
 }
 
 Qt::ItemFlags FrameGraphModel::flags(const QModelIndex &index) const
@@ -141,66 +221,97 @@ QModelIndex FrameGraphModel::indexForNode(Qt3DRender::QFrameGraphNode *node) con
     if (!node)
         return QModelIndex();
 
-    auto parent = m_childParentMap.value(node);
-    const auto parentIndex = indexForNode(parent);
-    if (!parentIndex.isValid() && parent)
-        return QModelIndex();
-
-    const auto &siblings = m_parentChildMap[parent];
-    auto it = std::lower_bound(siblings.constBegin(), siblings.constEnd(), node);
-    if (it == siblings.constEnd() || *it != node)
+    const auto it = m_childRowMap.constFind(node);
+    if (it == m_childRowMap.constEnd())
         return QModelIndex();
-
-    const int row = std::distance(siblings.constBegin(), it);
-    return index(row, 0, parentIndex);
+    return createIndex(it.value(), 0, node);
 }
 
-static bool isRenderSettingsForNode(Qt3DRender::QRenderSettings *settings, Qt3DRender::QFrameGraphNode *node)
+void FrameGraphModel::updateRows(Qt3DRender::QFrameGraphNode *parentNode, int firstRow)
 {
-    Q_ASSERT(settings);
-    Q_ASSERT(node);
-    if (node == settings->activeFrameGraph())
-        return true;
-    if (!node->parentFrameGraphNode())
-        return false;
-    return isRenderSettingsForNode(settings, node->parentFrameGraphNode());
+    const auto children = m_parentChildMap.value(parentNode);
+    for (int row = firstRow; row < children.size(); ++row)
+        m_childRowMap[children.at(row)] = row;
 }
 
 void FrameGraphModel::objectCreated(QObject *obj)
 {
-    auto node = qobject_cast<Qt3DRender::QFrameGraphNode*>(obj);
-    if (!node || !m_settings)
+    if (!m_settings)
         return;
 
-    if (!isRenderSettingsForNode(m_settings, node))
+    auto node = qobject_cast<Qt3DRender::QFrameGraphNode *>(obj);
+    if (!node || isKnown(node))
         return;
 
-    if (m_childParentMap.contains(node))
+    // walk up to the closest node we know, usually that's the direct parent
+    // if it isn't, the topmost unknown ancestor is added and its subtree (including
+    // this node) is picked up when that gets populated
+    auto parentNode = node->parentFrameGraphNode();
+    while (parentNode && !isKnown(parentNode)) {
+        node = parentNode;
+        parentNode = parentNode->parentFrameGraphNode();
+    }
+    if (!parentNode)
+        return; // not part of our tree
+
+    enqueueNode(parentNode, node);
+}
+
+void FrameGraphModel::enqueueNode(Qt3DRender::QFrameGraphNode *parentNode, Qt3DRender::QFrameGraphNode *node)
+{
+    // children of a parent that isn't populated yet are found when it gets populated
+    if (!m_childParentMap.contains(parentNode) || m_unpopulated.contains(parentNode))
         return;
 
-    auto parentNode = node->parentFrameGraphNode();
-    if (parentNode) {
-        // add parent first, if we don't know that yet
-        if (!m_childParentMap.contains(parentNode)) {
-            objectCreated(parentNode);
-            return;
-        }
+    auto &pending = m_pendingChildren[parentNode];
+    if (pending.isEmpty()) {
+        m_dirtyParents.insert(parentNode);
+        m_insertTimer->start();
     }
+    pending.push_back(node);
+    m_pendingParentMap.insert(node, parentNode);
+}
 
-    const auto index = indexForNode(parentNode);
-    Q_ASSERT(index.isValid() || !parentNode);
+void FrameGraphModel::removePendingNode(Qt3DRender::QFrameGraphNode *node)
+{
+    auto parentNode = m_pendingParentMap.take(node);
+    auto it = m_pendingChildren.find(parentNode);
+    if (it == m_pendingChildren.end())
+        return;
+    it.value().removeOne(node);
+    if (it.value().isEmpty()) {
+        m_pendingChildren.erase(it);
+        m_dirtyParents.remove(parentNode);
+    }
+}
 
-    auto &children = m_parentChildMap[parentNode];
-    auto it = std::lower_bound(children.begin(), children.end(), node);
-    const int row = std::distance(children.begin(), it);
+void FrameGraphModel::insertPendingNodes()
+{
+    const auto parents = m_dirtyParents;
+    m_dirtyParents.clear();
+    for (auto parentNode : parents)
+        insertNodes(parentNode, m_pendingChildren.take(parentNode));
+}
 
-    beginInsertRows(index, row, row);
-    children.insert(it, node);
-    m_childParentMap.insert(node, parentNode);
-    connectNode(node);
-    foreach (auto child, node->childNodes()) {
-        if (auto childNode = qobject_cast<Qt3DRender::QFrameGraphNode *>(child))
-            populateFromNode(childNode);
+void FrameGraphModel::insertNodes(Qt3DRender::QFrameGraphNode *parentNode, const QVector<Qt3DRender::QFrameGraphNode *> &nodes)
+{
+    if (nodes.isEmpty())
+        return;
+
+    const auto parentIndex = indexForNode(parentNode);
+    Q_ASSERT(parentIndex.isValid() || !parentNode);
+
+    auto &children = m_parentChildMap[parentNode];
+    const int first = children.size();
+    beginInsertRows(parentIndex, first, first + nodes.size() - 1);
+    children.reserve(first + nodes.size());
+    for (auto node : nodes) {
+        m_pendingParentMap.remove(node);
+        m_childRowMap.insert(node, children.size());
+        children.push_back(node);
+        m_childParentMap.insert(node, parentNode);
+        m_unpopulated.insert(node);
+        connectNode(node);
     }
     endInsertRows();
 }
@@ -208,6 +319,10 @@ void FrameGraphModel::objectCreated(QObject *obj)
 void FrameGraphModel::objectDestroyed(QObject *obj)
 {
     auto node = static_cast<Qt3DRender::QFrameGraphNode*>(obj); // never dereference this!
+    if (m_pendingParentMap.contains(node)) {
+        removePendingNode(node);
+        return;
+    }
     if (!m_childParentMap.contains(node)) {
         Q_ASSERT(!m_parentChildMap.contains(node));
         return;
@@ -218,51 +333,89 @@ void FrameGraphModel::objectDestroyed(QObject *obj)
 
 void FrameGraphModel::removeNode(Qt3DRender::QFrameGraphNode *node, bool danglingPointer)
 {
-    if (!danglingPointer)
-        disconnectNode(node);
-
     auto parentNode = m_childParentMap.value(node);
     const QModelIndex parentIndex = indexForNode(parentNode);
     if (parentNode && !parentIndex.isValid())
         return;
 
+    const int row = m_childRowMap.value(node, -1);
     auto &siblings = m_parentChildMap[parentNode];
-    auto it = std::lower_bound(siblings.begin(), siblings.end(), node);
-    if (it == siblings.end() || *it != node)
+    if (row < 0 || row >= siblings.size() || siblings.at(row) != node)
         return;
-    const int row = std::distance(siblings.begin(), it);
 
     beginRemoveRows(parentIndex, row, row);
-    siblings.erase(it);
+    siblings.remove(row);
     removeSubtree(node, danglingPointer);
+    updateRows(parentNode, row);
     endRemoveRows();
 }
 
 void FrameGraphModel::removeSubtree(Qt3DRender::QFrameGraphNode *node, bool danglingPointer)
 {
-    const auto children = m_parentChildMap.value(node);
+    if (!danglingPointer)
+        disconnectNode(node);
+    const auto children = m_parentChildMap.take(node);
     for (auto child : children)
         removeSubtree(child, danglingPointer);
+    const auto pending = m_pendingChildren.take(node);
+    for (auto child : pending)
+        m_pendingParentMap.remove(child);
     m_childParentMap.remove(node);
-    m_parentChildMap.remove(node);
+    m_childRowMap.remove(node);
+    m_unpopulated.remove(node);
+    m_dirtyParents.remove(node);
+}
+
+void FrameGraphModel::moveNode(Qt3DRender::QFrameGraphNode *node, Qt3DRender::QFrameGraphNode *newParent)
+{
+    auto oldParent = m_childParentMap.value(node);
+    const int row = m_childRowMap.value(node);
+    const int destRow = m_parentChildMap.value(newParent).size();
+
+    if (!beginMoveRows(indexForNode(oldParent), row, row, indexForNode(newParent), destRow)) {
+        removeNode(node, false);
+        objectCreated(node);
+        return;
+    }
+    m_parentChildMap[oldParent].remove(row);
+    m_parentChildMap[newParent].push_back(node);
+    m_childParentMap.insert(node, newParent);
+    m_childRowMap.insert(node, destRow);
+    updateRows(oldParent, row);
+    endMoveRows();
 }
 
 void FrameGraphModel::objectReparented(QObject *obj)
 {
-    auto node = qobject_cast<Qt3DRender::QFrameGraphNode*>(obj);
-    if (!node)
+    auto node = qobject_cast<Qt3DRender::QFrameGraphNode *>(obj);
+    if (!node || !m_settings)
         return;
 
-    if (m_childParentMap.contains(node)) {
-        if (isRenderSettingsForNode(m_settings, node)) {
-            // TODO reparented inside our tree
-        } else {
-            // moved to outside of our tree
-            removeNode(node, false);
-        }
-    } else {
+    if (m_pendingParentMap.contains(node)) {
+        // not visible yet, just queue it again at its new place
+        removePendingNode(node);
+        objectCreated(obj);
+        return;
+    }
+
+    if (!m_childParentMap.contains(node)) {
         // possibly reparented into our tree
         objectCreated(obj);
+        return;
+    }
+
+    auto oldParent = m_childParentMap.value(node);
+    auto newParent = node->parentFrameGraphNode();
+    if (!oldParent || newParent == oldParent)
+        return; // root node, or a change of intermediate non-frame graph nodes
+
+    if (m_childParentMap.contains(newParent) && !m_unpopulated.contains(newParent)) {
+        // reparented within our tree
+        moveNode(node, newParent);
+    } else {
+        // moved out of our tree, or below a part of it that isn't populated yet
+        removeNode(node, false);
+        objectCreated(obj);
     }
 }
 
@@ -33,9 +33,12 @@
 
 #include <QAbstractListModel>
 #include <QHash>
+#include <QSet>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
+class QTimer;
+
 namespace Qt3DRender {
 class QFrameGraphNode;
 class QRenderSettings;
@@ -43,6 +46,9 @@ class QRenderSettings;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+/** Model for the active frame graph of a QRenderSettings.
+ *  Populated lazily the same way as Qt3DEntityTreeModel.
+ */
 class FrameGraphModel : public ObjectModelBase<QAbstractItemModel>
 {
     Q_OBJECT
@@ -51,11 +57,16 @@ public:
     ~FrameGraphModel();
 
     void setRenderSettings(Qt3DRender::QRenderSettings *settings);
+    /** Populates the model down to @p node, if that belongs to it. */
+    void fetchNode(Qt3DRender::QFrameGraphNode *node);
 
     QVariant data(const QModelIndex &index, int role) const override;
     int rowCount(const QModelIndex &parent) const override;
     QModelIndex parent(const QModelIndex &child) const override;
     QModelIndex index(int row, int column, const QModelIndex &parent) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
@@ -66,9 +77,16 @@ public slots:
 
 private:
     void clear();
-    void populateFromNode(Qt3DRender::QFrameGraphNode *node);
+    void populateChildren(Qt3DRender::QFrameGraphNode *node) const;
+    bool isKnown(Qt3DRender::QFrameGraphNode *node) const;
+    void enqueueNode(Qt3DRender::QFrameGraphNode *parentNode, Qt3DRender::QFrameGraphNode *node);
+    void removePendingNode(Qt3DRender::QFrameGraphNode *node);
+    void insertPendingNodes();
+    void insertNodes(Qt3DRender::QFrameGraphNode *parentNode, const QVector<Qt3DRender::QFrameGraphNode *> &nodes);
+    void moveNode(Qt3DRender::QFrameGraphNode *node, Qt3DRender::QFrameGraphNode *newParent);
     void removeNode(Qt3DRender::QFrameGraphNode *node, bool danglingPointer);
     void removeSubtree(Qt3DRender::QFrameGraphNode *node, bool danglingPointer);
+    void updateRows(Qt3DRender::QFrameGraphNode *parentNode, int firstRow);
     QModelIndex indexForNode(Qt3DRender::QFrameGraphNode *node) const;
 
     void connectNode(Qt3DRender::QFrameGraphNode *node);
@@ -77,8 +95,20 @@ private:
 
 private:
     Qt3DRender::QRenderSettings *m_settings;
+    QTimer *m_insertTimer;
+
+    // nodes present in the model, the frame graph root is the only child of nullptr
     QHash<Qt3DRender::QFrameGraphNode *, Qt3DRender::QFrameGraphNode *> m_childParentMap;
     QHash<Qt3DRender::QFrameGraphNode *, QVector<Qt3DRender::QFrameGraphNode *> > m_parentChildMap;
+    QHash<Qt3DRender::QFrameGraphNode *, int> m_childRowMap;
+
+    // nodes whose children have not been looked at yet
+    mutable QSet<Qt3DRender::QFrameGraphNode *> m_unpopulated;
+    // known child nodes not yet inserted into the model
+    mutable QHash<Qt3DRender::QFrameGraphNode *, QVector<Qt3DRender::QFrameGraphNode *> > m_pendingChildren;
+    mutable QHash<Qt3DRender::QFrameGraphNode *, Qt3DRender::QFrameGraphNode *> m_pendingParentMap;
+    // parents of nodes created at runtime, inserted with the next batch
+    QSet<Qt3DRender::QFrameGraphNode *> m_dirtyParents;
 };
 }
 
@@ -0,0 +1,573 @@
+/*
+  framestatisticsmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "framestatisticsmodel.h"
+
+#include <core/probeguard.h>
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <Qt3DCore/QAspectEngine>
+#include <Qt3DCore/QComponent>
+#include <Qt3DCore/QEntity>
+#include <Qt3DLogic/QFrameAction>
+#include <Qt3DLogic/QLogicAspect>
+#include <Qt3DRender/QAbstractTexture>
+#include <Qt3DRender/QBuffer>
+#include <Qt3DRender/QFrameGraphNode>
+#include <Qt3DRender/QGeometryRenderer>
+#include <Qt3DRender/QLayer>
+#include <Qt3DRender/QLayerFilter>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QNoDraw>
+#include <Qt3DRender/QRenderSettings>
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
+
+#include <algorithm>
+#include <limits>
+
+using namespace GammaRay;
+
+static const quintptr TopLevelId = std::numeric_limits<quintptr>::max();
+
+template<typename F>
+static void forEachChildEntity(Qt3DCore::QNode *node, F func)
+{
+    // the entity tree can have intermediate nodes
+    foreach (auto child, node->childNodes()) {
+        if (auto entity = qobject_cast<Qt3DCore::QEntity *>(child))
+            func(entity);
+        else
+            forEachChildEntity(child, func);
+    }
+}
+
+static bool acceptsLayers(Qt3DRender::QLayerFilter *filter, const QVector<Qt3DRender::QLayer *> &layers)
+{
+    const auto filterLayers = filter->layers();
+    if (filterLayers.isEmpty())
+        return true;
+
+    const auto matches = std::count_if(filterLayers.begin(), filterLayers.end(), [&layers](Qt3DRender::QLayer *layer) {
+        return layers.contains(layer);
+    });
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    switch (filter->filterMode()) {
+    case Qt3DRender::QLayerFilter::AcceptAnyMatchingLayers:
+        return matches > 0;
+    case Qt3DRender::QLayerFilter::AcceptAllMatchingLayers:
+        return matches == filterLayers.size();
+    case Qt3DRender::QLayerFilter::DiscardAnyMatchingLayers:
+        return matches == 0;
+    case Qt3DRender::QLayerFilter::DiscardAllMatchingLayers:
+        return matches < filterLayers.size();
+    }
+#endif
+    return matches > 0;
+}
+
+FrameStatisticsModel::FrameStatisticsModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_enabled(false)
+    , m_frameTimer(new QTimer(this))
+    , m_flushTimer(new QTimer(this))
+    , m_nextFrame(0)
+    , m_sceneDirty(true)
+    , m_firstFrame(0)
+    , m_frameCount(0)
+{
+    m_frames.resize(FrameHistorySize);
+
+    connect(m_frameTimer, &QTimer::timeout, this, &FrameStatisticsModel::frameTick);
+    m_flushTimer->setInterval(250);
+    connect(m_flushTimer, &QTimer::timeout, this, &FrameStatisticsModel::flushPendingFrames);
+}
+
+FrameStatisticsModel::~FrameStatisticsModel()
+{
+    stop();
+}
+
+void FrameStatisticsModel::setEngine(Qt3DCore::QAspectEngine *engine)
+{
+    if (m_engine == engine)
+        return;
+    stop();
+    m_engine = engine;
+    m_settings = nullptr;
+    auto root = engine ? engine->rootEntity().data() : nullptr;
+    if (root) {
+        foreach (auto component, root->components()) {
+            if (auto settings = qobject_cast<Qt3DRender::QRenderSettings *>(component)) {
+                m_settings = settings;
+                break;
+            }
+        }
+    }
+    clear();
+    start();
+}
+
+void FrameStatisticsModel::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    stop();
+    m_enabled = enabled;
+    clear();
+    start();
+}
+
+void FrameStatisticsModel::start()
+{
+    if (!m_enabled || !m_engine || !m_engine->rootEntity())
+        return;
+
+    auto root = m_engine->rootEntity().data();
+    trackSubtree(root);
+    if (m_settings) {
+        m_connections.push_back(connect(m_settings.data(), &Qt3DRender::QRenderSettings::activeFrameGraphChanged,
+                                        this, &FrameStatisticsModel::markSceneDirty));
+    }
+    markSceneDirty();
+
+    bool hasLogicAspect = false;
+    foreach (auto aspect, m_engine->aspects())
+        hasLogicAspect |= qobject_cast<Qt3DLogic::QLogicAspect *>(aspect) != nullptr;
+
+    if (hasLogicAspect) {
+        // the frame action is part of the scene while we are recording, but not visible
+        // in our object models
+        ProbeGuard guard;
+        m_frameAction = new Qt3DLogic::QFrameAction(root);
+        root->addComponent(m_frameAction);
+        connect(m_frameAction, &Qt3DLogic::QFrameAction::triggered, this, &FrameStatisticsModel::frameTick);
+    } else {
+        const auto screen = QGuiApplication::primaryScreen();
+        const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60.0;
+        m_frameTimer->setInterval(qRound(1000.0 / refreshRate));
+        m_frameTimer->start();
+    }
+
+    m_current = FrameStatistics();
+    m_frameElapsed.start();
+    m_flushTimer->start();
+}
+
+void FrameStatisticsModel::stop()
+{
+    for (const auto &connection : qAsConst(m_connections))
+        disconnect(connection);
+    m_connections.clear();
+
+    if (m_frameAction) {
+        ProbeGuard guard;
+        if (auto entity = qobject_cast<Qt3DCore::QEntity *>(m_frameAction->parent()))
+            entity->removeComponent(m_frameAction);
+        delete m_frameAction;
+    }
+    m_frameTimer->stop();
+    m_flushTimer->stop();
+    flushPendingFrames();
+    m_sceneNodes.clear();
+    m_drawables.clear();
+    m_sceneEstimate = FrameStatistics();
+    m_sceneDirty = true;
+}
+
+void FrameStatisticsModel::clear()
+{
+    m_pendingFrames.clear();
+    m_nextFrame = 0;
+    if (m_frameCount == 0)
+        return;
+
+    beginResetModel();
+    std::fill(m_frames.begin(), m_frames.end(), FrameStatistics());
+    m_firstFrame = 0;
+    m_frameCount = 0;
+    endResetModel();
+}
+
+void FrameStatisticsModel::objectCreated(QObject *obj)
+{
+    if (!m_enabled || !m_engine || !m_engine->rootEntity())
+        return;
+    auto node = qobject_cast<Qt3DCore::QNode *>(obj);
+    if (!node || m_sceneNodes.contains(node) || !isInScene(node))
+        return;
+
+    trackNode(node);
+    markSceneDirty();
+}
+
+void FrameStatisticsModel::objectDestroyed(QObject *obj)
+{
+    if (m_sceneNodes.remove(obj))
+        markSceneDirty();
+}
+
+void FrameStatisticsModel::objectReparented(QObject *obj)
+{
+    if (m_sceneNodes.contains(obj))
+        markSceneDirty(); // moved within the scene or out of it, both change the estimates
+    else
+        objectCreated(obj);
+}
+
+bool FrameStatisticsModel::isInScene(Qt3DCore::QNode *node) const
+{
+    auto root = m_engine->rootEntity().data();
+    for (auto parentNode = node->parentNode(); parentNode; parentNode = parentNode->parentNode()) {
+        if (parentNode == root)
+            return true;
+    }
+    return false;
+}
+
+void FrameStatisticsModel::markSceneDirty()
+{
+    m_sceneDirty = true;
+}
+
+void FrameStatisticsModel::trackSubtree(Qt3DCore::QNode *node)
+{
+    trackNode(node);
+    foreach (auto child, node->childNodes())
+        trackSubtree(child);
+}
+
+void FrameStatisticsModel::trackNode(Qt3DCore::QNode *node)
+{
+    m_sceneNodes.insert(node);
+    m_connections.push_back(connect(node, &Qt3DCore::QNode::enabledChanged, this, &FrameStatisticsModel::markSceneDirty));
+    if (auto component = qobject_cast<Qt3DCore::QComponent *>(node)) {
+        m_connections.push_back(connect(component, &Qt3DCore::QComponent::addedToEntity,
+                                        this, &FrameStatisticsModel::markSceneDirty));
+        m_connections.push_back(connect(component, &Qt3DCore::QComponent::removedFromEntity,
+                                        this, &FrameStatisticsModel::markSceneDirty));
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    if (auto layer = qobject_cast<Qt3DRender::QLayer *>(node)) {
+        m_connections.push_back(connect(layer, &Qt3DRender::QLayer::recursiveChanged,
+                                        this, &FrameStatisticsModel::markSceneDirty));
+    } else if (auto filter = qobject_cast<Qt3DRender::QLayerFilter *>(node)) {
+        m_connections.push_back(connect(filter, &Qt3DRender::QLayerFilter::filterModeChanged,
+                                        this, &FrameStatisticsModel::markSceneDirty));
+    }
+#endif
+
+    if (auto buffer = qobject_cast<Qt3DRender::QBuffer *>(node)) {
+        m_connections.push_back(connect(buffer, &Qt3DRender::QBuffer::dataChanged, this, [this](const QByteArray &data) {
+            m_current.bufferUploadBytes += data.size();
+            ++m_current.bufferUploads;
+        }));
+    } else if (auto texture = qobject_cast<Qt3DRender::QAbstractTexture *>(node)) {
+        // assumes 32bit texels, the frontend doesn't know about the actual upload format
+        m_connections.push_back(connect(texture, &Qt3DRender::QAbstractTexture::statusChanged, this,
+                                        [this, texture](Qt3DRender::QAbstractTexture::Status status) {
+            if (status != Qt3DRender::QAbstractTexture::Ready)
+                return;
+            m_current.textureUploadBytes += qint64(texture->width()) * texture->height()
+                                            * std::max(texture->depth(), 1) * std::max(texture->layers(), 1) * 4;
+            ++m_current.textureUploads;
+        }));
+    }
+}
+
+void FrameStatisticsModel::frameTick()
+{
+    if (!m_engine || !m_engine->rootEntity())
+        return;
+
+    m_current.frame = m_nextFrame++;
+    m_current.interval = m_frameElapsed.nsecsElapsed() / 1000;
+    m_frameElapsed.restart();
+
+    if (m_sceneDirty)
+        updateSceneEstimate();
+    // the leaves are shared between all frames recorded with the same scene
+    m_current.entities = m_sceneEstimate.entities;
+    m_current.commands = m_sceneEstimate.commands;
+    m_current.leaves = m_sceneEstimate.leaves;
+
+    m_pendingFrames.push_back(m_current);
+    m_current = FrameStatistics();
+}
+
+void FrameStatisticsModel::updateSceneEstimate()
+{
+    m_sceneDirty = false;
+    m_sceneEstimate = FrameStatistics();
+
+    m_drawables.clear();
+    collectDrawables(m_engine->rootEntity().data(), QVector<Qt3DRender::QLayer *>());
+    m_sceneEstimate.entities = m_drawables.size();
+
+    if (m_settings && m_settings->activeFrameGraph()) {
+        QVector<Qt3DRender::QFrameGraphNode *> path;
+        collectLeaves(m_settings->activeFrameGraph(), path, m_sceneEstimate);
+    }
+}
+
+void FrameStatisticsModel::collectDrawables(Qt3DCore::QEntity *entity, QVector<Qt3DRender::QLayer *> inheritedLayers)
+{
+    if (!entity->isEnabled())
+        return;
+
+    auto layers = inheritedLayers;
+    bool hasGeometry = false;
+    bool hasMaterial = false;
+    foreach (auto component, entity->components()) {
+        if (!component->isEnabled())
+            continue;
+        if (qobject_cast<Qt3DRender::QGeometryRenderer *>(component)) {
+            hasGeometry = true;
+        } else if (qobject_cast<Qt3DRender::QMaterial *>(component)) {
+            hasMaterial = true;
+        } else if (auto layer = qobject_cast<Qt3DRender::QLayer *>(component)) {
+            layers.push_back(layer);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+            if (layer->recursive())
+                inheritedLayers.push_back(layer);
+#endif
+        }
+    }
+    if (hasGeometry && hasMaterial) {
+        Drawable drawable;
+        drawable.layers = layers;
+        m_drawables.push_back(drawable);
+    }
+
+    forEachChildEntity(entity, [this, &inheritedLayers](Qt3DCore::QEntity *child) {
+        collectDrawables(child, inheritedLayers);
+    });
+}
+
+void FrameStatisticsModel::collectLeaves(Qt3DRender::QFrameGraphNode *node,
+                                         QVector<Qt3DRender::QFrameGraphNode *> &path,
+                                         FrameStatistics &stats) const
+{
+    // disabled nodes are skipped including their sub-tree, same as the backend does it
+    if (!node->isEnabled())
+        return;
+
+    path.push_back(node);
+    bool isLeaf = true;
+    foreach (auto child, node->childNodes()) {
+        if (auto childNode = qobject_cast<Qt3DRender::QFrameGraphNode *>(child)) {
+            isLeaf = false;
+            collectLeaves(childNode, path, stats);
+        }
+    }
+    if (isLeaf) {
+        // every leaf results in one render view
+        LeafStatistics leaf;
+        leaf.name = Util::shortDisplayString(node);
+        leaf.commands = commandsForPath(path);
+        stats.commands += leaf.commands;
+        stats.leaves.push_back(leaf);
+    }
+    path.pop_back();
+}
+
+int FrameStatisticsModel::commandsForPath(const QVector<Qt3DRender::QFrameGraphNode *> &path) const
+{
+    QVector<Qt3DRender::QLayerFilter *> filters;
+    for (auto node : path) {
+        if (qobject_cast<Qt3DRender::QNoDraw *>(node))
+            return 0;
+        if (auto filter = qobject_cast<Qt3DRender::QLayerFilter *>(node))
+            filters.push_back(filter);
+    }
+    if (filters.isEmpty())
+        return m_drawables.size();
+
+    return static_cast<int>(std::count_if(m_drawables.constBegin(), m_drawables.constEnd(), [&filters](const Drawable &drawable) {
+        return std::all_of(filters.constBegin(), filters.constEnd(), [&drawable](Qt3DRender::QLayerFilter *filter) {
+            return acceptsLayers(filter, drawable.layers);
+        });
+    }));
+}
+
+void FrameStatisticsModel::flushPendingFrames()
+{
+    if (m_pendingFrames.isEmpty())
+        return;
+
+    if (m_pendingFrames.size() > FrameHistorySize)
+        m_pendingFrames.remove(0, m_pendingFrames.size() - FrameHistorySize);
+
+    const int drop = m_frameCount + m_pendingFrames.size() - FrameHistorySize;
+    if (drop > 0) {
+        beginRemoveRows(QModelIndex(), 0, drop - 1);
+        m_firstFrame = (m_firstFrame + drop) % FrameHistorySize;
+        m_frameCount -= drop;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_frameCount, m_frameCount + m_pendingFrames.size() - 1);
+    for (const auto &frame : qAsConst(m_pendingFrames)) {
+        m_frames[(m_firstFrame + m_frameCount) % FrameHistorySize] = frame;
+        ++m_frameCount;
+    }
+    endInsertRows();
+    m_pendingFrames.clear();
+}
+
+const FrameStatisticsModel::FrameStatistics &FrameStatisticsModel::frameAt(int row) const
+{
+    return m_frames.at((m_firstFrame + row) % FrameHistorySize);
+}
+
+int FrameStatisticsModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int FrameStatisticsModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_frameCount;
+    if (parent.internalId() != TopLevelId || parent.column() != 0)
+        return 0;
+    return frameAt(parent.row()).leaves.size();
+}
+
+QModelIndex FrameStatisticsModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount)
+        return QModelIndex();
+
+    if (!parent.isValid()) {
+        if (row >= m_frameCount)
+            return QModelIndex();
+        return createIndex(row, column, TopLevelId);
+    }
+
+    if (parent.internalId() != TopLevelId)
+        return QModelIndex();
+    // children refer to their frame by number, rows shift when old frames are dropped
+    const auto &frame = frameAt(parent.row());
+    if (row >= frame.leaves.size())
+        return QModelIndex();
+    return createIndex(row, column, quintptr(frame.frame));
+}
+
+QModelIndex FrameStatisticsModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == TopLevelId || m_frameCount == 0)
+        return QModelIndex();
+
+    // frame numbers in the buffer are consecutive
+    const auto row = qint64(child.internalId()) - qint64(frameAt(0).frame);
+    if (row < 0 || row >= m_frameCount)
+        return QModelIndex();
+    return createIndex(int(row), 0, TopLevelId);
+}
+
+QVariant FrameStatisticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (index.internalId() != TopLevelId) {
+        const auto parentIndex = parent(index);
+        if (!parentIndex.isValid())
+            return QVariant();
+        const auto &frame = frameAt(parentIndex.row());
+        const auto &leaf = frame.leaves.at(index.row());
+        if (role == Qt::DisplayRole) {
+            switch (index.column()) {
+            case FrameColumn:
+                return leaf.name;
+            case RenderViewsColumn:
+                return 1;
+            case CommandsColumn:
+                return leaf.commands;
+            }
+        }
+        return QVariant();
+    }
+
+    const auto &frame = frameAt(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case FrameColumn:
+            return frame.frame;
+        case IntervalColumn:
+            return Util::usecsToMSecs(frame.interval);
+        case EntitiesColumn:
+            return frame.entities;
+        case RenderViewsColumn:
+            return frame.leaves.size();
+        case CommandsColumn:
+            return frame.commands;
+        case BufferUploadColumn:
+            return frame.bufferUploadBytes;
+        case TextureUploadColumn:
+            return frame.textureUploadBytes;
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (index.column()) {
+        case BufferUploadColumn:
+            return tr("%n buffer update(s)", "", frame.bufferUploads);
+        case TextureUploadColumn:
+            return tr("%n texture upload(s)", "", frame.textureUploads);
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant FrameStatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case FrameColumn:
+            return tr("Frame");
+        case IntervalColumn:
+            return tr("Interval [ms]");
+        case EntitiesColumn:
+            return tr("Entities");
+        case RenderViewsColumn:
+            return tr("Render Views");
+        case CommandsColumn:
+            return tr("Commands");
+        case BufferUploadColumn:
+            return tr("Buffer Uploads [B]");
+        case TextureUploadColumn:
+            return tr("Texture Uploads [B]");
+        }
+    }
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
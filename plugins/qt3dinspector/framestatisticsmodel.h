@@ -0,0 +1,174 @@
+/*
+  framestatisticsmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_FRAMESTATISTICSMODEL_H
+#define GAMMARAY_FRAMESTATISTICSMODEL_H
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+namespace Qt3DCore {
+class QAspectEngine;
+class QEntity;
+class QNode;
+}
+namespace Qt3DLogic {
+class QFrameAction;
+}
+namespace Qt3DRender {
+class QFrameGraphNode;
+class QLayer;
+class QRenderSettings;
+}
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/**
+ * Per-frame statistics of an QAspectEngine, for the most recent FrameHistorySize frames.
+ *
+ * Top-level rows are frames, their children the leaves of the active frame graph.
+ * Everything is derived from the frontend scene, so this works independently of
+ * the render surface (including offscreen ones). Rendered entities and render commands
+ * are estimated from enabled geometry renderers and layer filters, the backend only
+ * culls further. These estimates are only recomputed after the scene or the frame
+ * graph changed. Upload volumes are estimated from buffer data changes and textures
+ * becoming ready.
+ *
+ * Frames are delimited by a Qt3DLogic::QFrameAction if the engine has a logic aspect,
+ * otherwise by a timer running at the screen refresh rate.
+ */
+class FrameStatisticsModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        FrameColumn,
+        IntervalColumn,
+        EntitiesColumn,
+        RenderViewsColumn,
+        CommandsColumn,
+        BufferUploadColumn,
+        TextureUploadColumn,
+        ColumnCount
+    };
+
+    enum { FrameHistorySize = 600 };
+
+    explicit FrameStatisticsModel(QObject *parent = nullptr);
+    ~FrameStatisticsModel() override;
+
+    void setEngine(Qt3DCore::QAspectEngine *engine);
+    void setEnabled(bool enabled);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+public slots:
+    void objectCreated(QObject *obj);
+    void objectDestroyed(QObject *obj);
+    void objectReparented(QObject *obj);
+
+private slots:
+    void frameTick();
+    void flushPendingFrames();
+
+private:
+    struct LeafStatistics
+    {
+        QString name;
+        int commands = 0;
+    };
+    struct FrameStatistics
+    {
+        quint64 frame = 0;
+        qint64 interval = -1; // usecs
+        int entities = 0;
+        int commands = 0;
+        qint64 bufferUploadBytes = 0;
+        int bufferUploads = 0;
+        qint64 textureUploadBytes = 0;
+        int textureUploads = 0;
+        QVector<LeafStatistics> leaves;
+    };
+    struct Drawable
+    {
+        QVector<Qt3DRender::QLayer *> layers;
+    };
+
+    void start();
+    void stop();
+    void clear();
+    void trackNode(Qt3DCore::QNode *node);
+    void trackSubtree(Qt3DCore::QNode *node);
+    bool isInScene(Qt3DCore::QNode *node) const;
+    void markSceneDirty();
+    void updateSceneEstimate();
+    void collectDrawables(Qt3DCore::QEntity *entity, QVector<Qt3DRender::QLayer *> inheritedLayers);
+    void collectLeaves(Qt3DRender::QFrameGraphNode *node, QVector<Qt3DRender::QFrameGraphNode *> &path,
+                       FrameStatistics &stats) const;
+    int commandsForPath(const QVector<Qt3DRender::QFrameGraphNode *> &path) const;
+    const FrameStatistics &frameAt(int row) const;
+
+    QPointer<Qt3DCore::QAspectEngine> m_engine;
+    QPointer<Qt3DRender::QRenderSettings> m_settings;
+    bool m_enabled;
+
+    QPointer<Qt3DLogic::QFrameAction> m_frameAction;
+    QTimer *m_frameTimer;
+    QTimer *m_flushTimer;
+    QElapsedTimer m_frameElapsed;
+    QVector<QMetaObject::Connection> m_connections;
+
+    // recorded since the last frame tick
+    FrameStatistics m_current;
+    quint64 m_nextFrame;
+
+    // estimates derived from the scene, see updateSceneEstimate()
+    QSet<QObject *> m_sceneNodes;
+    bool m_sceneDirty;
+    QVector<Drawable> m_drawables;
+    FrameStatistics m_sceneEstimate;
+
+    // ring buffer of the recorded frames, m_frames[m_firstFrame] is the oldest
+    QVector<FrameStatistics> m_frames;
+    int m_firstFrame;
+    int m_frameCount;
+    QVector<FrameStatistics> m_pendingFrames;
+};
+}
+
+#endif // GAMMARAY_FRAMESTATISTICSMODEL_H
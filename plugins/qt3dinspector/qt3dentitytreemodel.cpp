@@ -31,14 +31,22 @@
 #include <Qt3DCore/QAspectEngine>
 #include <Qt3DCore/QEntity>
 
+#include <QTimer>
+
 #include <algorithm>
 
 using namespace GammaRay;
 
+static const int FetchChunkSize = 256;
+
 Qt3DEntityTreeModel::Qt3DEntityTreeModel(QObject *parent)
     : ObjectModelBase<QAbstractItemModel>(parent)
     , m_engine(nullptr)
+    , m_insertTimer(new QTimer(this))
 {
+    m_insertTimer->setSingleShot(true);
+    m_insertTimer->setInterval(0);
+    connect(m_insertTimer, &QTimer::timeout, this, &Qt3DEntityTreeModel::insertPendingEntities);
 }
 
 Qt3DEntityTreeModel::~Qt3DEntityTreeModel()
@@ -50,7 +58,15 @@ void Qt3DEntityTreeModel::setEngine(Qt3DCore::QAspectEngine *engine)
     beginResetModel();
     clear();
     m_engine = engine;
-    populateFromEntity(engine->rootEntity().data());
+    // only the root entity is added here, everything below it is populated on demand
+    auto root = engine ? engine->rootEntity().data() : nullptr;
+    if (root) {
+        m_parentChildMap[nullptr].push_back(root);
+        m_childParentMap.insert(root, nullptr);
+        m_childRowMap.insert(root, 0);
+        m_unpopulated.insert(root);
+        connectEntity(root);
+    }
     endResetModel();
 }
 
@@ -58,38 +74,61 @@ void Qt3DEntityTreeModel::clear()
 {
     for (auto it = m_childParentMap.constBegin(); it != m_childParentMap.constEnd(); ++it)
         disconnectEntity(it.key());
+    m_insertTimer->stop();
     m_childParentMap.clear();
     m_parentChildMap.clear();
+    m_childRowMap.clear();
+    m_unpopulated.clear();
+    m_pendingChildren.clear();
+    m_pendingParentMap.clear();
+    m_dirtyParents.clear();
 }
 
-void Qt3DEntityTreeModel::populateFromNode(Qt3DCore::QNode *node)
+void Qt3DEntityTreeModel::populateChildren(Qt3DCore::QEntity *entity) const
+{
+    if (!m_unpopulated.remove(entity))
+        return;
+    foreach (auto child, entity->childNodes())
+        collectChildEntities(entity, child);
+}
+
+void Qt3DEntityTreeModel::collectChildEntities(Qt3DCore::QEntity *parentEntity, Qt3DCore::QNode *node) const
 {
     // the entity tree can have intermediate nodes, so we need to do this
     // recursively without a depth limit
     auto entity = qobject_cast<Qt3DCore::QEntity*>(node);
     if (entity) {
-        populateFromEntity(entity);
+        // can be known already if reparented but we didn't get notified about that yet
+        if (isKnown(entity))
+            return;
+        m_pendingChildren[parentEntity].push_back(entity);
+        m_pendingParentMap.insert(entity, parentEntity);
     } else {
         foreach (auto child, node->childNodes())
-            populateFromNode(child);
+            collectChildEntities(parentEntity, child);
     }
 }
 
-void Qt3DEntityTreeModel::populateFromEntity(Qt3DCore::QEntity *entity)
+bool Qt3DEntityTreeModel::isKnown(Qt3DCore::QEntity *entity) const
 {
-    if (!entity)
-        return;
+    return m_childParentMap.contains(entity) || m_pendingParentMap.contains(entity);
+}
 
-    m_childParentMap[entity] = entity->parentEntity();
-    m_parentChildMap[entity->parentEntity()].push_back(entity);
-    connectEntity(entity);
+void Qt3DEntityTreeModel::fetchEntity(Qt3DCore::QEntity *entity)
+{
+    if (!m_engine || !entity || m_childParentMap.contains(entity))
+        return;
 
-    foreach (auto child, entity->childNodes()) {
-        populateFromNode(child);
-    }
+    auto parentEntity = entity->parentEntity();
+    if (!parentEntity)
+        return;
+    fetchEntity(parentEntity);
+    if (!m_childParentMap.contains(parentEntity))
+        return; // not part of our tree
 
-    auto &children = m_parentChildMap[entity->parentEntity()];
-    std::sort(children.begin(), children.end());
+    const auto parentIndex = indexForEntity(parentEntity);
+    while (!m_childParentMap.contains(entity) && canFetchMore(parentIndex))
+        fetchMore(parentIndex);
 }
 
 QVariant Qt3DEntityTreeModel::data(const QModelIndex &index, int role) const
@@ -108,11 +147,12 @@ QVariant Qt3DEntityTreeModel::data(const QModelIndex &index, int role) const
 
 int Qt3DEntityTreeModel::rowCount(const QModelIndex &parent) const
 {
-    if (!m_engine || !m_engine->rootEntity())
+    if (!m_engine || parent.column() > 0)
         return 0;
 
     auto parentEntity = reinterpret_cast<Qt3DCore::QEntity *>(parent.internalPointer());
-    return m_parentChildMap.value(parentEntity).size();
+    const auto it = m_parentChildMap.constFind(parentEntity);
+    return it == m_parentChildMap.constEnd() ? 0 : it.value().size();
 }
 
 QModelIndex Qt3DEntityTreeModel::parent(const QModelIndex &child) const
@@ -124,10 +164,46 @@ QModelIndex Qt3DEntityTreeModel::parent(const QModelIndex &child) const
 QModelIndex Qt3DEntityTreeModel::index(int row, int column, const QModelIndex &parent) const
 {
     auto parentEntity = reinterpret_cast<Qt3DCore::QEntity *>(parent.internalPointer());
-    const auto children = m_parentChildMap.value(parentEntity);
-    if (row < 0 || column < 0 || row >= children.size() || column >= columnCount())
+    const auto it = m_parentChildMap.constFind(parentEntity);
+    if (it == m_parentChildMap.constEnd() || row < 0 || column < 0 || row >= it.value().size() || column >= columnCount())
         return QModelIndex();
-    return createIndex(row, column, children.at(row));
+    return createIndex(row, column, it.value().at(row));
+}
+
+bool Qt3DEntityTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (rowCount(parent) > 0)
+        return true;
+    return canFetchMore(parent);
+}
+
+bool Qt3DEntityTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!m_engine || parent.column() > 0)
+        return false;
+
+    auto parentEntity = reinterpret_cast<Qt3DCore::QEntity *>(parent.internalPointer());
+    if (parentEntity)
+        populateChildren(parentEntity);
+    return m_pendingChildren.contains(parentEntity);
+}
+
+void Qt3DEntityTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    auto parentEntity = reinterpret_cast<Qt3DCore::QEntity *>(parent.internalPointer());
+    auto it = m_pendingChildren.find(parentEntity);
+    auto &pending = it.value();
+    const int count = std::min(pending.size(), FetchChunkSize);
+    const auto chunk = pending.mid(0, count);
+    pending.remove(0, count);
+    if (pending.isEmpty()) {
+        m_pendingChildren.erase(it);
+        m_dirtyParents.remove(parentEntity);
+    }
+    insertEntities(parentEntity, chunk);
 }
 
 Qt::ItemFlags Qt3DEntityTreeModel::flags(const QModelIndex &index) const
@@ -154,29 +230,17 @@ QModelIndex Qt3DEntityTreeModel::indexForEntity(Qt3DCore::QEntity *entity) const
     if (!entity)
         return QModelIndex();
 
-    auto parent = m_childParentMap.value(entity);
-    const auto parentIndex = indexForEntity(parent);
-    if (!parentIndex.isValid() && parent)
-        return QModelIndex();
-
-    const auto &siblings = m_parentChildMap[parent];
-    auto it = std::lower_bound(siblings.constBegin(), siblings.constEnd(), entity);
-    if (it == siblings.constEnd() || *it != entity)
+    const auto it = m_childRowMap.constFind(entity);
+    if (it == m_childRowMap.constEnd())
         return QModelIndex();
-
-    const int row = std::distance(siblings.constBegin(), it);
-    return index(row, 0, parentIndex);
+    return createIndex(it.value(), 0, entity);
 }
 
-static bool isEngineForEntity(Qt3DCore::QAspectEngine *engine, Qt3DCore::QEntity *entity)
+void Qt3DEntityTreeModel::updateRows(Qt3DCore::QEntity *parentEntity, int firstRow)
 {
-    Q_ASSERT(engine);
-    Q_ASSERT(entity);
-    if (entity == engine->rootEntity())
-        return true;
-    if (!entity->parentEntity())
-        return false;
-    return isEngineForEntity(engine, entity->parentEntity());
+    const auto children = m_parentChildMap.value(parentEntity);
+    for (int row = firstRow; row < children.size(); ++row)
+        m_childRowMap[children.at(row)] = row;
 }
 
 void Qt3DEntityTreeModel::objectCreated(QObject *obj)
@@ -185,37 +249,78 @@ void Qt3DEntityTreeModel::objectCreated(QObject *obj)
         return;
 
     auto entity = qobject_cast<Qt3DCore::QEntity *>(obj);
-    if (!entity)
+    if (!entity || isKnown(entity))
         return;
 
-    if (!isEngineForEntity(m_engine, entity))
-        return;
+    // walk up to the closest entity we know, usually that's the direct parent
+    // if it isn't, the topmost unknown ancestor is added and its subtree (including
+    // this entity) is picked up when that gets populated
+    auto parentEntity = entity->parentEntity();
+    while (parentEntity && !isKnown(parentEntity)) {
+        entity = parentEntity;
+        parentEntity = parentEntity->parentEntity();
+    }
+    if (!parentEntity)
+        return; // not part of our tree
 
-    if (m_childParentMap.contains(entity))
+    enqueueEntity(parentEntity, entity);
+}
+
+void Qt3DEntityTreeModel::enqueueEntity(Qt3DCore::QEntity *parentEntity, Qt3DCore::QEntity *entity)
+{
+    // children of a parent that isn't populated yet are found when it gets populated
+    if (!m_childParentMap.contains(parentEntity) || m_unpopulated.contains(parentEntity))
         return;
 
-    auto parentEntity = entity->parentEntity();
-    if (parentEntity) {
-        // add parent first, if we don't know that yet
-        if (!m_childParentMap.contains(parentEntity)) {
-            objectCreated(parentEntity);
-            return;
-        }
+    auto &pending = m_pendingChildren[parentEntity];
+    if (pending.isEmpty()) {
+        m_dirtyParents.insert(parentEntity);
+        m_insertTimer->start();
     }
+    pending.push_back(entity);
+    m_pendingParentMap.insert(entity, parentEntity);
+}
 
-    const auto index = indexForEntity(parentEntity);
-    Q_ASSERT(index.isValid() || !parentEntity);
+void Qt3DEntityTreeModel::removePendingEntity(Qt3DCore::QEntity *entity)
+{
+    auto parentEntity = m_pendingParentMap.take(entity);
+    auto it = m_pendingChildren.find(parentEntity);
+    if (it == m_pendingChildren.end())
+        return;
+    it.value().removeOne(entity);
+    if (it.value().isEmpty()) {
+        m_pendingChildren.erase(it);
+        m_dirtyParents.remove(parentEntity);
+    }
+}
+
+void Qt3DEntityTreeModel::insertPendingEntities()
+{
+    const auto parents = m_dirtyParents;
+    m_dirtyParents.clear();
+    for (auto parentEntity : parents)
+        insertEntities(parentEntity, m_pendingChildren.take(parentEntity));
+}
+
+void Qt3DEntityTreeModel::insertEntities(Qt3DCore::QEntity *parentEntity, const QVector<Qt3DCore::QEntity *> &entities)
+{
+    if (entities.isEmpty())
+        return;
+
+    const auto parentIndex = indexForEntity(parentEntity);
+    Q_ASSERT(parentIndex.isValid() || !parentEntity);
 
     auto &children = m_parentChildMap[parentEntity];
-    auto it = std::lower_bound(children.begin(), children.end(), entity);
-    const int row = std::distance(children.begin(), it);
-
-    beginInsertRows(index, row, row);
-    children.insert(it, entity);
-    m_childParentMap.insert(entity, parentEntity);
-    connectEntity(entity);
-    foreach (auto child, entity->childNodes()) {
-        populateFromNode(child);
+    const int first = children.size();
+    beginInsertRows(parentIndex, first, first + entities.size() - 1);
+    children.reserve(first + entities.size());
+    for (auto entity : entities) {
+        m_pendingParentMap.remove(entity);
+        m_childRowMap.insert(entity, children.size());
+        children.push_back(entity);
+        m_childParentMap.insert(entity, parentEntity);
+        m_unpopulated.insert(entity);
+        connectEntity(entity);
     }
     endInsertRows();
 }
@@ -223,6 +328,10 @@ void Qt3DEntityTreeModel::objectCreated(QObject *obj)
 void Qt3DEntityTreeModel::objectDestroyed(QObject *obj)
 {
     auto entity = static_cast<Qt3DCore::QEntity*>(obj); // never dereference this!
+    if (m_pendingParentMap.contains(entity)) {
+        removePendingEntity(entity);
+        return;
+    }
     if (!m_childParentMap.contains(entity)) {
         Q_ASSERT(!m_parentChildMap.contains(entity));
         return;
@@ -238,15 +347,15 @@ void Qt3DEntityTreeModel::removeEntity(Qt3DCore::QEntity *entity, bool danglingP
     if (parentEntity && !parentIndex.isValid())
         return;
 
+    const int row = m_childRowMap.value(entity, -1);
     auto &siblings = m_parentChildMap[parentEntity];
-    auto it = std::lower_bound(siblings.begin(), siblings.end(), entity);
-    if (it == siblings.end() || *it != entity)
+    if (row < 0 || row >= siblings.size() || siblings.at(row) != entity)
         return;
-    const int row = std::distance(siblings.begin(), it);
 
     beginRemoveRows(parentIndex, row, row);
-    siblings.erase(it);
+    siblings.remove(row);
     removeSubtree(entity, danglingPointer);
+    updateRows(parentEntity, row);
     endRemoveRows();
 }
 
@@ -254,29 +363,68 @@ void Qt3DEntityTreeModel::removeSubtree(Qt3DCore::QEntity *entity, bool dangling
 {
     if (!danglingPointer)
         disconnectEntity(entity);
-    const auto children = m_parentChildMap.value(entity);
+    const auto children = m_parentChildMap.take(entity);
     for (auto child : children)
         removeSubtree(child, danglingPointer);
+    const auto pending = m_pendingChildren.take(entity);
+    for (auto child : pending)
+        m_pendingParentMap.remove(child);
     m_childParentMap.remove(entity);
-    m_parentChildMap.remove(entity);
+    m_childRowMap.remove(entity);
+    m_unpopulated.remove(entity);
+    m_dirtyParents.remove(entity);
+}
+
+void Qt3DEntityTreeModel::moveEntity(Qt3DCore::QEntity *entity, Qt3DCore::QEntity *newParent)
+{
+    auto oldParent = m_childParentMap.value(entity);
+    const int row = m_childRowMap.value(entity);
+    const int destRow = m_parentChildMap.value(newParent).size();
+
+    if (!beginMoveRows(indexForEntity(oldParent), row, row, indexForEntity(newParent), destRow)) {
+        removeEntity(entity, false);
+        objectCreated(entity);
+        return;
+    }
+    m_parentChildMap[oldParent].remove(row);
+    m_parentChildMap[newParent].push_back(entity);
+    m_childParentMap.insert(entity, newParent);
+    m_childRowMap.insert(entity, destRow);
+    updateRows(oldParent, row);
+    endMoveRows();
 }
 
 void Qt3DEntityTreeModel::objectReparented(QObject *obj)
 {
     auto entity = qobject_cast<Qt3DCore::QEntity *>(obj);
-    if (!entity)
+    if (!entity || !m_engine)
         return;
 
-    if (m_childParentMap.contains(entity)) {
-        // moved out of our tree
-        if (!isEngineForEntity(m_engine, entity)) {
-            removeEntity(entity, false);
-        } else {
-            // TODO reparented within our tree
-        }
-    } else {
+    if (m_pendingParentMap.contains(entity)) {
+        // not visible yet, just queue it again at its new place
+        removePendingEntity(entity);
+        objectCreated(obj);
+        return;
+    }
+
+    if (!m_childParentMap.contains(entity)) {
         // possibly reparented into our tree
         objectCreated(obj);
+        return;
+    }
+
+    auto oldParent = m_childParentMap.value(entity);
+    auto newParent = entity->parentEntity();
+    if (!oldParent || newParent == oldParent)
+        return; // root entity, or a change of intermediate non-entity nodes
+
+    if (m_childParentMap.contains(newParent) && !m_unpopulated.contains(newParent)) {
+        // reparented within our tree
+        moveEntity(entity, newParent);
+    } else {
+        // moved out of our tree, or below a part of it that isn't populated yet
+        removeEntity(entity, false);
+        objectCreated(obj);
     }
 }
 
@@ -32,9 +32,12 @@
 #include <core/objectmodelbase.h>
 
 #include <QHash>
+#include <QSet>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
+class QTimer;
+
 namespace Qt3DCore {
 class QAspectEngine;
 class QEntity;
@@ -43,7 +46,10 @@ class QNode;
 QT_END_NAMESPACE
 
 namespace GammaRay {
-/** Model for the entity tree of an QAspectEngine. */
+/** Model for the entity tree of an QAspectEngine.
+ *  Children are populated lazily in chunks via fetchMore(), entities created at
+ *  runtime are inserted in batches.
+ */
 class Qt3DEntityTreeModel : public ObjectModelBase<QAbstractItemModel>
 {
     Q_OBJECT
@@ -52,11 +58,16 @@ public:
     ~Qt3DEntityTreeModel();
 
     void setEngine(Qt3DCore::QAspectEngine *engine);
+    /** Populates the model down to @p entity, if that belongs to it. */
+    void fetchEntity(Qt3DCore::QEntity *entity);
 
     QVariant data(const QModelIndex &index, int role) const override;
     int rowCount(const QModelIndex &parent) const override;
     QModelIndex parent(const QModelIndex &child) const override;
     QModelIndex index(int row, int column, const QModelIndex &parent) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
@@ -67,10 +78,17 @@ public slots:
 
 private:
     void clear();
-    void populateFromNode(Qt3DCore::QNode *node);
-    void populateFromEntity(Qt3DCore::QEntity *entity);
+    void populateChildren(Qt3DCore::QEntity *entity) const;
+    void collectChildEntities(Qt3DCore::QEntity *parentEntity, Qt3DCore::QNode *node) const;
+    bool isKnown(Qt3DCore::QEntity *entity) const;
+    void enqueueEntity(Qt3DCore::QEntity *parentEntity, Qt3DCore::QEntity *entity);
+    void removePendingEntity(Qt3DCore::QEntity *entity);
+    void insertPendingEntities();
+    void insertEntities(Qt3DCore::QEntity *parentEntity, const QVector<Qt3DCore::QEntity *> &entities);
+    void moveEntity(Qt3DCore::QEntity *entity, Qt3DCore::QEntity *newParent);
     void removeEntity(Qt3DCore::QEntity *entity, bool danglingPointer);
     void removeSubtree(Qt3DCore::QEntity *entity, bool danglingPointer);
+    void updateRows(Qt3DCore::QEntity *parentEntity, int firstRow);
     QModelIndex indexForEntity(Qt3DCore::QEntity *entity) const;
 
     void connectEntity(Qt3DCore::QEntity *entity);
@@ -79,9 +97,20 @@ private:
 
 private:
     Qt3DCore::QAspectEngine *m_engine;
+    QTimer *m_insertTimer;
 
+    // entities present in the model, the root entity is the only child of nullptr
     QHash<Qt3DCore::QEntity *, Qt3DCore::QEntity *> m_childParentMap;
     QHash<Qt3DCore::QEntity *, QVector<Qt3DCore::QEntity *> > m_parentChildMap;
+    QHash<Qt3DCore::QEntity *, int> m_childRowMap;
+
+    // entities whose children have not been looked at yet
+    mutable QSet<Qt3DCore::QEntity *> m_unpopulated;
+    // known child entities not yet inserted into the model
+    mutable QHash<Qt3DCore::QEntity *, QVector<Qt3DCore::QEntity *> > m_pendingChildren;
+    mutable QHash<Qt3DCore::QEntity *, Qt3DCore::QEntity *> m_pendingParentMap;
+    // parents of entities created at runtime, inserted with the next batch
+    QSet<Qt3DCore::QEntity *> m_dirtyParents;
 };
 }
 
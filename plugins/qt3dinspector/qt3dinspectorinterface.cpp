@@ -41,3 +41,16 @@ Qt3DInspectorInterface::Qt3DInspectorInterface(QObject *parent)
 Qt3DInspectorInterface::~Qt3DInspectorInterface()
 {
 }
+
+bool Qt3DInspectorInterface::isStatisticsEnabled() const
+{
+    return m_statisticsEnabled;
+}
+
+void Qt3DInspectorInterface::setStatisticsEnabled(bool enabled)
+{
+    if (m_statisticsEnabled == enabled)
+        return;
+    m_statisticsEnabled = enabled;
+    emit statisticsEnabledChanged();
+}
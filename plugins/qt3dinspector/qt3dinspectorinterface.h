@@ -35,12 +35,22 @@ namespace GammaRay {
 class Qt3DInspectorInterface : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool statisticsEnabled READ isStatisticsEnabled WRITE setStatisticsEnabled NOTIFY statisticsEnabledChanged)
 public:
     explicit Qt3DInspectorInterface(QObject *parent = nullptr);
     ~Qt3DInspectorInterface();
 
+    bool isStatisticsEnabled() const;
+    void setStatisticsEnabled(bool enabled);
+
 public slots:
     virtual void selectEngine(int index) = 0;
+
+signals:
+    void statisticsEnabledChanged();
+
+private:
+    bool m_statisticsEnabled = false;
 };
 }
 
@@ -98,6 +98,12 @@ Qt3DInspectorWidget::Qt3DInspectorWidget(QWidget *parent)
     ui->frameGraphNodePropertyWidget->setObjectBaseName(QStringLiteral(
                                                             "com.kdab.GammaRay.Qt3DInspector.frameGraphPropertyController"));
 
+    ui->statisticsView->header()->setObjectName("statisticsViewHeader");
+    ui->statisticsView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.Qt3DInspector.frameStatisticsModel")));
+    ui->statisticsBox->setChecked(m_interface->isStatisticsEnabled());
+    connect(ui->statisticsBox, &QAbstractButton::toggled,
+            m_interface, &Qt3DInspectorInterface::setStatisticsEnabled);
+
     connect(ui->tabWidget, &QTabWidget::currentChanged, ui->stack,
             &QStackedWidget::setCurrentIndex);
     connect(ui->scenePropertyWidget, SIGNAL(tabsUpdated()), this, SLOT(propertyWidgetTabsChanged()));
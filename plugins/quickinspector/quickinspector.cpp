@@ -719,6 +719,8 @@ void QuickInspector::analyzePainting()
         backgroundNode->renderNode(&painter, /*force opaque painting*/ true);
         iterator++;
 
+        m_sgModel->updateIfUnmonitored();
+
         for (; iterator != renderer->renderableNodes().end(); ++iterator) {
             auto node = *iterator;
             QQuickItem *origin = m_sgModel->itemForSgNode(node->handle());
@@ -772,6 +774,7 @@ void QuickInspector::itemSelectionChanged(const QItemSelection &selection)
     m_currentItem = index.data(ObjectModel::ObjectRole).value<QQuickItem *>();
     m_itemPropertyController->setObject(m_currentItem);
 
+    m_sgModel->updateIfUnmonitored();
     // It might be that a sg-node is already selected that belongs to this item, but isn't the root
     // node of the Item. In this case we don't want to overwrite that selection.
     if (m_sgModel->itemForSgNode(m_currentSgNode) != m_currentItem) {
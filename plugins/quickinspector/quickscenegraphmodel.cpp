@@ -31,6 +31,8 @@
 #include <private/qquickitem_p.h>
 #include "quickitemmodelroles.h"
 
+#include <common/modelevent.h>
+
 #include <QQuickWindow>
 #include <QThread>
 #include <QSGNode>
@@ -44,6 +46,7 @@ using namespace GammaRay;
 QuickSceneGraphModel::QuickSceneGraphModel(QObject *parent)
     : ObjectModelBase<QAbstractItemModel>(parent)
     , m_rootNode(nullptr)
+    , m_monitored(false)
 {
 }
 
@@ -57,7 +60,8 @@ void QuickSceneGraphModel::setWindow(QQuickWindow *window)
         disconnect(m_window.data(), &QQuickWindow::afterRendering, this, nullptr);
     m_window = window;
     m_rootNode = currentRootNode();
-    if (m_window && m_rootNode) {
+    // walking the scene graph after every frame is expensive, only do that while being looked at
+    if (m_window && m_rootNode && m_monitored) {
         updateSGTree(false);
         connect(m_window.data(), &QQuickWindow::afterRendering, this, [this]{ updateSGTree(); });
     }
@@ -65,6 +69,18 @@ void QuickSceneGraphModel::setWindow(QQuickWindow *window)
     endResetModel();
 }
 
+void QuickSceneGraphModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool monitored = static_cast<ModelEvent *>(event)->used();
+        if (monitored != m_monitored) {
+            m_monitored = monitored;
+            setWindow(m_window); // rebuild from scratch, or drop the tree and its afterRendering hook
+        }
+    }
+    ObjectModelBase<QAbstractItemModel>::customEvent(event);
+}
+
 void QuickSceneGraphModel::updateSGTree(bool emitSignals)
 {
     auto root = currentRootNode();
@@ -85,6 +101,20 @@ void QuickSceneGraphModel::updateSGTree(bool emitSignals)
     }
 }
 
+void QuickSceneGraphModel::updateIfUnmonitored()
+{
+    // while monitored, afterRendering keeps the tree current already
+    if (m_monitored || !m_window)
+        return;
+
+    beginResetModel();
+    clear();
+    m_rootNode = currentRootNode();
+    if (m_rootNode)
+        updateSGTree(false);
+    endResetModel();
+}
+
 QSGNode *QuickSceneGraphModel::currentRootNode() const
 {
     if (!m_window)
@@ -163,6 +193,8 @@ void QuickSceneGraphModel::clear()
 {
     m_childParentMap.clear();
     m_parentChildMap.clear();
+    m_itemItemNodeMap.clear();
+    m_itemNodeItemMap.clear();
 }
 
 // indexForNode() is expensive, so only use it when really needed
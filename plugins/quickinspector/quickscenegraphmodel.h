@@ -62,10 +62,15 @@ public:
     QSGNode *sgNodeForItem(QQuickItem *item) const;
     QQuickItem *itemForSgNode(QSGNode *node) const;
     bool verifyNodeValidity(QSGNode *node);
+    /** Rebuilds the tree for internal lookups while no client is looking at the model. */
+    void updateIfUnmonitored();
 
 signals:
     void nodeDeleted(QSGNode *node);
 
+protected:
+    void customEvent(QEvent *event) override;
+
 private slots:
     void updateSGTree(bool emitSignals = true);
 
@@ -84,6 +89,7 @@ private:
     QHash<QSGNode *, QVector<QSGNode *> > m_parentChildMap;
     QHash<QQuickItem *, QSGNode *> m_itemItemNodeMap;
     QHash<QSGNode *, QQuickItem *> m_itemNodeItemMap;
+    bool m_monitored;
 };
 }
 
@@ -34,7 +34,9 @@
 #include <core/probe.h>
 
 #include <common/metatypedeclarations.h>
+#include <common/modelevent.h>
 #include <common/objectid.h>
+#include <common/profilingpoint.h>
 
 #include <QLocale>
 #include <QMutex>
@@ -66,6 +68,7 @@ static SignalHistoryModel *s_historyModel = nullptr;
 
 static void signal_begin_callback(QObject *caller, int method_index, void **argv)
 {
+    GAMMARAY_PROFILE_SCOPE("Signals", "signal history callback");
     Q_UNUSED(argv);
     if (s_historyModel) {
         const int signalIndex = method_index + 1; // offset 1, so unknown signals end up at 0
@@ -77,21 +80,28 @@ static void signal_begin_callback(QObject *caller, int method_index, void **argv
     }
 }
 
+static SignalSpyCallbackSet historyCallbacks()
+{
+    SignalSpyCallbackSet spy;
+    spy.signalBeginCallback = signal_begin_callback;
+    return spy;
+}
+
 SignalHistoryModel::SignalHistoryModel(Probe *probe, QObject *parent)
     : QAbstractTableModel(parent)
+    , m_probe(probe)
+    , m_monitored(false)
 {
     connect(probe, &Probe::objectCreated, this, &SignalHistoryModel::onObjectAdded);
     connect(probe, &Probe::objectDestroyed, this, &SignalHistoryModel::onObjectRemoved);
 
-    SignalSpyCallbackSet spy;
-    spy.signalBeginCallback = signal_begin_callback;
-    probe->registerSignalSpyCallbackSet(spy);
-
     s_historyModel = this;
 }
 
 SignalHistoryModel::~SignalHistoryModel()
 {
+    if (m_monitored)
+        m_probe->unregisterSignalSpyCallbackSet(historyCallbacks());
     s_historyModel = nullptr;
     qDeleteAll(m_tracedObjects);
 }
@@ -179,6 +189,22 @@ QMap< int, QVariant > SignalHistoryModel::itemData(const QModelIndex &index) con
     return d;
 }
 
+void SignalHistoryModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        // only trace signals while somebody looks at the history
+        const bool monitored = static_cast<ModelEvent *>(event)->used();
+        if (monitored != m_monitored) {
+            m_monitored = monitored;
+            if (m_monitored)
+                m_probe->registerSignalSpyCallbackSet(historyCallbacks());
+            else
+                m_probe->unregisterSignalSpyCallbackSet(historyCallbacks());
+        }
+    }
+    QAbstractTableModel::customEvent(event);
+}
+
 void SignalHistoryModel::onObjectAdded(QObject *object)
 {
     Q_ASSERT(thread() == QThread::currentThread());
@@ -89,6 +89,9 @@ public:
     static qint64 timestamp(qint64 ev) { return ev >> 16; }
     static int signalIndex(qint64 ev) { return ev & 0xffff; }
 
+protected:
+    void customEvent(QEvent *event) override;
+
 private:
     Item *item(const QModelIndex &index) const;
 
@@ -100,6 +103,8 @@ private slots:
 private:
     QVector<Item *> m_tracedObjects;
     QHash<QObject *, int> m_itemIndex;
+    Probe *m_probe;
+    bool m_monitored;
 };
 } // namespace GammaRay
 
@@ -0,0 +1,331 @@
+/*
+  signallatencymodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signallatencymodel.h"
+
+#include <core/probe.h>
+#include <core/util.h>
+
+#include <common/objectid.h>
+#include <common/objectmodel.h>
+
+#include <compat/qasconst.h>
+
+#include <QMetaMethod>
+#include <QMutexLocker>
+#include <QSet>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace GammaRay;
+
+static const quintptr TopLevelId = 0;
+
+static QVariant toUSecs(double nsecs)
+{
+    return qRound64(nsecs / 100.0) / 10.0;
+}
+
+SignalLatencyModel::SignalLatencyModel(Probe *probe, SignalLatencyProfiler *profiler, QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_profiler(profiler)
+{
+    connect(probe, &Probe::objectDestroyed, this, &SignalLatencyModel::objectRemoved);
+}
+
+SignalLatencyModel::~SignalLatencyModel()
+{
+    qDeleteAll(m_items);
+}
+
+void SignalLatencyModel::update()
+{
+    const auto changes = m_profiler->takeChanges();
+    if (changes.isEmpty())
+        return;
+
+    // new signals are appended in one go at the end, existing ones are updated in place
+    QVector<SignalItem *> newItems;
+    QSet<int> changedRows;
+    for (const auto &entry : changes) {
+        const auto &key = entry.key;
+        const auto signalId = qMakePair(key.sender, key.signalIndex);
+        int row = m_itemIndex.value(signalId, -1);
+        if (row < 0) {
+            auto item = new SignalItem;
+            item->sender = key.sender;
+            item->signalIndex = key.signalIndex;
+            item->alive = true;
+            describe(key.sender, key.signalIndex, &item->senderName, &item->signalName);
+            row = m_items.size() + newItems.size();
+            newItems.push_back(item);
+            m_itemIndex.insert(signalId, row);
+            m_senderRows.insert(key.sender, row);
+        }
+        const bool isNew = row >= m_items.size();
+        SignalItem *item = isNew ? newItems.at(row - m_items.size()) : m_items.at(row);
+
+        if (key.kind == SignalLatencyKey::Emission) {
+            item->histogram = entry.histogram;
+            if (!isNew)
+                changedRows.insert(row);
+            continue;
+        }
+
+        auto it = std::find_if(item->connections.begin(), item->connections.end(), [&key](const ConnectionItem &c) {
+            return c.alive && c.receiver == key.receiver && c.methodIndex == key.methodIndex && c.kind == key.kind;
+        });
+        if (it != item->connections.end()) {
+            it->histogram = entry.histogram;
+            if (!isNew) {
+                const int childRow = int(std::distance(item->connections.begin(), it));
+                emit dataChanged(index(childRow, CountColumn, index(row, 0)), index(childRow, MaximumColumn, index(row, 0)));
+            }
+            continue;
+        }
+
+        ConnectionItem connection;
+        connection.receiver = key.receiver;
+        connection.methodIndex = key.methodIndex;
+        connection.kind = key.kind;
+        connection.alive = true;
+        connection.histogram = entry.histogram;
+        describe(key.receiver, key.methodIndex, &connection.receiverName, &connection.methodName);
+        if (!m_receiverRows.contains(key.receiver, row))
+            m_receiverRows.insert(key.receiver, row);
+
+        if (isNew) {
+            item->connections.push_back(connection);
+        } else {
+            beginInsertRows(index(row, 0), item->connections.size(), item->connections.size());
+            item->connections.push_back(connection);
+            endInsertRows();
+        }
+    }
+
+    if (!newItems.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + newItems.size() - 1);
+        m_items += newItems;
+        endInsertRows();
+    }
+    for (int row : qAsConst(changedRows))
+        emit dataChanged(index(row, CountColumn), index(row, MaximumColumn));
+}
+
+void SignalLatencyModel::clear()
+{
+    beginResetModel();
+    qDeleteAll(m_items);
+    m_items.clear();
+    m_itemIndex.clear();
+    m_senderRows.clear();
+    m_receiverRows.clear();
+    endResetModel();
+}
+
+void SignalLatencyModel::objectRemoved(QObject *object)
+{
+    m_profiler->forgetObject(object);
+
+    // keep the statistics, but make sure a new object at the same address gets its own rows
+    const auto senderRows = m_senderRows.values(object);
+    for (int row : senderRows) {
+        SignalItem *item = m_items.at(row);
+        item->alive = false;
+        m_itemIndex.remove(qMakePair(item->sender, item->signalIndex));
+        emit dataChanged(index(row, ObjectColumn), index(row, ObjectColumn)); // for ObjectIdRole
+    }
+    m_senderRows.remove(object);
+
+    const auto receiverRows = m_receiverRows.values(object);
+    for (int row : receiverRows) {
+        SignalItem *item = m_items.at(row);
+        for (int i = 0; i < item->connections.size(); ++i) {
+            auto &connection = item->connections[i];
+            if (connection.receiver != object || !connection.alive)
+                continue;
+            connection.alive = false;
+            const auto idx = index(i, ObjectColumn, index(row, 0));
+            emit dataChanged(idx, idx);
+        }
+    }
+    m_receiverRows.remove(object);
+}
+
+void SignalLatencyModel::describe(const QObject *object, int methodIndex, QString *objectName, QString *methodName) const
+{
+    QMutexLocker lock(Probe::objectLock());
+    if (!Probe::instance()->isValidObject(object)) {
+        *objectName = Util::addressToString(object);
+        *methodName = tr("<unknown>");
+        return;
+    }
+
+    *objectName = Util::shortDisplayString(object);
+    if (methodIndex < 0 || methodIndex >= object->metaObject()->methodCount())
+        *methodName = tr("<functor>");
+    else
+        *methodName = QString::fromLatin1(object->metaObject()->method(methodIndex).methodSignature());
+}
+
+int SignalLatencyModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_items.size();
+    if (parent.column() != 0 || parent.internalId() != TopLevelId)
+        return 0;
+    return m_items.at(parent.row())->connections.size();
+}
+
+int SignalLatencyModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QModelIndex SignalLatencyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    // children store the row of their signal, offset by one to tell them apart from top-level items
+    if (parent.isValid())
+        return createIndex(row, column, quintptr(parent.row() + 1));
+    return createIndex(row, column, TopLevelId);
+}
+
+QModelIndex SignalLatencyModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == TopLevelId)
+        return QModelIndex();
+    return createIndex(int(child.internalId() - 1), 0, TopLevelId);
+}
+
+QVariant SignalLatencyModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (index.internalId() == TopLevelId) {
+        const SignalItem *item = m_items.at(index.row());
+        switch (index.column()) {
+        case ObjectColumn:
+            if (role == Qt::DisplayRole)
+                return item->senderName;
+            if (role == ObjectModel::ObjectIdRole && item->alive)
+                return QVariant::fromValue(ObjectId(const_cast<QObject *>(item->sender)));
+            return QVariant();
+        case MethodColumn:
+            return role == Qt::DisplayRole ? item->signalName : QVariant();
+        case TypeColumn:
+            if (role == Qt::DisplayRole)
+                return tr("Emission");
+            if (role == Qt::ToolTipRole)
+                return tr("Time spent emitting the signal, including all directly connected slots.");
+            return QVariant();
+        default:
+            return histogramData(item->histogram, index.column(), role);
+        }
+    }
+
+    const ConnectionItem &connection = m_items.at(int(index.internalId() - 1))->connections.at(index.row());
+    switch (index.column()) {
+    case ObjectColumn:
+        if (role == Qt::DisplayRole)
+            return connection.receiverName;
+        if (role == ObjectModel::ObjectIdRole && connection.alive)
+            return QVariant::fromValue(ObjectId(const_cast<QObject *>(connection.receiver)));
+        return QVariant();
+    case MethodColumn:
+        return role == Qt::DisplayRole ? connection.methodName : QVariant();
+    case TypeColumn:
+        if (connection.kind == SignalLatencyKey::Direct) {
+            if (role == Qt::DisplayRole)
+                return tr("Direct");
+            if (role == Qt::ToolTipRole)
+                return tr("Execution time of the slot.");
+        } else {
+            if (role == Qt::DisplayRole)
+                return tr("Queued");
+            if (role == Qt::ToolTipRole)
+                return tr("Delay between the emission and the delivery of the queued call.");
+        }
+        return QVariant();
+    default:
+        return histogramData(connection.histogram, index.column(), role);
+    }
+}
+
+QVariant SignalLatencyModel::histogramData(const Log2Histogram &histogram, int column, int role) const
+{
+    if (histogram.count() == 0)
+        return QVariant();
+
+    if (role == Qt::ToolTipRole)
+        return histogram.toString(1000.0, QStringLiteral("µs"));
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (column) {
+    case CountColumn:
+        return histogram.count();
+    case MeanColumn:
+        return toUSecs(histogram.mean());
+    case MedianColumn:
+        return toUSecs(histogram.percentile(0.5));
+    case Percentile95Column:
+        return toUSecs(histogram.percentile(0.95));
+    case MaximumColumn:
+        return toUSecs(histogram.maximum());
+    }
+    return QVariant();
+}
+
+QVariant SignalLatencyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ObjectColumn:
+            return tr("Object");
+        case MethodColumn:
+            return tr("Signal / Slot");
+        case TypeColumn:
+            return tr("Type");
+        case CountColumn:
+            return tr("Samples");
+        case MeanColumn:
+            return tr("Mean [µs]");
+        case MedianColumn:
+            return tr("Median [µs]");
+        case Percentile95Column:
+            return tr("95% [µs]");
+        case MaximumColumn:
+            return tr("Max [µs]");
+        }
+    }
+    return QVariant();
+}
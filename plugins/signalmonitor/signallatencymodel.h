@@ -0,0 +1,108 @@
+/*
+  signallatencymodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_SIGNALLATENCYMODEL_H
+#define GAMMARAY_SIGNALLATENCYMODEL_H
+
+#include "signallatencyprofiler.h"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+
+namespace GammaRay {
+
+/** Signal latency histograms, per signal with their connections as children. */
+class SignalLatencyModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ObjectColumn,
+        MethodColumn,
+        TypeColumn,
+        CountColumn,
+        MeanColumn,
+        MedianColumn,
+        Percentile95Column,
+        MaximumColumn,
+        ColumnCount
+    };
+
+    explicit SignalLatencyModel(Probe *probe, SignalLatencyProfiler *profiler, QObject *parent = nullptr);
+    ~SignalLatencyModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public slots:
+    /// Fetches the histograms changed in the profiler since the last update.
+    void update();
+    void clear();
+
+private slots:
+    void objectRemoved(QObject *object);
+
+private:
+    struct ConnectionItem
+    {
+        const QObject *receiver; // never dereference, might be invalid!
+        int methodIndex;
+        SignalLatencyKey::Kind kind;
+        bool alive;
+        QString receiverName;
+        QString methodName;
+        Log2Histogram histogram;
+    };
+
+    struct SignalItem
+    {
+        const QObject *sender; // never dereference, might be invalid!
+        int signalIndex;
+        bool alive;
+        QString senderName;
+        QString signalName;
+        Log2Histogram histogram;
+        QVector<ConnectionItem> connections;
+    };
+
+    void describe(const QObject *object, int methodIndex, QString *objectName, QString *methodName) const;
+    QVariant histogramData(const Log2Histogram &histogram, int column, int role) const;
+
+    SignalLatencyProfiler *m_profiler;
+    QVector<SignalItem *> m_items;
+    QHash<QPair<const QObject *, int>, int> m_itemIndex; // live senders only
+    QMultiHash<const QObject *, int> m_senderRows;
+    QMultiHash<const QObject *, int> m_receiverRows;
+};
+}
+
+#endif // GAMMARAY_SIGNALLATENCYMODEL_H
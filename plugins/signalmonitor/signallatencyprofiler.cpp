@@ -0,0 +1,391 @@
+/*
+  signallatencyprofiler.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "signallatencyprofiler.h"
+
+#include <core/callbackreadguard.h>
+#include <core/probe.h>
+#include <core/signalspycallbackset.h>
+#include <core/util.h>
+
+#include <common/profilingpoint.h>
+
+#include <compat/qasconst.h>
+
+#include <QThreadStorage>
+#include <QtCore/private/qobject_p.h>
+
+using namespace GammaRay;
+
+namespace {
+struct Frame
+{
+    const QObject *object;
+    int index;
+    qint64 start; // -1 if not sampled
+    bool isSignal;
+};
+
+// emissions and slot invocations currently in progress on one thread
+struct ThreadState
+{
+    int find(const QObject *object, int index, bool isSignal) const
+    {
+        for (int i = stack.size() - 1; i >= 0; --i) {
+            const Frame &frame = stack.at(i);
+            if (frame.object == object && frame.index == index && frame.isSignal == isSignal)
+                return i;
+        }
+        return -1;
+    }
+
+    void push(const Frame &frame)
+    {
+        // end callbacks are skipped for objects deleted during the emission, so stale frames
+        // can pile up at the bottom of the stack
+        if (stack.size() >= 256)
+            stack.remove(0, stack.size() / 2);
+        stack.push_back(frame);
+    }
+
+    bool sample(int interval)
+    {
+        if (++counter < interval)
+            return false;
+        counter = 0;
+        return true;
+    }
+
+    QVector<Frame> stack;
+    int counter = 0;
+    int generation = -1;
+};
+}
+
+static QThreadStorage<ThreadState *> s_threadStates;
+// signal spy callbacks run under the probe's CallbackReadGuard, event callbacks take their own
+static QAtomicPointer<SignalLatencyProfiler> s_profiler;
+
+static ThreadState *threadState(int generation)
+{
+    if (!s_threadStates.hasLocalData())
+        s_threadStates.setLocalData(new ThreadState);
+    ThreadState *state = s_threadStates.localData();
+    if (state->generation != generation) {
+        // frames from before the profiler was last enabled will never see their end
+        state->stack.clear();
+        state->generation = generation;
+    }
+    return state;
+}
+
+static void latency_signal_begin(QObject *caller, int method_index, void **argv)
+{
+    GAMMARAY_PROFILE_SCOPE("Signals", "signal latency begin callback");
+    Q_UNUSED(argv);
+    if (auto profiler = s_profiler.loadAcquire())
+        profiler->signalBegin(caller, method_index);
+}
+
+static void latency_signal_end(QObject *caller, int method_index)
+{
+    GAMMARAY_PROFILE_SCOPE("Signals", "signal latency end callback");
+    if (auto profiler = s_profiler.loadAcquire())
+        profiler->signalEnd(caller, method_index);
+}
+
+static void latency_slot_begin(QObject *caller, int method_index, void **argv)
+{
+    Q_UNUSED(argv);
+    if (auto profiler = s_profiler.loadAcquire())
+        profiler->slotBegin(caller, method_index);
+}
+
+static void latency_slot_end(QObject *caller, int method_index)
+{
+    if (auto profiler = s_profiler.loadAcquire())
+        profiler->slotEnd(caller, method_index);
+}
+
+static bool latency_event_callback(void **data)
+{
+    QObject *receiver = reinterpret_cast<QObject *>(data[0]);
+    QEvent *event = reinterpret_cast<QEvent *>(data[1]);
+    if (event->type() != QEvent::MetaCall || !s_profiler.load())
+        return false;
+
+    const CallbackReadGuard guard;
+    if (auto profiler = s_profiler.loadAcquire())
+        profiler->metaCallDelivered(receiver, event);
+    return false;
+}
+
+static SignalSpyCallbackSet latencyCallbacks()
+{
+    SignalSpyCallbackSet spy;
+    spy.signalBeginCallback = latency_signal_begin;
+    spy.signalEndCallback = latency_signal_end;
+    spy.slotBeginCallback = latency_slot_begin;
+    spy.slotEndCallback = latency_slot_end;
+    return spy;
+}
+
+SignalLatencyProfiler::SignalLatencyProfiler(Probe *probe)
+    : m_probe(probe)
+    , m_sampleInterval(1)
+    , m_generation(0)
+    , m_enabled(false)
+{
+    Q_ASSERT(!s_profiler.loadAcquire());
+    s_profiler.storeRelease(this);
+    m_clock.start();
+}
+
+SignalLatencyProfiler::~SignalLatencyProfiler()
+{
+    setEnabled(false);
+    s_profiler.fetchAndStoreOrdered(nullptr);
+    // callbacks in other threads may still be calling into us
+    CallbackReadGuard::synchronize();
+}
+
+bool SignalLatencyProfiler::isEnabled() const
+{
+    return m_enabled;
+}
+
+void SignalLatencyProfiler::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+
+    if (m_enabled) {
+        m_generation.fetchAndAddOrdered(1);
+        m_probe->registerSignalSpyCallbackSet(latencyCallbacks());
+        QInternal::registerCallback(QInternal::EventNotifyCallback, latency_event_callback);
+    } else {
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, latency_event_callback);
+        m_probe->unregisterSignalSpyCallbackSet(latencyCallbacks());
+    }
+}
+
+int SignalLatencyProfiler::sampleInterval() const
+{
+    return m_sampleInterval.loadAcquire();
+}
+
+void SignalLatencyProfiler::setSampleInterval(int interval)
+{
+    m_sampleInterval.storeRelease(qMax(1, interval));
+}
+
+QVector<SignalLatencyEntry> SignalLatencyProfiler::takeChanges()
+{
+    QMutexLocker lock(&m_mutex);
+    QVector<SignalLatencyEntry> changes;
+    changes.reserve(m_dirty.size());
+    for (const auto &key : qAsConst(m_dirty)) {
+        const auto it = m_stats.find(key);
+        if (it == m_stats.end()) // forgotten in the meantime
+            continue;
+        it->dirty = false;
+        changes.push_back({ key, it->histogram });
+    }
+    m_dirty.clear();
+    return changes;
+}
+
+void SignalLatencyProfiler::forgetObject(const QObject *object)
+{
+    QMutexLocker lock(&m_mutex);
+    const auto keys = m_keysByObject.values(object);
+    if (!keys.isEmpty()) {
+        m_keysByObject.remove(object);
+        for (const auto &key : keys) {
+            m_stats.remove(key);
+            const QObject *other = key.sender == object ? key.receiver : key.sender;
+            if (other && other != object)
+                m_keysByObject.remove(other, key);
+        }
+    }
+
+    const auto signalIndexes = m_loggedSignals.values(object);
+    if (!signalIndexes.isEmpty()) {
+        m_loggedSignals.remove(object);
+        for (int signalIndex : signalIndexes)
+            m_emissionLogs.remove(qMakePair(object, signalIndex));
+        m_queuedSenders.remove(object);
+    }
+}
+
+void SignalLatencyProfiler::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats.clear();
+    m_dirty.clear();
+    m_keysByObject.clear();
+    m_emissionLogs.clear();
+    m_loggedSignals.clear();
+    m_queuedSenders.clear();
+}
+
+void SignalLatencyProfiler::signalBegin(QObject *sender, int signalIndex)
+{
+    ThreadState *state = threadState(m_generation.loadAcquire());
+    const bool sampled = state->sample(sampleInterval());
+    const bool queued = m_queuedSenders.mayContain(sender);
+    const qint64 now = sampled || queued ? m_clock.nsecsElapsed() : -1;
+    if (queued)
+        logEmission(sender, signalIndex, now);
+    state->push({ sender, signalIndex, sampled ? now : -1, true });
+}
+
+void SignalLatencyProfiler::signalEnd(QObject *sender, int signalIndex)
+{
+    ThreadState *state = threadState(m_generation.loadAcquire());
+    const int i = state->find(sender, signalIndex, true);
+    if (i < 0)
+        return;
+
+    const Frame frame = state->stack.at(i);
+    state->stack.resize(i); // also drops slots that lost their end callback
+    if (frame.start >= 0)
+        record({ sender, signalIndex, nullptr, -1, SignalLatencyKey::Emission }, m_clock.nsecsElapsed() - frame.start);
+}
+
+void SignalLatencyProfiler::slotBegin(QObject *receiver, int methodIndex)
+{
+    ThreadState *state = threadState(m_generation.loadAcquire());
+    // slots are only invoked directly from an emission, if there is a slot on top we didn't see
+    // the emission as the sender is filtered out, or the previous slot lost its end callback
+    const bool sampled = !state->stack.isEmpty() && state->stack.last().isSignal && state->stack.last().start >= 0;
+    state->push({ receiver, methodIndex, sampled ? m_clock.nsecsElapsed() : -1, false });
+}
+
+void SignalLatencyProfiler::slotEnd(QObject *receiver, int methodIndex)
+{
+    ThreadState *state = threadState(m_generation.loadAcquire());
+    const int i = state->find(receiver, methodIndex, false);
+    if (i < 0)
+        return;
+
+    const Frame frame = state->stack.at(i);
+    state->stack.resize(i);
+    if (frame.start < 0 || i == 0)
+        return;
+
+    const Frame &emission = state->stack.at(i - 1);
+    if (!emission.isSignal)
+        return;
+    record({ emission.object, emission.index, receiver, methodIndex, SignalLatencyKey::Direct },
+           m_clock.nsecsElapsed() - frame.start);
+}
+
+void SignalLatencyProfiler::metaCallDelivered(QObject *receiver, QEvent *event)
+{
+    const auto metaCallEvent = static_cast<QMetaCallEvent *>(event);
+    const QObject *sender = metaCallEvent->sender();
+    if (!sender || metaCallEvent->signalId() < 0)
+        return; // not from a signal, e.g. QMetaObject::invokeMethod
+
+    const qint64 now = m_clock.nsecsElapsed();
+    int signalIndex;
+    {
+        // the sender may well be gone by the time the call is delivered
+        QMutexLocker lock(Probe::objectLock());
+        if (!m_probe->isValidObject(sender) || m_probe->filterObject(receiver))
+            return;
+        signalIndex = Util::signalIndexToMethodIndex(sender->metaObject(), metaCallEvent->signalId());
+    }
+    const int methodIndex = metaCallEvent->id() == int(ushort(-1)) ? -1 : metaCallEvent->id();
+    const bool sampled = threadState(m_generation.loadAcquire())->sample(sampleInterval());
+
+    QMutexLocker lock(&m_mutex);
+    auto logIt = m_emissionLogs.find(qMakePair(sender, signalIndex));
+    if (logIt == m_emissionLogs.end()) {
+        // first call seen for this signal, start logging its emissions to time the next ones
+        logIt = m_emissionLogs.insert(qMakePair(sender, signalIndex), EmissionLog());
+        m_loggedSignals.insert(sender, signalIndex);
+        m_queuedSenders.add(sender);
+    }
+
+    // Queued calls of one connection are delivered in emission order, so the n-th call
+    // matches the n-th emission. A connection seen for the first time is matched with
+    // the latest emission.
+    const EmissionLog &log = *logIt;
+    const SignalLatencyKey key = { sender, signalIndex, receiver, methodIndex, SignalLatencyKey::Queued };
+    Stats &s = stats(key);
+    if (s.cursor < 0)
+        s.cursor = qMax<qint64>(0, log.count - 1);
+    s.cursor = qMax(s.cursor, log.count - EmissionLogSize);
+    if (s.cursor >= log.count)
+        return; // emitted before we started logging
+    const qint64 delay = now - log.times[s.cursor % EmissionLogSize];
+    ++s.cursor;
+
+    if (!sampled || delay < 0)
+        return;
+    s.histogram.add(delay);
+    if (!s.dirty) {
+        s.dirty = true;
+        m_dirty.push_back(key);
+    }
+}
+
+SignalLatencyProfiler::Stats &SignalLatencyProfiler::stats(const SignalLatencyKey &key)
+{
+    auto it = m_stats.find(key);
+    if (it != m_stats.end())
+        return *it;
+
+    m_keysByObject.insert(key.sender, key);
+    if (key.receiver && key.receiver != key.sender)
+        m_keysByObject.insert(key.receiver, key);
+    return *m_stats.insert(key, Stats());
+}
+
+void SignalLatencyProfiler::record(const SignalLatencyKey &key, qint64 duration)
+{
+    QMutexLocker lock(&m_mutex);
+    Stats &s = stats(key);
+    s.histogram.add(duration);
+    if (!s.dirty) {
+        s.dirty = true;
+        m_dirty.push_back(key);
+    }
+}
+
+void SignalLatencyProfiler::logEmission(const QObject *sender, int signalIndex, qint64 time)
+{
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_emissionLogs.find(qMakePair(sender, signalIndex));
+    if (it == m_emissionLogs.end())
+        return;
+    it->times[it->count % EmissionLogSize] = time;
+    ++it->count;
+}
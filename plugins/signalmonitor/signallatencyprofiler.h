@@ -0,0 +1,163 @@
+/*
+  signallatencyprofiler.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_SIGNALLATENCYPROFILER_H
+#define GAMMARAY_SIGNALLATENCYPROFILER_H
+
+#include <core/signalspysenderfilter.h>
+
+#include <common/log2histogram.h>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QEvent;
+class QObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class Probe;
+
+/** Identifies what a signal latency histogram measures. */
+struct SignalLatencyKey
+{
+    enum Kind {
+        Emission, ///< time spent in the emission, including all directly connected slots
+        Direct,   ///< execution time of a directly connected slot
+        Queued    ///< delay until a queued connection is delivered
+    };
+
+    const QObject *sender;
+    int signalIndex;
+    const QObject *receiver; // nullptr for Emission
+    int methodIndex; // -1 for Emission and functor slots
+    Kind kind;
+};
+
+inline bool operator==(const SignalLatencyKey &lhs, const SignalLatencyKey &rhs)
+{
+    return lhs.sender == rhs.sender && lhs.signalIndex == rhs.signalIndex && lhs.receiver == rhs.receiver
+           && lhs.methodIndex == rhs.methodIndex && lhs.kind == rhs.kind;
+}
+
+inline uint qHash(const SignalLatencyKey &key, uint seed = 0)
+{
+    return ::qHash(key.sender, seed) ^ ::qHash(key.receiver, seed)
+           ^ ::qHash((key.signalIndex << 16) ^ (key.methodIndex << 2) ^ key.kind, seed);
+}
+
+struct SignalLatencyEntry
+{
+    SignalLatencyKey key;
+    Log2Histogram histogram;
+};
+
+/**
+ * Measures how long signal emissions and their slots take.
+ *
+ * Signal and slot begin/end callbacks are paired on a per-thread stack, which
+ * gives the dispatch time of each emission and the execution time of each
+ * directly connected slot. Queued connections are timed from the emission to
+ * the delivery of their meta call event. Durations are aggregated into one
+ * histogram per connection.
+ *
+ * With a sample interval of n only every n-th emission per thread is timed,
+ * which keeps the overhead low enough for heavy workloads.
+ */
+class SignalLatencyProfiler
+{
+public:
+    explicit SignalLatencyProfiler(Probe *probe);
+    ~SignalLatencyProfiler();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    int sampleInterval() const;
+    void setSampleInterval(int interval);
+
+    /// Returns the histograms that changed since the last call.
+    QVector<SignalLatencyEntry> takeChanges();
+    /// Drops all data involving @p object, so a new object at the same address starts over.
+    void forgetObject(const QObject *object);
+    void clear();
+
+    // called from the signal spy and event notify callbacks, in any thread
+    void signalBegin(QObject *sender, int signalIndex);
+    void signalEnd(QObject *sender, int signalIndex);
+    void slotBegin(QObject *receiver, int methodIndex);
+    void slotEnd(QObject *receiver, int methodIndex);
+    void metaCallDelivered(QObject *receiver, QEvent *event);
+
+private:
+    Q_DISABLE_COPY(SignalLatencyProfiler)
+
+    struct Stats
+    {
+        Log2Histogram histogram;
+        qint64 cursor = -1; // next emission to match for Queued
+        bool dirty = false;
+    };
+
+    enum {
+        EmissionLogSize = 64
+    };
+    // emission times of a signal with queued connections, indexed by emission count
+    struct EmissionLog
+    {
+        qint64 count = 0;
+        qint64 times[EmissionLogSize];
+    };
+    typedef QPair<const QObject *, int> SignalId;
+
+    Stats &stats(const SignalLatencyKey &key);
+    void record(const SignalLatencyKey &key, qint64 duration);
+    void logEmission(const QObject *sender, int signalIndex, qint64 time);
+
+    Probe *m_probe;
+    QElapsedTimer m_clock;
+    QAtomicInt m_sampleInterval;
+    QAtomicInt m_generation;
+    bool m_enabled;
+    // senders in m_emissionLogs, for a lock-free negative lookup on emission
+    SignalSpySenderFilter m_queuedSenders;
+
+    mutable QMutex m_mutex; // protects everything below
+    QHash<SignalLatencyKey, Stats> m_stats;
+    QVector<SignalLatencyKey> m_dirty;
+    QMultiHash<const QObject *, SignalLatencyKey> m_keysByObject;
+    QHash<SignalId, EmissionLog> m_emissionLogs;
+    QMultiHash<const QObject *, int> m_loggedSignals;
+};
+}
+
+#endif // GAMMARAY_SIGNALLATENCYPROFILER_H
@@ -28,6 +28,8 @@
 
 #include "signalmonitor.h"
 #include "signalhistorymodel.h"
+#include "signallatencymodel.h"
+#include "signallatencyprofiler.h"
 #include "relativeclock.h"
 #include "signalmonitorcommon.h"
 
@@ -43,6 +45,7 @@ using namespace GammaRay;
 
 SignalMonitor::SignalMonitor(Probe *probe, QObject *parent)
     : SignalMonitorInterface(parent)
+    , m_latencyProfiler(new SignalLatencyProfiler(probe))
 {
     StreamOperators::registerSignalMonitorStreamOperators();
 
@@ -60,6 +63,20 @@ SignalMonitor::SignalMonitor(Probe *probe, QObject *parent)
     connect(m_clock, &QTimer::timeout, this, &SignalMonitor::timeout);
 
     connect(probe, &Probe::objectSelected, this, &SignalMonitor::objectSelected);
+
+    m_latencyModel = new SignalLatencyModel(probe, m_latencyProfiler.data(), this);
+    auto latencyProxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    latencyProxy->setDynamicSortFilter(true);
+    latencyProxy->setSourceModel(m_latencyModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.SignalLatencyModel"), latencyProxy);
+
+    m_latencyTimer = new QTimer(this);
+    m_latencyTimer->setInterval(1000);
+    connect(m_latencyTimer, &QTimer::timeout, m_latencyModel, &SignalLatencyModel::update);
+    connect(this, &SignalMonitorInterface::latencyProfilingChanged, this, &SignalMonitor::latencyProfilingChanged);
+    connect(this, &SignalMonitorInterface::latencySampleIntervalChanged, this, [this](int interval) {
+        m_latencyProfiler->setSampleInterval(interval);
+    });
 }
 
 SignalMonitor::~SignalMonitor() = default;
@@ -77,6 +94,23 @@ void SignalMonitor::sendClockUpdates(bool enabled)
         m_clock->stop();
 }
 
+void SignalMonitor::clearLatencyStatistics()
+{
+    m_latencyProfiler->clear();
+    m_latencyModel->clear();
+}
+
+void SignalMonitor::latencyProfilingChanged(bool enabled)
+{
+    m_latencyProfiler->setEnabled(enabled);
+    if (enabled) {
+        m_latencyTimer->start();
+    } else {
+        m_latencyTimer->stop();
+        m_latencyModel->update();
+    }
+}
+
 void SignalMonitor::objectSelected(QObject* obj)
 {
     const auto indexList = m_objModel->match(m_objModel->index(0, 0), ObjectModel::ObjectIdRole,
@@ -33,6 +33,8 @@
 
 #include <core/toolfactory.h>
 
+#include <QScopedPointer>
+
 QT_BEGIN_NAMESPACE
 class QAbstractItemModel;
 class QItemSelectionModel;
@@ -40,6 +42,9 @@ class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class SignalLatencyModel;
+class SignalLatencyProfiler;
+
 class SignalMonitor : public SignalMonitorInterface
 {
     Q_OBJECT
@@ -50,12 +55,17 @@ public:
 
 public slots:
     void sendClockUpdates(bool enabled) override;
+    void clearLatencyStatistics() override;
 
 private slots:
     void timeout();
     void objectSelected(QObject *obj);
+    void latencyProfilingChanged(bool enabled);
 
 private:
+    QScopedPointer<SignalLatencyProfiler> m_latencyProfiler;
+    SignalLatencyModel *m_latencyModel;
+    QTimer *m_latencyTimer;
     QTimer *m_clock;
     QAbstractItemModel *m_objModel;
     QItemSelectionModel *m_objSelectionModel;
@@ -44,3 +44,8 @@ void SignalMonitorClient::sendClockUpdates(bool enabled)
     Endpoint::instance()->invokeObject(objectName(), "sendClockUpdates",
                                        QVariantList() << QVariant::fromValue(enabled));
 }
+
+void SignalMonitorClient::clearLatencyStatistics()
+{
+    Endpoint::instance()->invokeObject(objectName(), "clearLatencyStatistics");
+}
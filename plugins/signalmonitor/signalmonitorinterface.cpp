@@ -34,8 +34,36 @@ using namespace GammaRay;
 
 SignalMonitorInterface::SignalMonitorInterface(QObject *parent)
     : QObject(parent)
+    , m_latencyProfiling(false)
+    , m_latencySampleInterval(1)
 {
     ObjectBroker::registerObject<SignalMonitorInterface *>(this);
 }
 
 SignalMonitorInterface::~SignalMonitorInterface() = default;
+
+bool SignalMonitorInterface::latencyProfiling() const
+{
+    return m_latencyProfiling;
+}
+
+void SignalMonitorInterface::setLatencyProfiling(bool enabled)
+{
+    if (m_latencyProfiling == enabled)
+        return;
+    m_latencyProfiling = enabled;
+    emit latencyProfilingChanged(enabled);
+}
+
+int SignalMonitorInterface::latencySampleInterval() const
+{
+    return m_latencySampleInterval;
+}
+
+void SignalMonitorInterface::setLatencySampleInterval(int interval)
+{
+    if (m_latencySampleInterval == interval)
+        return;
+    m_latencySampleInterval = interval;
+    emit latencySampleIntervalChanged(interval);
+}
@@ -35,15 +35,31 @@ namespace GammaRay {
 class SignalMonitorInterface : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool latencyProfiling READ latencyProfiling WRITE setLatencyProfiling NOTIFY latencyProfilingChanged)
+    Q_PROPERTY(int latencySampleInterval READ latencySampleInterval WRITE setLatencySampleInterval NOTIFY latencySampleIntervalChanged)
 public:
     explicit SignalMonitorInterface(QObject *parent = nullptr);
     ~SignalMonitorInterface() override;
 
+    bool latencyProfiling() const;
+    void setLatencyProfiling(bool enabled);
+
+    /// Only every n-th signal emission per thread is timed.
+    int latencySampleInterval() const;
+    void setLatencySampleInterval(int interval);
+
 public slots:
     virtual void sendClockUpdates(bool enabled) = 0;
+    virtual void clearLatencyStatistics() = 0;
 
 signals:
     void clock(qlonglong msecs);
+    void latencyProfilingChanged(bool enabled);
+    void latencySampleIntervalChanged(int interval);
+
+private:
+    bool m_latencyProfiling;
+    int m_latencySampleInterval;
 };
 }
 
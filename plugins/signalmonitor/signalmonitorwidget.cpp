@@ -32,6 +32,7 @@
 #include "signalhistorymodel.h"
 #include "signalmonitorclient.h"
 #include "signalmonitorcommon.h"
+#include "signallatencymodel.h"
 
 #include <ui/clientdecorationidentityproxymodel.h>
 #include <ui/contextmenuextension.h>
@@ -87,6 +88,28 @@ SignalMonitorWidget::SignalMonitorWidget(QWidget *parent)
 
     m_stateManager.setDefaultSizes(ui->objectTreeView->header(),
                                    UISizeVector() << 200 << 200 << -1);
+
+    auto iface = ObjectBroker::object<SignalMonitorInterface *>();
+    auto latencyModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.SignalLatencyModel"));
+    new SearchLineController(ui->latencySearchLine, latencyModel);
+    ui->latencyView->header()->setObjectName("latencyViewHeader");
+    ui->latencyView->setDeferredResizeMode(SignalLatencyModel::ObjectColumn, QHeaderView::Interactive);
+    ui->latencyView->setDeferredResizeMode(SignalLatencyModel::MethodColumn, QHeaderView::Interactive);
+    for (int i = SignalLatencyModel::TypeColumn; i < SignalLatencyModel::ColumnCount; ++i)
+        ui->latencyView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    ui->latencyView->setModel(latencyModel);
+    ui->latencyView->sortByColumn(SignalLatencyModel::MeanColumn, Qt::DescendingOrder);
+    connect(ui->latencyView, &QWidget::customContextMenuRequested, this, &SignalMonitorWidget::latencyContextMenu);
+    m_stateManager.setDefaultSizes(ui->latencyView->header(), UISizeVector() << 200 << 200);
+
+    ui->latencyProfilingButton->setChecked(iface->latencyProfiling());
+    connect(ui->latencyProfilingButton, &QAbstractButton::toggled, iface, &SignalMonitorInterface::setLatencyProfiling);
+    connect(iface, &SignalMonitorInterface::latencyProfilingChanged, ui->latencyProfilingButton, &QAbstractButton::setChecked);
+    ui->sampleIntervalBox->setValue(iface->latencySampleInterval());
+    connect(ui->sampleIntervalBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            iface, &SignalMonitorInterface::setLatencySampleInterval);
+    connect(iface, &SignalMonitorInterface::latencySampleIntervalChanged, ui->sampleIntervalBox, &QSpinBox::setValue);
+    connect(ui->clearLatencyButton, &QAbstractButton::clicked, iface, &SignalMonitorInterface::clearLatencyStatistics);
 }
 
 SignalMonitorWidget::~SignalMonitorWidget() = default;
@@ -106,15 +129,16 @@ void SignalMonitorWidget::adjustEventScrollBarSize()
     // rock and a hard place.
     const QWidget * const scrollBar = ui->objectTreeView->verticalScrollBar();
     const QWidget * const viewport = ui->objectTreeView->viewport();
+    const QWidget * const page = ui->historyTab;
 
     const int eventColumnLeft = ui->objectTreeView->eventColumnPosition();
-    const int scrollBarLeft = scrollBar->mapTo(this, scrollBar->pos()).x();
-    const int viewportLeft = viewport->mapTo(this, viewport->pos()).x();
+    const int scrollBarLeft = scrollBar->mapTo(page, scrollBar->pos()).x();
+    const int viewportLeft = viewport->mapTo(page, viewport->pos()).x();
     const int viewportRight = viewportLeft + viewport->width();
 
     ui->eventScrollBarLayout->setContentsMargins(eventColumnLeft,
                                                  scrollBarLeft - viewportRight,
-                                                 width() - viewportRight,
+                                                 page->width() - viewportRight,
                                                  0);
 }
 
@@ -145,6 +169,23 @@ void SignalMonitorWidget::contextMenu(QPoint pos)
     menu.exec(ui->objectTreeView->viewport()->mapToGlobal(pos));
 }
 
+void SignalMonitorWidget::latencyContextMenu(QPoint pos)
+{
+    auto index = ui->latencyView->indexAt(pos);
+    if (!index.isValid())
+        return;
+    index = index.sibling(index.row(), SignalLatencyModel::ObjectColumn);
+
+    const auto objectId = index.data(ObjectModel::ObjectIdRole).value<ObjectId>();
+    if (objectId.isNull())
+        return;
+
+    QMenu menu;
+    ContextMenuExtension ext(objectId);
+    ext.populateMenu(&menu);
+    menu.exec(ui->latencyView->viewport()->mapToGlobal(pos));
+}
+
 void SignalMonitorWidget::selectionChanged(const QItemSelection& selection)
 {
     if (selection.isEmpty())
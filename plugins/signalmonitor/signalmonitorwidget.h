@@ -56,6 +56,7 @@ private slots:
     void pauseAndResume(bool pause);
     void eventDelegateIsActiveChanged(bool active);
     void contextMenu(QPoint pos);
+    void latencyContextMenu(QPoint pos);
     void selectionChanged(const QItemSelection &selection);
 
 private:
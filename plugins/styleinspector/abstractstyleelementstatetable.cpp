@@ -27,10 +27,13 @@
 */
 
 #include "abstractstyleelementstatetable.h"
+#include "dynamicproxystyle.h"
 #include "styleoption.h"
 #include "styleinspectorinterface.h"
+#include <core/util.h>
 #include <common/objectbroker.h>
 
+#include <QImage>
 #include <QPainter>
 #include <QStyleOption>
 #include <QDebug>
@@ -41,12 +44,18 @@ using namespace GammaRay;
 AbstractStyleElementStateTable::AbstractStyleElementStateTable(QObject *parent)
     : AbstractStyleElementModel(parent)
     , m_interface(ObjectBroker::object<StyleInspectorInterface *>())
+    , m_cellCache(8 * 1024) // in kB
 {
     connect(m_interface, &StyleInspectorInterface::cellSizeChanged, this, &AbstractStyleElementStateTable::cellSizeChanged);
+    // reset when the style is changed
+    connect(this, &QAbstractItemModel::modelReset, this, [this]() {
+        m_cellCache.clear();
+    });
 }
 
 void AbstractStyleElementStateTable::cellSizeChanged()
 {
+    m_cellCache.clear();
     emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
@@ -57,13 +66,67 @@ int AbstractStyleElementStateTable::doColumnCount() const
 
 QVariant AbstractStyleElementStateTable::doData(int row, int column, int role) const
 {
-    Q_UNUSED(column);
-    Q_UNUSED(row);
+    if (role == Qt::DecorationRole)
+        return cellPixmap(row, column);
     if (role == Qt::SizeHintRole)
         return m_interface->cellSizeHint();
     return QVariant();
 }
 
+AbstractStyleElementStateTable::CellKey AbstractStyleElementStateTable::cellKey(int row, int column) const
+{
+    CellKey key;
+    key.style = m_style;
+    key.row = row;
+    key.column = column;
+    key.size = m_interface->cellSizeHint();
+    key.zoom = m_interface->cellZoom();
+    key.paletteKey = qApp->palette().cacheKey();
+    // editing metrics and hints changes the rendering through proxy()
+    key.overridesGeneration = DynamicProxyStyle::overridesGeneration();
+    return key;
+}
+
+QPixmap AbstractStyleElementStateTable::cellPixmap(int row, int column) const
+{
+    const auto key = cellKey(row, column);
+    if (auto pixmap = m_cellCache.object(key))
+        return *pixmap;
+
+    renderRow(row);
+    if (auto pixmap = m_cellCache.object(key))
+        return *pixmap;
+    return QPixmap();
+}
+
+void AbstractStyleElementStateTable::renderRow(int row) const
+{
+    const auto cellSize = m_interface->cellSizeHint();
+    const int columns = columnCount();
+    if (cellSize.isEmpty() || columns <= 0)
+        return;
+
+    QImage atlas(cellSize.width() * columns, cellSize.height(), QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&atlas);
+    const QRect cellRect(QPoint(0, 0), cellSize);
+    for (int column = 0; column < columns; ++column) {
+        painter.save();
+        painter.translate(column * cellSize.width(), 0);
+        painter.setClipRect(cellRect);
+        Util::drawTransparencyPattern(&painter, cellRect);
+        painter.scale(m_interface->cellZoom(), m_interface->cellZoom());
+        drawCell(&painter, row, column);
+        painter.restore();
+    }
+    painter.end();
+
+    const int cost = qMax(1, cellSize.width() * cellSize.height() * 4 / 1024);
+    for (int column = 0; column < columns; ++column) {
+        const auto cell = atlas.copy(column * cellSize.width(), 0, cellSize.width(), cellSize.height());
+        m_cellCache.insert(cellKey(row, column), new QPixmap(QPixmap::fromImage(cell)), cost);
+    }
+}
+
 QVariant AbstractStyleElementStateTable::headerData(int section, Qt::Orientation orientation,
                                                     int role) const
 {
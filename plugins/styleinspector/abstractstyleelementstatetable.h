@@ -32,6 +32,10 @@
 #include "abstractstyleelementmodel.h"
 #include <common/modelroles.h>
 
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+
 QT_BEGIN_NAMESPACE
 class QStyleOption;
 class QRect;
@@ -44,6 +48,10 @@ class StyleInspectorInterface;
 /**
  * Base class for style element x style option state tables.
  * Covers the state part, sub-classes need to fill in the corresponding rows.
+ *
+ * Rendered cells are cached, keyed by everything that influences their look.
+ * On a cache miss the entire row is rendered at once into a single atlas image,
+ * as neighboring cells are usually requested together.
  */
 class AbstractStyleElementStateTable : public GammaRay::AbstractStyleElementModel
 {
@@ -61,11 +69,46 @@ protected:
     /// standard setup for the style option used in a cell in column @p column
     void fillStyleOption(QStyleOption *option, int column) const;
 
+    /// draw the element for row @p row in the state of column @p column, @p painter is already scaled
+    virtual void drawCell(QPainter *painter, int row, int column) const = 0;
+
 protected:
     StyleInspectorInterface *m_interface;
 
 private slots:
     void cellSizeChanged();
+
+private:
+    struct CellKey
+    {
+        const QStyle *style;
+        int row;
+        int column;
+        QSize size;
+        int zoom;
+        qint64 paletteKey;
+        int overridesGeneration;
+
+        bool operator==(const CellKey &other) const
+        {
+            return style == other.style && row == other.row && column == other.column
+                   && size == other.size && zoom == other.zoom && paletteKey == other.paletteKey
+                   && overridesGeneration == other.overridesGeneration;
+        }
+        friend uint qHash(const CellKey &key, uint seed = 0)
+        {
+            return ::qHash(key.style, seed) ^ ::qHash(key.row, seed) ^ ::qHash(key.column << 16, seed)
+                   ^ ::qHash(key.zoom << 8, seed) ^ ::qHash(key.size.width() << 20, seed)
+                   ^ ::qHash(key.size.height(), seed) ^ ::qHash(key.paletteKey, seed)
+                   ^ ::qHash(key.overridesGeneration << 12, seed);
+        }
+    };
+
+    CellKey cellKey(int row, int column) const;
+    QPixmap cellPixmap(int row, int column) const;
+    void renderRow(int row) const;
+
+    mutable QCache<CellKey, QPixmap> m_cellCache;
 };
 }
 
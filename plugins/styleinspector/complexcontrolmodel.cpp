@@ -29,7 +29,6 @@
 #include "complexcontrolmodel.h"
 #include "styleoption.h"
 #include "styleinspectorinterface.h"
-#include <core/util.h>
 
 #include <QDebug>
 #include <QPainter>
@@ -78,41 +77,30 @@ ComplexControlModel::ComplexControlModel(QObject *parent)
 {
 }
 
-QVariant ComplexControlModel::doData(int row, int column, int role) const
+void ComplexControlModel::drawCell(QPainter *painter, int row, int column) const
 {
-    if (role == Qt::DecorationRole) {
-        QPixmap pixmap(m_interface->cellSizeHint());
-        QPainter painter(&pixmap);
-        Util::drawTransparencyPattern(&painter, pixmap.rect());
-        painter.scale(m_interface->cellZoom(), m_interface->cellZoom());
-
-        QScopedPointer<QStyleOptionComplex> opt(
-            qstyleoption_cast<QStyleOptionComplex *>(
-                complexControlElements[row].styleOptionFactory()));
-        Q_ASSERT(opt);
-        fillStyleOption(opt.data(), column);
-        m_style->drawComplexControl(complexControlElements[row].control, opt.data(), &painter);
-
-        int colorIndex = 7;
-        unsigned int nshifts = sizeof(unsigned int) * 8;
-        for (unsigned int i = 0; i < nshifts; ++i) {
-            QStyle::SubControl sc = static_cast<QStyle::SubControl>(1U << i);
-            if (sc & complexControlElements[row].subControls) {
-                QRectF scRect
-                    = m_style->subControlRect(complexControlElements[row].control, opt.data(), sc);
-                scRect.adjust(0, 0, -1.0 / m_interface->cellZoom(), -1.0 / m_interface->cellZoom());
-                if (scRect.isValid() && !scRect.isEmpty()) {
-                    // HACK: add some real color mapping
-                    painter.setPen(static_cast<Qt::GlobalColor>(colorIndex++));
-                    painter.drawRect(scRect);
-                }
+    QScopedPointer<QStyleOptionComplex> opt(
+        qstyleoption_cast<QStyleOptionComplex *>(
+            complexControlElements[row].styleOptionFactory()));
+    Q_ASSERT(opt);
+    fillStyleOption(opt.data(), column);
+    m_style->drawComplexControl(complexControlElements[row].control, opt.data(), painter);
+
+    int colorIndex = 7;
+    unsigned int nshifts = sizeof(unsigned int) * 8;
+    for (unsigned int i = 0; i < nshifts; ++i) {
+        QStyle::SubControl sc = static_cast<QStyle::SubControl>(1U << i);
+        if (sc & complexControlElements[row].subControls) {
+            QRectF scRect
+                = m_style->subControlRect(complexControlElements[row].control, opt.data(), sc);
+            scRect.adjust(0, 0, -1.0 / m_interface->cellZoom(), -1.0 / m_interface->cellZoom());
+            if (scRect.isValid() && !scRect.isEmpty()) {
+                // HACK: add some real color mapping
+                painter->setPen(static_cast<Qt::GlobalColor>(colorIndex++));
+                painter->drawRect(scRect);
             }
         }
-
-        return pixmap;
     }
-
-    return AbstractStyleElementStateTable::doData(row, column, role);
 }
 
 int ComplexControlModel::doRowCount() const
@@ -42,7 +42,7 @@ public:
                         int role = Qt::DisplayRole) const override;
 
 protected:
-    QVariant doData(int row, int column, int role) const override;
+    void drawCell(QPainter *painter, int row, int column) const override;
     int doRowCount() const override;
 };
 }
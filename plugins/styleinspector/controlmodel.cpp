@@ -29,7 +29,6 @@
 #include "controlmodel.h"
 #include "styleoption.h"
 #include "styleinspectorinterface.h"
-#include <core/util.h>
 
 #include <QPainter>
 #include <QStyle>
@@ -101,21 +100,11 @@ ControlModel::ControlModel(QObject *parent)
 {
 }
 
-QVariant ControlModel::doData(int row, int column, int role) const
+void ControlModel::drawCell(QPainter *painter, int row, int column) const
 {
-    if (role == Qt::DecorationRole) {
-        QPixmap pixmap(m_interface->cellSizeHint());
-        QPainter painter(&pixmap);
-        Util::drawTransparencyPattern(&painter, pixmap.rect());
-        painter.scale(m_interface->cellZoom(), m_interface->cellZoom());
-
-        QScopedPointer<QStyleOption> opt(controlElements[row].styleOptionFactory());
-        fillStyleOption(opt.data(), column);
-        m_style->drawControl(controlElements[row].control, opt.data(), &painter);
-        return pixmap;
-    }
-
-    return AbstractStyleElementStateTable::doData(row, column, role);
+    QScopedPointer<QStyleOption> opt(controlElements[row].styleOptionFactory());
+    fillStyleOption(opt.data(), column);
+    m_style->drawControl(controlElements[row].control, opt.data(), painter);
 }
 
 int ControlModel::doRowCount() const
@@ -27,15 +27,49 @@
 */
 
 #include "dynamicproxystyle.h"
+#include "stylecallprofiler.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QWidget>
 
 using namespace GammaRay;
 
+namespace {
+/** Records the duration of its scope in the call profiler, if there is one. */
+class CallTimer
+{
+public:
+    CallTimer(StyleCallProfiler *profiler, StyleCallProfiler::CallType type, quintptr element)
+        : m_profiler(profiler)
+        , m_type(type)
+        , m_element(element)
+    {
+        if (m_profiler)
+            m_timer.start();
+    }
+
+    ~CallTimer()
+    {
+        if (m_profiler)
+            m_profiler->recordCall(m_type, m_element, m_timer.nsecsElapsed());
+    }
+
+private:
+    Q_DISABLE_COPY(CallTimer)
+    StyleCallProfiler *m_profiler;
+    StyleCallProfiler::CallType m_type;
+    quintptr m_element;
+    QElapsedTimer m_timer;
+};
+}
+
 QPointer<DynamicProxyStyle> DynamicProxyStyle::s_instance;
+int DynamicProxyStyle::s_overridesGeneration = 0;
 
 DynamicProxyStyle::DynamicProxyStyle(QStyle *baseStyle)
     : QProxyStyle(baseStyle)
+    , m_callProfiler(nullptr)
 {
     s_instance = QPointer<DynamicProxyStyle>(this);
 }
@@ -62,16 +96,65 @@ void DynamicProxyStyle::insertProxyStyle()
 void DynamicProxyStyle::setPixelMetric(QStyle::PixelMetric metric, int value)
 {
     m_pixelMetrics.insert(metric, value);
+    ++s_overridesGeneration;
 }
 
 void DynamicProxyStyle::setStyleHint(QStyle::StyleHint hint, int value)
 {
     m_styleHints.insert(hint, value);
+    ++s_overridesGeneration;
+}
+
+int DynamicProxyStyle::overridesGeneration()
+{
+    return s_overridesGeneration;
+}
+
+void DynamicProxyStyle::setCallProfiler(StyleCallProfiler *profiler)
+{
+    m_callProfiler = profiler;
+}
+
+void DynamicProxyStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleOption *option,
+                                      QPainter *painter, const QWidget *widget) const
+{
+    CallTimer t(m_callProfiler, StyleCallProfiler::DrawPrimitiveCall, element);
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void DynamicProxyStyle::drawControl(QStyle::ControlElement element, const QStyleOption *option,
+                                    QPainter *painter, const QWidget *widget) const
+{
+    CallTimer t(m_callProfiler, StyleCallProfiler::DrawControlCall, element);
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void DynamicProxyStyle::drawComplexControl(QStyle::ComplexControl control,
+                                           const QStyleOptionComplex *option, QPainter *painter,
+                                           const QWidget *widget) const
+{
+    CallTimer t(m_callProfiler, StyleCallProfiler::DrawComplexControlCall, control);
+    QProxyStyle::drawComplexControl(control, option, painter, widget);
+}
+
+QSize DynamicProxyStyle::sizeFromContents(QStyle::ContentsType type, const QStyleOption *option,
+                                          const QSize &size, const QWidget *widget) const
+{
+    CallTimer t(m_callProfiler, StyleCallProfiler::SizeFromContentsCall, type);
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
+
+void DynamicProxyStyle::polish(QWidget *widget)
+{
+    CallTimer t(m_callProfiler, StyleCallProfiler::PolishCall,
+                widget ? reinterpret_cast<quintptr>(widget->metaObject()) : 0);
+    QProxyStyle::polish(widget);
 }
 
 int DynamicProxyStyle::pixelMetric(QStyle::PixelMetric metric, const QStyleOption *option,
                                    const QWidget *widget) const
 {
+    CallTimer t(m_callProfiler, StyleCallProfiler::PixelMetricCall, metric);
     auto it = m_pixelMetrics.find(metric);
     if (it != m_pixelMetrics.end())
         return it.value();
@@ -80,6 +163,7 @@ int DynamicProxyStyle::pixelMetric(QStyle::PixelMetric metric, const QStyleOptio
 
 int DynamicProxyStyle::styleHint(QStyle::StyleHint hint, const QStyleOption *option, const QWidget *widget, QStyleHintReturn *returnData) const
 {
+    CallTimer t(m_callProfiler, StyleCallProfiler::StyleHintCall, hint);
     const auto it = m_styleHints.find(hint);
     if (it != m_styleHints.end())
         return it.value();
@@ -34,6 +34,8 @@
 #include <QPointer>
 
 namespace GammaRay {
+class StyleCallProfiler;
+
 /**
  * A proxy style that allows runtime-editing of various parameters.
  */
@@ -49,6 +51,23 @@ public:
 
     void setPixelMetric(PixelMetric metric, int value);
     void setStyleHint(StyleHint hint, int value);
+    /// changes whenever a pixel metric or style hint override changes, for cache keys
+    static int overridesGeneration();
+
+    /// records all style calls in @p profiler while set, pass @c nullptr to stop profiling
+    void setCallProfiler(StyleCallProfiler *profiler);
+
+    using QProxyStyle::polish;
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                       const QWidget *widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget = nullptr) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex *option,
+                            QPainter *painter, const QWidget *widget = nullptr) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                           const QWidget *widget) const override;
+    void polish(QWidget *widget) override;
 
     int pixelMetric(PixelMetric metric, const QStyleOption *option = nullptr,
                     const QWidget *widget = nullptr) const override;
@@ -57,7 +76,9 @@ public:
 private:
     QHash<QStyle::PixelMetric, int> m_pixelMetrics;
     QHash<QStyle::StyleHint, int> m_styleHints;
+    StyleCallProfiler *m_callProfiler;
     static QPointer<DynamicProxyStyle> s_instance;
+    static int s_overridesGeneration;
 };
 }
 
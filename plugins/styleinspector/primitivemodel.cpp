@@ -29,10 +29,8 @@
 #include "primitivemodel.h"
 #include "styleoption.h"
 #include "styleinspectorinterface.h"
-#include <core/util.h>
 
 #include <QPainter>
-#include <QPixmap>
 #include <QStyleOption>
 
 using namespace GammaRay;
@@ -103,21 +101,11 @@ PrimitiveModel::PrimitiveModel(QObject *parent)
 {
 }
 
-QVariant PrimitiveModel::doData(int row, int column, int role) const
+void PrimitiveModel::drawCell(QPainter *painter, int row, int column) const
 {
-    if (role == Qt::DecorationRole) {
-        QPixmap pixmap(m_interface->cellSizeHint());
-        QPainter painter(&pixmap);
-        Util::drawTransparencyPattern(&painter, pixmap.rect());
-        painter.scale(m_interface->cellZoom(), m_interface->cellZoom());
-
-        QScopedPointer<QStyleOption> opt((primititveElements[row].styleOptionFactory)());
-        fillStyleOption(opt.data(), column);
-        m_style->drawPrimitive(primititveElements[row].primitive, opt.data(), &painter);
-        return pixmap;
-    }
-
-    return AbstractStyleElementStateTable::doData(row, column, role);
+    QScopedPointer<QStyleOption> opt((primititveElements[row].styleOptionFactory)());
+    fillStyleOption(opt.data(), column);
+    m_style->drawPrimitive(primititveElements[row].primitive, opt.data(), painter);
 }
 
 int PrimitiveModel::doRowCount() const
@@ -0,0 +1,209 @@
+/*
+  stylecallprofiler.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stylecallprofiler.h"
+#include "dynamicproxystyle.h"
+
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <QMetaEnum>
+#include <QStyle>
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+StyleCallProfiler::StyleCallProfiler(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_enabled(false)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &StyleCallProfiler::refresh);
+}
+
+StyleCallProfiler::~StyleCallProfiler()
+{
+    setEnabled(false);
+}
+
+void StyleCallProfiler::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+
+    if (enabled) {
+        beginResetModel();
+        {
+            QMutexLocker lock(&m_mutex);
+            m_stats.clear();
+        }
+        m_rowMap.clear();
+        m_rows.clear();
+        endResetModel();
+        // inserts the proxy style in front of the application style if necessary
+        DynamicProxyStyle::instance()->setCallProfiler(this);
+        m_refreshTimer->start();
+    } else {
+        if (DynamicProxyStyle::exists())
+            DynamicProxyStyle::instance()->setCallProfiler(nullptr);
+        m_refreshTimer->stop();
+        refresh();
+    }
+}
+
+void StyleCallProfiler::recordCall(CallType type, quintptr element, qint64 nsecs)
+{
+    QMutexLocker lock(&m_mutex);
+    auto &stats = m_stats[CallKey(type, element)];
+    ++stats.count;
+    stats.totalTime += nsecs;
+    stats.maxTime = std::max(stats.maxTime, nsecs);
+}
+
+void StyleCallProfiler::refresh()
+{
+    QHash<CallKey, Stats> stats;
+    {
+        QMutexLocker lock(&m_mutex);
+        stats = m_stats;
+    }
+
+    QVector<Row> newRows;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const auto rowIt = m_rowMap.constFind(it.key());
+        if (rowIt != m_rowMap.constEnd()) {
+            m_rows[rowIt.value()].stats = it.value();
+            continue;
+        }
+        Row row;
+        row.key = it.key();
+        row.element = elementName(it.key());
+        row.stats = it.value();
+        newRows.push_back(row);
+    }
+
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, CountColumn), index(m_rows.size() - 1, ColumnCount - 1));
+
+    if (newRows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + newRows.size() - 1);
+    for (const auto &row : qAsConst(newRows)) {
+        m_rowMap.insert(row.key, m_rows.size());
+        m_rows.push_back(row);
+    }
+    endInsertRows();
+}
+
+QString StyleCallProfiler::elementName(const CallKey &key) const
+{
+    if (key.first == PolishCall) {
+        if (!key.second)
+            return QStringLiteral("<null>");
+        return QString::fromLatin1(reinterpret_cast<const QMetaObject *>(key.second)->className());
+    }
+
+    static const char * const enumNames[] = {
+        "PrimitiveElement", "ControlElement", "ComplexControl", "PixelMetric", "StyleHint", "ContentsType"
+    };
+    static_assert(sizeof(enumNames) / sizeof(enumNames[0]) == PolishCall, "enum name missing");
+    const auto enumIndex = QStyle::staticMetaObject.indexOfEnumerator(enumNames[key.first]);
+    if (enumIndex >= 0) {
+        const auto name = QStyle::staticMetaObject.enumerator(enumIndex).valueToKey(int(key.second));
+        if (name)
+            return QString::fromLatin1(name);
+    }
+    return QString::number(key.second);
+}
+
+int StyleCallProfiler::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int StyleCallProfiler::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant StyleCallProfiler::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    static const char * const callNames[] = {
+        "drawPrimitive", "drawControl", "drawComplexControl", "pixelMetric", "styleHint", "sizeFromContents", "polish"
+    };
+    static_assert(sizeof(callNames) / sizeof(callNames[0]) == CallTypeCount, "call name missing");
+
+    const auto &row = m_rows.at(index.row());
+    const auto &stats = row.stats;
+    switch (index.column()) {
+    case CallColumn:
+        return QString::fromLatin1(callNames[row.key.first]);
+    case ElementColumn:
+        return row.element;
+    case CountColumn:
+        return stats.count;
+    case TotalTimeColumn:
+        return Util::nsecsToMSecs(stats.totalTime);
+    case MeanTimeColumn:
+        return stats.count ? Util::nsecsToUSecs(stats.totalTime / qint64(stats.count)) : QVariant();
+    case MaxTimeColumn:
+        return Util::nsecsToUSecs(stats.maxTime);
+    }
+    return QVariant();
+}
+
+QVariant StyleCallProfiler::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case CallColumn:
+            return tr("Call");
+        case ElementColumn:
+            return tr("Element");
+        case CountColumn:
+            return tr("Count");
+        case TotalTimeColumn:
+            return tr("Total [ms]");
+        case MeanTimeColumn:
+            return tr("Mean [µs]");
+        case MaxTimeColumn:
+            return tr("Max [µs]");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
@@ -0,0 +1,119 @@
+/*
+  stylecallprofiler.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STYLEINSPECTOR_STYLECALLPROFILER_H
+#define GAMMARAY_STYLEINSPECTOR_STYLECALLPROFILER_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/**
+ * Counts and times the calls made to the application style, per style element.
+ *
+ * Calls are recorded by DynamicProxyStyle, which is inserted in front of the
+ * application style while profiling. Times are inclusive, ie. a control also
+ * accounts for the primitives it draws.
+ */
+class StyleCallProfiler : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        CallColumn,
+        ElementColumn,
+        CountColumn,
+        TotalTimeColumn,
+        MeanTimeColumn,
+        MaxTimeColumn,
+        ColumnCount
+    };
+
+    enum CallType {
+        DrawPrimitiveCall,
+        DrawControlCall,
+        DrawComplexControlCall,
+        PixelMetricCall,
+        StyleHintCall,
+        SizeFromContentsCall,
+        PolishCall,
+        CallTypeCount
+    };
+
+    explicit StyleCallProfiler(QObject *parent = nullptr);
+    ~StyleCallProfiler() override;
+
+    void setEnabled(bool enabled);
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    /// @internal called by DynamicProxyStyle in any thread that uses the style, @p element
+    /// is the enum value, or the QMetaObject of the polished widget
+    void recordCall(CallType type, quintptr element, qint64 nsecs);
+
+private slots:
+    void refresh();
+
+private:
+    typedef QPair<int, quintptr> CallKey;
+    struct Stats
+    {
+        quint64 count = 0;
+        qint64 totalTime = 0;
+        qint64 maxTime = 0;
+    };
+    struct Row
+    {
+        CallKey key;
+        QString element;
+        Stats stats;
+    };
+
+    QString elementName(const CallKey &key) const;
+
+    bool m_enabled;
+    QTimer *m_refreshTimer;
+
+    QMutex m_mutex; // protects m_stats
+    QHash<CallKey, Stats> m_stats;
+    QHash<CallKey, int> m_rowMap;
+    QVector<Row> m_rows;
+};
+}
+
+#endif // GAMMARAY_STYLEINSPECTOR_STYLECALLPROFILER_H
@@ -32,6 +32,7 @@
 #include "pixelmetricmodel.h"
 #include "primitivemodel.h"
 #include "standardiconmodel.h"
+#include "stylecallprofiler.h"
 #include "stylehintmodel.h"
 
 #include <core/objecttypefilterproxymodel.h>
@@ -54,6 +55,7 @@ StyleInspector::StyleInspector(Probe *probe, QObject *parent)
     , m_standardIconModel(new StandardIconModel(this))
     , m_standardPaletteModel(new PaletteModel(this))
     , m_styleHintModel(new StyleHintModel(this))
+    , m_callProfiler(new StyleCallProfiler(this))
 {
     auto *styleFilter = new ObjectTypeFilterProxyModel<QStyle>(this);
     styleFilter->setSourceModel(probe->objectListModel());
@@ -82,6 +84,10 @@ StyleInspector::StyleInspector(Probe *probe, QObject *parent)
                              "com.kdab.GammaRay.StyleInspector.PaletteModel"),
                          m_standardPaletteModel);
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.StyleInspector.StyleHintModel"), m_styleHintModel);
+
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.StyleInspector.CallProfileModel"), m_callProfiler);
+    connect(this, &StyleInspectorInterface::callProfilingEnabledChanged,
+            m_callProfiler, &StyleCallProfiler::setEnabled);
 }
 
 StyleInspector::~StyleInspector() = default;
@@ -46,6 +46,7 @@ class PaletteModel;
 class PixelMetricModel;
 class PrimitiveModel;
 class StandardIconModel;
+class StyleCallProfiler;
 class StyleHintModel;
 
 class StyleInspector : public StyleInspectorInterface
@@ -67,6 +68,7 @@ private:
     StandardIconModel *m_standardIconModel;
     PaletteModel *m_standardPaletteModel;
     StyleHintModel *m_styleHintModel;
+    StyleCallProfiler *m_callProfiler;
 };
 
 class StyleInspectorFactory : public QObject, public StandardToolFactory<QStyle, StyleInspector>
@@ -59,3 +59,9 @@ void StyleInspectorClient::setCellZoom(int zoom)
     StyleInspectorInterface::setCellZoom(zoom);
     Endpoint::instance()->invokeObject(objectName(), "setCellZoom", QVariantList() << zoom);
 }
+
+void StyleInspectorClient::setCallProfilingEnabled(bool enabled)
+{
+    StyleInspectorInterface::setCallProfilingEnabled(enabled);
+    Endpoint::instance()->invokeObject(objectName(), "setCallProfilingEnabled", QVariantList() << enabled);
+}
@@ -43,6 +43,7 @@ public:
     void setCellHeight(int height) override;
     void setCellWidth(int width) override;
     void setCellZoom(int zoom) override;
+    void setCallProfilingEnabled(bool enabled) override;
 };
 }
 
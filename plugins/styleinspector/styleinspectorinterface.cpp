@@ -37,6 +37,7 @@ StyleInspectorInterface::StyleInspectorInterface(QObject *parent)
     , m_cellHeight(64)
     , m_cellWidth(64)
     , m_cellZoom(1)
+    , m_callProfilingEnabled(false)
 {
     ObjectBroker::registerObject<StyleInspectorInterface *>(this);
 }
@@ -63,6 +64,11 @@ QSize StyleInspectorInterface::cellSizeHint() const
     return {m_cellWidth * m_cellZoom, m_cellHeight * m_cellZoom};
 }
 
+bool StyleInspectorInterface::isCallProfilingEnabled() const
+{
+    return m_callProfilingEnabled;
+}
+
 void StyleInspectorInterface::setCellHeight(int height)
 {
     m_cellHeight = height;
@@ -80,3 +86,11 @@ void StyleInspectorInterface::setCellZoom(int zoom)
     m_cellZoom = zoom;
     emit cellSizeChanged();
 }
+
+void StyleInspectorInterface::setCallProfilingEnabled(bool enabled)
+{
+    if (m_callProfilingEnabled == enabled)
+        return;
+    m_callProfilingEnabled = enabled;
+    emit callProfilingEnabledChanged(enabled);
+}
@@ -47,19 +47,23 @@ public:
     int cellWidth() const;
     int cellZoom() const;
     QSize cellSizeHint() const;
+    bool isCallProfilingEnabled() const;
 
 signals:
     void cellSizeChanged();
+    void callProfilingEnabledChanged(bool enabled);
 
 public slots:
     virtual void setCellHeight(int height);
     virtual void setCellWidth(int width);
     virtual void setCellZoom(int zoom);
+    virtual void setCallProfilingEnabled(bool enabled);
 
 private:
     int m_cellHeight;
     int m_cellWidth;
     int m_cellZoom;
+    bool m_callProfilingEnabled;
 };
 }
 
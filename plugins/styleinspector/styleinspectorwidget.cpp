@@ -28,11 +28,14 @@
 
 #include "styleinspectorwidget.h"
 #include "ui_styleinspectorwidget.h"
+#include "styleinspectorinterface.h"
 
 #include <ui/propertyeditor/propertyeditordelegate.h>
 
 #include <common/objectbroker.h>
 
+#include <QSortFilterProxyModel>
+
 using namespace GammaRay;
 
 StyleInspectorWidget::StyleInspectorWidget(QWidget *parent)
@@ -78,6 +81,18 @@ StyleInspectorWidget::StyleInspectorWidget(QWidget *parent)
     ui->styleHintView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StyleInspector.StyleHintModel")));
     ui->styleHintView->setItemDelegate(new PropertyEditorDelegate(this));
 
+    auto callProfileProxy = new QSortFilterProxyModel(this);
+    callProfileProxy->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StyleInspector.CallProfileModel")));
+    ui->callProfileView->setModel(callProfileProxy);
+    ui->callProfileView->header()->setObjectName("callProfileViewHeader");
+    ui->callProfileView->setDeferredResizeMode(1, QHeaderView::Stretch);
+    ui->callProfileView->sortByColumn(3, Qt::DescendingOrder); // total time
+    // the interface is created by the state table pages
+    auto iface = ObjectBroker::object<StyleInspectorInterface *>();
+    ui->callProfilingBox->setChecked(iface->isCallProfilingEnabled());
+    connect(ui->callProfilingBox, &QAbstractButton::toggled,
+            iface, &StyleInspectorInterface::setCallProfilingEnabled);
+
     // TODO this will fail due to lazy model population
     if (ui->styleSelector->count())
         styleSelected(0);
@@ -29,9 +29,13 @@
 #include "timermodel.h"
 
 #include <core/objectdataprovider.h>
+#include <core/probe.h>
+#include <core/signalspycallbackset.h>
 
 #include <common/objectmodel.h>
+#include <common/modelevent.h>
 #include <common/objectid.h>
+#include <common/profilingpoint.h>
 #include <common/sourcelocation.h>
 
 #include <compat/qasconst.h>
@@ -58,6 +62,31 @@ static const char s_qmlTimerClassName[] = "QQmlTimer";
 static const int s_maxTimeoutEvents = 1000;
 static const int s_maxTimeSpan = 10000;
 
+static void signal_begin_callback(QObject *caller, int method_index, void **argv)
+{
+    Q_UNUSED(argv);
+    if (!TimerModel::isInitialized())
+        return;
+    TimerModel::instance()->preSignalActivate(caller, method_index);
+}
+
+static void signal_end_callback(QObject *caller, int method_index)
+{
+    // NOTE: here and below the caller may be invalid, e.g. if it was deleted from a slot
+    if (!TimerModel::isInitialized())
+        return;
+    TimerModel::instance()->postSignalActivate(caller, method_index);
+}
+
+static SignalSpyCallbackSet timerCallbacks()
+{
+    SignalSpyCallbackSet callbacks;
+    callbacks.signalBeginCallback = signal_begin_callback;
+    callbacks.signalEndCallback = signal_end_callback;
+    callbacks.monitoredSendersOnly = true; // see addSignalSpySenders()
+    return callbacks;
+}
+
 namespace GammaRay {
 struct TimeoutEvent
 {
@@ -178,14 +207,13 @@ TimerModel::TimerModel(QObject *parent)
     , m_timeoutIndex(QTimer::staticMetaObject.indexOfSignal("timeout()"))
     , m_qmlTimerTriggeredIndex(-1)
     , m_qmlTimerRunningChangedIndex(-1)
+    , m_monitored(false)
 {
     Q_ASSERT(m_triggerPushChangesMethod.methodIndex() != -1);
 
     m_pushTimer->setSingleShot(true);
     m_pushTimer->setInterval(5000);
     connect(m_pushTimer, &QTimer::timeout, this, &TimerModel::pushChanges);
-
-    QInternal::registerCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
 }
 
 const TimerIdInfo *TimerModel::findTimerInfo(const QModelIndex &index) const
@@ -293,6 +321,7 @@ void TimerModel::checkDispatcherStatus(QObject *object)
 
 bool TimerModel::eventNotifyCallback(void *data[])
 {
+    GAMMARAY_PROFILE_SCOPE("Timers", "timer event callback");
     Q_ASSERT(TimerModel::isInitialized());
 
     /*
@@ -339,13 +368,53 @@ bool TimerModel::eventNotifyCallback(void *data[])
 
 TimerModel::~TimerModel()
 {
+    setMonitored(false);
     QMutexLocker locker(&m_mutex);
-    QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
     m_gatheredTimersData.clear();
     m_timersInfo.clear();
     m_freeTimersInfo.clear();
 }
 
+void TimerModel::setMonitored(bool monitored)
+{
+    if (m_monitored == monitored)
+        return;
+    m_monitored = monitored;
+
+    // timer tracking hooks into every event and signal, so only do that while somebody is looking
+    if (m_monitored) {
+        QInternal::registerCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+        if (Probe::instance())
+            Probe::instance()->registerSignalSpyCallbackSet(timerCallbacks());
+        if (m_sourceModel)
+            addSignalSpySenders(0, m_sourceModel->rowCount() - 1);
+    } else {
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+        if (Probe::instance())
+            Probe::instance()->unregisterSignalSpyCallbackSet(timerCallbacks());
+    }
+}
+
+void TimerModel::addSignalSpySenders(int first, int last)
+{
+    // only timers need to pass the signal spy, all other emissions are filtered out before calling us
+    auto probe = Probe::instance();
+    if (!m_monitored || !probe)
+        return;
+    for (int row = first; row <= last; ++row) {
+        const auto sourceIndex = m_sourceModel->index(row, 0);
+        if (auto timer = sourceIndex.data(ObjectModel::ObjectRole).value<QObject *>())
+            probe->addSignalSpySender(timer);
+    }
+}
+
+void TimerModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType())
+        setMonitored(static_cast<ModelEvent *>(event)->used());
+    QAbstractTableModel::customEvent(event);
+}
+
 bool TimerModel::isInitialized()
 {
     return s_timerModel != nullptr;
@@ -362,6 +431,7 @@ TimerModel *TimerModel::instance()
 
 void TimerModel::preSignalActivate(QObject *caller, int methodIndex)
 {
+    GAMMARAY_PROFILE_SCOPE("Timers", "timeout signal begin callback");
     // We are in the thread of the caller emitting the signal
     // The probe did NOT locked the objectLock at this point.
     Q_ASSERT(TimerModel::isInitialized());
@@ -391,6 +461,7 @@ void TimerModel::preSignalActivate(QObject *caller, int methodIndex)
 
 void TimerModel::postSignalActivate(QObject *caller, int methodIndex)
 {
+    GAMMARAY_PROFILE_SCOPE("Timers", "timeout signal end callback");
     // We are in the thread of the caller emitting the signal
     // The probe did unlock the objectLock at this point again but validated caller
     Q_ASSERT(TimerModel::isInitialized());
@@ -772,9 +843,11 @@ void TimerModel::slotBeginInsertRows(const QModelIndex &parent, int start, int e
     beginInsertRows(QModelIndex(), start, end);
 }
 
-void TimerModel::slotEndInsertRows()
+void TimerModel::slotEndInsertRows(const QModelIndex &parent, int start, int end)
 {
+    Q_UNUSED(parent);
     endInsertRows();
+    addSignalSpySenders(start, end);
 }
 
 void TimerModel::slotBeginReset()
@@ -791,4 +864,5 @@ void TimerModel::slotBeginReset()
 void TimerModel::slotEndReset()
 {
     endResetModel();
+    addSignalSpySenders(0, m_sourceModel->rowCount() - 1);
 }
@@ -90,6 +90,9 @@ public:
 public slots:
     void clearHistory();
 
+protected:
+    void customEvent(QEvent *event) override;
+
 private slots:
     void triggerPushChanges();
     void pushChanges();
@@ -98,7 +101,7 @@ private slots:
     void slotBeginRemoveRows(const QModelIndex &parent, int start, int end);
     void slotEndRemoveRows();
     void slotBeginInsertRows(const QModelIndex &parent, int start, int end);
-    void slotEndInsertRows();
+    void slotEndInsertRows(const QModelIndex &parent, int start, int end);
     void slotBeginReset();
     void slotEndReset();
 
@@ -108,6 +111,8 @@ private:
     const TimerIdInfo *findTimerInfo(const QModelIndex &index) const;
     bool canHandleCaller(QObject *caller, int methodIndex) const;
     void checkDispatcherStatus(QObject *object);
+    void setMonitored(bool monitored);
+    void addSignalSpySenders(int first, int last);
 
     static bool eventNotifyCallback(void *data[]);
 
@@ -126,6 +131,7 @@ private:
 
     TimerIdDataContainer m_gatheredTimersData;
     QMutex m_mutex; // protects m_gatheredTimersData
+    bool m_monitored;
 };
 
 }
@@ -30,7 +30,6 @@
 #include "timermodel.h"
 
 #include <core/objecttypefilterproxymodel.h>
-#include <core/signalspycallbackset.h>
 
 #include <common/objectbroker.h>
 #include <common/objectid.h>
@@ -76,27 +75,6 @@ public:
     }
 };
 
-static bool processCallback()
-{
-    return TimerModel::isInitialized();
-}
-
-static void signal_begin_callback(QObject *caller, int method_index, void **argv)
-{
-    Q_UNUSED(argv);
-    if (!processCallback())
-        return;
-    TimerModel::instance()->preSignalActivate(caller, method_index);
-}
-
-static void signal_end_callback(QObject *caller, int method_index)
-{
-    // NOTE: here and below the caller may be invalid, e.g. if it was deleted from a slot
-    if (!processCallback())
-        return;
-    TimerModel::instance()->postSignalActivate(caller, method_index);
-}
-
 TimerTop::TimerTop(Probe *probe, QObject *parent)
     : TimerTopInterface(parent)
 {
@@ -108,11 +86,6 @@ TimerTop::TimerTop(Probe *probe, QObject *parent)
     TimerModel::instance()->setParent(this); // otherwise it's not filtered out
     TimerModel::instance()->setSourceModel(filterModel);
 
-    SignalSpyCallbackSet callbacks;
-    callbacks.signalBeginCallback = signal_begin_callback;
-    callbacks.signalEndCallback = signal_end_callback;
-    probe->registerSignalSpyCallbackSet(callbacks);
-
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.TimerModel"), TimerModel::instance());
     m_selectionModel = ObjectBroker::selectionModel(TimerModel::instance());
 
@@ -0,0 +1,138 @@
+/*
+  translationcontextmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "translationcontextmodel.h"
+
+#include <cstring>
+
+using namespace GammaRay;
+
+TranslationContextModel::TranslationContextModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_mutex(QMutex::Recursive)
+    , m_rowCount(0)
+    , m_flushPending(false)
+{
+}
+
+TranslationContextModel::~TranslationContextModel() = default;
+
+int TranslationContextModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 4;
+}
+
+int TranslationContextModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rowCount;
+}
+
+QVariant TranslationContextModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    QMutexLocker lock(&m_mutex);
+    const auto &row = m_rows.at(index.row());
+    switch (index.column()) {
+    case 0:
+        return row.context;
+    case 1:
+        return row.lookups;
+    case 2:
+        return row.hits;
+    case 3:
+        return double(row.lookupTime / 1000) / 1000.0;
+    }
+    return QVariant();
+}
+
+QVariant TranslationContextModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case 0:
+            return tr("Context");
+        case 1:
+            return tr("Lookups");
+        case 2:
+            return tr("Hits");
+        case 3:
+            return tr("Time [ms]");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void TranslationContextModel::recordLookup(const char *context, bool hit, qint64 nsecs)
+{
+    const uint h = (context && *context) ? qHashBits(context, std::strlen(context)) : 0;
+    QMutexLocker lock(&m_mutex);
+    int row = -1;
+    for (auto it = m_index.constFind(h); it != m_index.constEnd() && it.key() == h; ++it) {
+        if (m_rows.at(it.value()).context == context) {
+            row = it.value();
+            break;
+        }
+    }
+    if (row < 0) {
+        Row newRow;
+        newRow.context = context;
+        row = m_rows.size();
+        m_rows.push_back(newRow);
+        m_index.insert(h, row);
+    }
+
+    auto &stats = m_rows[row];
+    ++stats.lookups;
+    if (hit)
+        ++stats.hits;
+    stats.lookupTime += nsecs;
+
+    if (!m_flushPending) {
+        m_flushPending = true;
+        QMetaObject::invokeMethod(this, "flushPending", Qt::QueuedConnection);
+    }
+}
+
+void TranslationContextModel::flushPending()
+{
+    QMutexLocker lock(&m_mutex);
+    m_flushPending = false;
+
+    if (m_rowCount > 0)
+        emit dataChanged(index(0, 1), index(m_rowCount - 1, columnCount() - 1));
+
+    if (m_rowCount < m_rows.size()) {
+        beginInsertRows(QModelIndex(), m_rowCount, m_rows.size() - 1);
+        m_rowCount = m_rows.size();
+        endInsertRows();
+    }
+}
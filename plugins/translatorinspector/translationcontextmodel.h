@@ -0,0 +1,81 @@
+/*
+  translationcontextmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_TRANSLATIONCONTEXTMODEL_H
+#define GAMMARAY_TRANSLATIONCONTEXTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMultiHash>
+#include <QMutex>
+#include <QVector>
+
+namespace GammaRay {
+
+/** Translation lookup statistics per context, over all translators. */
+class TranslationContextModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit TranslationContextModel(QObject *parent = nullptr);
+    ~TranslationContextModel() override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    /**
+     * Records a lookup in a single translator. A lookup by the application
+     * asks translators in turn until one has a translation, so lookups count
+     * the per-translator work the time is spent on. Every lookup that reaches
+     * the end of the translator chain hits exactly one translator (the fallback
+     * one if nothing else), so hits count the lookups made by the application.
+     * Called in the thread doing the lookup.
+     */
+    void recordLookup(const char *context, bool hit, qint64 nsecs);
+
+private slots:
+    void flushPending();
+
+private:
+    struct Row
+    {
+        QByteArray context;
+        quint64 lookups = 0;
+        quint64 hits = 0;
+        qint64 lookupTime = 0;
+    };
+    mutable QMutex m_mutex; // protects everything below
+    QVector<Row> m_rows;
+    QMultiHash<uint, int> m_index;
+    int m_rowCount;
+    bool m_flushPending;
+};
+}
+
+#endif // GAMMARAY_TRANSLATIONCONTEXTMODEL_H
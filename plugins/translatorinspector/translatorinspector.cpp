@@ -27,6 +27,7 @@
 */
 
 #include "translatorinspector.h"
+#include "translationcontextmodel.h"
 #include "translatorwrapper.h"
 #include "translatorsmodel.h"
 
@@ -41,13 +42,19 @@
 
 #include <QCoreApplication>
 #include <QItemSelectionModel>
+#include <QTimer>
 #include <private/qcoreapplication_p.h>
 
+#include <algorithm>
+
 using namespace GammaRay;
 
 TranslatorInspector::TranslatorInspector(Probe *probe, QObject *parent)
     : TranslatorInspectorInterface(QStringLiteral("com.kdab.GammaRay.TranslatorInspector"), parent)
     , m_probe(probe)
+    , m_contextModel(new TranslationContextModel(this))
+    , m_retranslationHitCount(0)
+    , m_retranslating(false)
 {
     registerMetaTypes();
 
@@ -67,7 +74,12 @@ TranslatorInspector::TranslatorInspector(Probe *probe, QObject *parent)
     m_translationsSelectionModel
         = ObjectBroker::selectionModel(m_translationsModel);
 
+    auto contextProxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    contextProxy->setSourceModel(m_contextModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.TranslationContextModel"), contextProxy);
+
     m_fallbackWrapper = new TranslatorWrapper(new FallbackTranslator(this), this);
+    m_fallbackWrapper->setContextModel(m_contextModel);
     m_translatorsModel->registerTranslator(m_fallbackWrapper);
     QCoreApplicationPrivate *obj = static_cast<QCoreApplicationPrivate *>(
         QCoreApplicationPrivate::get(qApp));
@@ -103,7 +115,16 @@ void TranslatorInspector::resetTranslations()
 
 bool TranslatorInspector::eventFilter(QObject *object, QEvent *event)
 {
-    if (event->type() == QEvent::LanguageChange) {
+    // the application-wide event is sent first, widgets get theirs posted from there
+    if (event->type() == QEvent::LanguageChange && object == qApp) {
+        if (!m_retranslating) {
+            m_retranslating = true;
+            m_retranslationHitCount = totalHitCount();
+            m_retranslationTimer.start();
+            // posted events are delivered before this fires, ie. this covers the entire cascade
+            QTimer::singleShot(0, this, &TranslatorInspector::retranslationFinished);
+        }
+
         QCoreApplicationPrivate *obj = static_cast<QCoreApplicationPrivate *>(
             QCoreApplicationPrivate::get(qApp));
         for (int i = 0; i < obj->translators.size(); ++i) {
@@ -115,6 +136,7 @@ bool TranslatorInspector::eventFilter(QObject *object, QEvent *event)
                  * translator
                  */
                 auto wrapper = new TranslatorWrapper(obj->translators.at(i), this);
+                wrapper->setContextModel(m_contextModel);
                 obj->translators[i] = wrapper;
                 m_translatorsModel->registerTranslator(wrapper);
                 connect(wrapper, &TranslatorWrapper::destroyed, m_translationsModel, [wrapper, this](QObject*) {
@@ -131,6 +153,29 @@ bool TranslatorInspector::eventFilter(QObject *object, QEvent *event)
     return QObject::eventFilter(object, event);
 }
 
+void TranslatorInspector::retranslationFinished()
+{
+    m_retranslating = false;
+    const double msecs = m_retranslationTimer.nsecsElapsed() / 1000000.0;
+    // lookups end at exactly one translator returning a result, so hits count the lookups
+    setLastRetranslationLookups(int(totalHitCount() - m_retranslationHitCount));
+    setLastRetranslationTime(msecs);
+    setMaxRetranslationTime(std::max(maxRetranslationTime(), msecs));
+    setRetranslationCount(retranslationCount() + 1);
+}
+
+quint64 TranslatorInspector::totalHitCount() const
+{
+    const QCoreApplicationPrivate *obj = static_cast<QCoreApplicationPrivate *>(
+        QCoreApplicationPrivate::get(qApp));
+    quint64 count = 0;
+    for (auto translator : obj->translators) {
+        if (auto wrapper = qobject_cast<TranslatorWrapper *>(translator))
+            count += wrapper->hitCount();
+    }
+    return count;
+}
+
 void TranslatorInspector::selectionChanged(const QItemSelection &selection)
 {
     m_translationsModel->setSourceModel(nullptr);
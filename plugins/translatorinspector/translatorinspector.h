@@ -34,6 +34,7 @@
 #include <core/toolfactory.h>
 
 #include <QAbstractItemModel>
+#include <QElapsedTimer>
 #include <QTranslator>
 
 QT_BEGIN_NAMESPACE
@@ -43,6 +44,7 @@ class QAbstractProxyModel;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class TranslationContextModel;
 class TranslatorsModel;
 class TranslatorWrapper;
 class FallbackTranslator;
@@ -62,12 +64,14 @@ public slots:
 private slots:
     void selectionChanged(const QItemSelection &selection);
     void objectSelected(QObject *obj);
+    void retranslationFinished();
 
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
 
 private:
     void registerMetaTypes();
+    quint64 totalHitCount() const;
 
     QItemSelectionModel *m_selectionModel;
     QItemSelectionModel *m_translationsSelectionModel;
@@ -75,6 +79,11 @@ private:
     QAbstractProxyModel *m_translationsModel;
     Probe *m_probe;
     TranslatorWrapper *m_fallbackWrapper;
+    TranslationContextModel *m_contextModel;
+
+    QElapsedTimer m_retranslationTimer;
+    quint64 m_retranslationHitCount;
+    bool m_retranslating;
 };
 
 class TranslatorInspectorFactory : public QObject,
@@ -40,3 +40,55 @@ TranslatorInspectorInterface::TranslatorInspectorInterface(const QString &name,
 }
 
 TranslatorInspectorInterface::~TranslatorInspectorInterface() = default;
+
+int TranslatorInspectorInterface::retranslationCount() const
+{
+    return m_retranslationCount;
+}
+
+void TranslatorInspectorInterface::setRetranslationCount(int count)
+{
+    if (m_retranslationCount == count)
+        return;
+    m_retranslationCount = count;
+    emit retranslationStatisticsChanged();
+}
+
+double TranslatorInspectorInterface::lastRetranslationTime() const
+{
+    return m_lastRetranslationTime;
+}
+
+void TranslatorInspectorInterface::setLastRetranslationTime(double msecs)
+{
+    if (m_lastRetranslationTime == msecs)
+        return;
+    m_lastRetranslationTime = msecs;
+    emit retranslationStatisticsChanged();
+}
+
+double TranslatorInspectorInterface::maxRetranslationTime() const
+{
+    return m_maxRetranslationTime;
+}
+
+void TranslatorInspectorInterface::setMaxRetranslationTime(double msecs)
+{
+    if (m_maxRetranslationTime == msecs)
+        return;
+    m_maxRetranslationTime = msecs;
+    emit retranslationStatisticsChanged();
+}
+
+int TranslatorInspectorInterface::lastRetranslationLookups() const
+{
+    return m_lastRetranslationLookups;
+}
+
+void TranslatorInspectorInterface::setLastRetranslationLookups(int lookups)
+{
+    if (m_lastRetranslationLookups == lookups)
+        return;
+    m_lastRetranslationLookups = lookups;
+    emit retranslationStatisticsChanged();
+}
@@ -35,6 +35,10 @@ namespace GammaRay {
 class TranslatorInspectorInterface : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(int retranslationCount READ retranslationCount WRITE setRetranslationCount NOTIFY retranslationStatisticsChanged)
+    Q_PROPERTY(double lastRetranslationTime READ lastRetranslationTime WRITE setLastRetranslationTime NOTIFY retranslationStatisticsChanged)
+    Q_PROPERTY(double maxRetranslationTime READ maxRetranslationTime WRITE setMaxRetranslationTime NOTIFY retranslationStatisticsChanged)
+    Q_PROPERTY(int lastRetranslationLookups READ lastRetranslationLookups WRITE setLastRetranslationLookups NOTIFY retranslationStatisticsChanged)
 
 public:
     explicit TranslatorInspectorInterface(const QString &name, QObject *parent);
@@ -42,12 +46,32 @@ public:
 
     const QString &name() const { return m_name; }
 
+    /// number of LanguageChange cascades seen so far
+    int retranslationCount() const;
+    void setRetranslationCount(int count);
+    /// duration of the last LanguageChange cascade, in milliseconds
+    double lastRetranslationTime() const;
+    void setLastRetranslationTime(double msecs);
+    /// duration of the longest LanguageChange cascade, in milliseconds
+    double maxRetranslationTime() const;
+    void setMaxRetranslationTime(double msecs);
+    /// number of translation lookups during the last LanguageChange cascade
+    int lastRetranslationLookups() const;
+    void setLastRetranslationLookups(int lookups);
+
 public slots:
     virtual void sendLanguageChangeEvent() = 0;
     virtual void resetTranslations() = 0;
 
+signals:
+    void retranslationStatisticsChanged();
+
 private:
     QString m_name;
+    int m_retranslationCount = 0;
+    double m_lastRetranslationTime = 0.0;
+    double m_maxRetranslationTime = 0.0;
+    int m_lastRetranslationLookups = 0;
 };
 }
 
@@ -94,7 +94,17 @@ TranslatorInspectorWidget::TranslatorInspectorWidget(QWidget *parent)
         new SearchLineController(ui->translationsSearchLine, ui->translationsView->model());
     }
 
+    ui->contextView->header()->setObjectName("contextViewHeader");
+    ui->contextView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    ui->contextView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.TranslationContextModel")));
+    ui->contextView->sortByColumn(3, Qt::DescendingOrder); // time
+
     m_stateManager.setDefaultSizes(ui->mainSplitter, UISizeVector() << "50%" << "50%");
+    m_stateManager.setDefaultSizes(ui->translatorSplitter, UISizeVector() << "50%" << "50%");
+
+    connect(m_inspector, &TranslatorInspectorInterface::retranslationStatisticsChanged,
+            this, &TranslatorInspectorWidget::updateRetranslationStatistics);
+    updateRetranslationStatistics();
 
     connect(ui->actionSendLanguageChange, &QAction::triggered, m_inspector, &TranslatorInspectorInterface::sendLanguageChangeEvent);
     connect(ui->actionReset, &QAction::triggered, m_inspector, &TranslatorInspectorInterface::resetTranslations);
@@ -136,6 +146,19 @@ void TranslatorInspectorWidget::updateActions()
     ui->actionReset->setEnabled(!ui->translationsView->selectionModel()->selectedRows().isEmpty());
 }
 
+void TranslatorInspectorWidget::updateRetranslationStatistics()
+{
+    if (m_inspector->retranslationCount() == 0) {
+        ui->retranslationLabel->setText(tr("No LanguageChange event seen yet."));
+        return;
+    }
+    ui->retranslationLabel->setText(
+        tr("LanguageChange events: %1, last: %2 ms with %3 lookups, max: %4 ms")
+            .arg(m_inspector->retranslationCount())
+            .arg(m_inspector->lastRetranslationTime(), 0, 'f', 1)
+            .arg(m_inspector->lastRetranslationLookups())
+            .arg(m_inspector->maxRetranslationTime(), 0, 'f', 1));
+}
 
 static QObject *translatorInspectorClientFactory(const QString &name, QObject *parent)
 {
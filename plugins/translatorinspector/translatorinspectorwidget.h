@@ -65,6 +65,7 @@ private:
     void translatorContextMenu(QPoint pos);
     void translationsContextMenu(QPoint pos);
     void updateActions();
+    void updateRetranslationStatistics();
 
     QScopedPointer<Ui::TranslatorInspectorWidget> ui;
     UIStateManager m_stateManager;
@@ -30,20 +30,29 @@
 
 #include <core/util.h>
 
+#include <common/modelevent.h>
 #include <common/objectid.h>
+#include <compat/qasconst.h>
 
 #include "translatorwrapper.h"
 
+#include <QTimer>
+
 using namespace GammaRay;
 
 TranslatorsModel::TranslatorsModel(QObject *parent)
     : QAbstractTableModel(parent)
+    , m_refreshTimer(new QTimer(this))
+    , m_lookupCount(0)
 {
+    // only polled while a client is looking at the statistics
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &TranslatorsModel::refreshStatistics);
 }
 
 int TranslatorsModel::columnCount(const QModelIndex &) const
 {
-    return 3;
+    return 6;
 }
 
 int TranslatorsModel::rowCount(const QModelIndex &parent) const
@@ -69,6 +78,12 @@ QVariant TranslatorsModel::data(const QModelIndex &index, int role) const
             return QString(trans->translator()->metaObject()->className());
         else if (index.column() == 2)
             return trans->model()->rowCount(QModelIndex());
+        else if (index.column() == 3)
+            return trans->lookupCount();
+        else if (index.column() == 4)
+            return trans->lookupCount() ? qRound(trans->hitCount() * 1000.0 / trans->lookupCount()) / 10.0 : QVariant();
+        else if (index.column() == 5)
+            return double(trans->lookupTime() / 1000) / 1000.0;
     } else if (role == Qt::ToolTipRole) {
         return Util::tooltipForObject(trans->translator());
     }
@@ -84,6 +99,12 @@ QVariant TranslatorsModel::headerData(int section, Qt::Orientation orientation,
             return tr("Type");
         else if (section == 2)
             return tr("Translations");
+        else if (section == 3)
+            return tr("Lookups");
+        else if (section == 4)
+            return tr("Hits [%]");
+        else if (section == 5)
+            return tr("Time [ms]");
     }
     return QVariant();
 }
@@ -115,6 +136,30 @@ void TranslatorsModel::sourceDataChanged()
                      QVector<int>() << Qt::DisplayRole << Qt::EditRole);
 }
 
+void TranslatorsModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        if (static_cast<ModelEvent *>(event)->used()) {
+            refreshStatistics();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    }
+    QAbstractTableModel::customEvent(event);
+}
+
+void TranslatorsModel::refreshStatistics()
+{
+    quint64 lookupCount = 0;
+    for (auto translator : qAsConst(m_translators))
+        lookupCount += translator->lookupCount();
+    if (lookupCount == m_lookupCount || m_translators.isEmpty())
+        return;
+    m_lookupCount = lookupCount;
+    emit dataChanged(index(0, 3), index(m_translators.size() - 1, columnCount() - 1));
+}
+
 void TranslatorsModel::registerTranslator(TranslatorWrapper *translator)
 {
     beginInsertRows(QModelIndex(), 0, 0);
@@ -31,6 +31,10 @@
 
 #include <QAbstractTableModel>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 class TranslatorWrapper;
 
@@ -58,11 +62,17 @@ public slots:
     void registerTranslator(TranslatorWrapper *translator);
     void unregisterTranslator(TranslatorWrapper *translator);
 
+protected:
+    void customEvent(QEvent *event) override;
+
 private slots:
     void sourceDataChanged();
+    void refreshStatistics();
 
 private:
     QList<TranslatorWrapper *> m_translators;
+    QTimer *m_refreshTimer;
+    quint64 m_lookupCount;
 };
 }
 
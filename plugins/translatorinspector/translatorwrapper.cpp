@@ -27,14 +27,24 @@
 */
 
 #include "translatorwrapper.h"
+#include "translationcontextmodel.h"
 
+#include <QElapsedTimer>
 #include <QItemSelection>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace GammaRay;
 
 TranslationsModel::TranslationsModel(TranslatorWrapper *translator)
     : QAbstractTableModel(translator)
     , m_translator(translator)
+    , m_mutex(QMutex::Recursive)
+    , m_rowCount(0)
+    , m_firstDirtyRow(-1)
+    , m_lastDirtyRow(-1)
+    , m_flushPending(false)
 {
     connect(this, &QAbstractItemModel::rowsInserted,
             this, &TranslationsModel::rowCountChanged);
@@ -46,19 +56,20 @@ int TranslationsModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_nodes.size();
+    return m_rowCount;
 }
 
 int TranslationsModel::columnCount(const QModelIndex &) const
 {
-    return 4;
+    return 6;
 }
 
 QVariant TranslationsModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid())
         return QVariant();
-    Row node = m_nodes.at(index.row());
+    QMutexLocker lock(&m_mutex);
+    const Row &node = m_nodes.at(index.row());
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         switch (index.column()) {
         case 0:
@@ -69,6 +80,10 @@ QVariant TranslationsModel::data(const QModelIndex &index, int role) const
             return node.disambiguation;
         case 3:
             return node.translation;
+        case 4:
+            return node.lookups;
+        case 5:
+            return double(node.lookupTime / 10) / 100.0;
         }
     }
     if (role == IsOverriddenRole && index.column() == 3) {
@@ -80,6 +95,7 @@ QVariant TranslationsModel::data(const QModelIndex &index, int role) const
 bool TranslationsModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
     if (role == Qt::EditRole && index.column() == 3) {
+        QMutexLocker lock(&m_mutex);
         Row &node = m_nodes[index.row()];
         if (node.translation == value.toString())
             return true;
@@ -104,6 +120,7 @@ QMap<int, QVariant> TranslationsModel::itemData(const QModelIndex &index) const
 {
     auto data = QAbstractTableModel::itemData(index);
     if (hasIndex(index.row(), index.column(), index.parent())) {
+        QMutexLocker lock(&m_mutex);
         if (index.column() == 3)
             data[IsOverriddenRole] = m_nodes.at(index.row()).isOverridden;
     }
@@ -114,6 +131,9 @@ void TranslationsModel::resetTranslations(const QItemSelection &selection)
 {
     if (selection.isEmpty())
         return;
+    // the removals and the index rebuild must not interleave with lookups in other threads
+    QMutexLocker lock(&m_mutex);
+    flushPending();
 
     // The mapping to source make the linear selection ... non linear
     // Let rebuild linear ranges to avoid overflood...
@@ -139,71 +159,146 @@ void TranslationsModel::resetTranslations(const QItemSelection &selection)
         const auto &range = ranges[i];
         beginRemoveRows(QModelIndex(), range.first, range.second);
         m_nodes.remove(range.first, range.second - range.first + 1);
+        m_rowCount = m_nodes.size();
         endRemoveRows();
     }
+    rebuildIndex();
 }
 
 QString TranslationsModel::translation(const char *context, const char *sourceText,
                                        const char *disambiguation, const int n,
-                                       const QString &default_)
+                                       const QString &default_, qint64 nsecs)
 {
-    QModelIndex existingIndex
-        = findNode(context, sourceText, disambiguation, n, true);
-    Row &row = m_nodes[existingIndex.row()];
-    if (!row.isOverridden)
-        setTranslation(existingIndex, default_);
-    return row.translation;
+    QMutexLocker lock(&m_mutex);
+    const int row = findNode(context, sourceText, disambiguation, n, true);
+    auto &node = m_nodes[row];
+    ++node.lookups;
+    node.lookupTime += nsecs;
+    setTranslation(row, default_);
+    markDirty(row);
+    return node.translation;
 }
 
 void TranslationsModel::resetAllUnchanged()
 {
+    QMutexLocker lock(&m_mutex);
+    flushPending();
+    QItemSelection selection;
     for (int i = 0; i < m_nodes.size(); ++i) {
-        if (!m_nodes[i].isOverridden)
-            resetTranslations(QItemSelection(index(i, 0), index(i, 0)));
+        if (!m_nodes.at(i).isOverridden)
+            selection.select(index(i, 0), index(i, 0));
     }
+    resetTranslations(selection);
 }
 
-void TranslationsModel::setTranslation(const QModelIndex &index, const QString &translation)
+void TranslationsModel::setTranslation(int row, const QString &translation)
 {
-    if (!index.isValid())
+    auto &node = m_nodes[row];
+    if (node.isOverridden || node.translation == translation)
         return;
+    node.translation = translation;
+    markDirty(row);
+}
 
-    auto &row = m_nodes[index.row()];
-    if (row.isOverridden || row.translation == translation)
+void TranslationsModel::markDirty(int row)
+{
+    // rows not announced yet are covered by the pending rowsInserted() emission
+    if (row >= m_rowCount)
         return;
-    row.translation = translation;
-    emit dataChanged(index, index);
+    if (m_firstDirtyRow < 0) {
+        m_firstDirtyRow = m_lastDirtyRow = row;
+    } else {
+        m_firstDirtyRow = std::min(m_firstDirtyRow, row);
+        m_lastDirtyRow = std::max(m_lastDirtyRow, row);
+    }
+    scheduleFlush();
+}
+
+void TranslationsModel::scheduleFlush()
+{
+    if (m_flushPending)
+        return;
+    m_flushPending = true;
+    QMetaObject::invokeMethod(this, "flushPending", Qt::QueuedConnection);
+}
+
+void TranslationsModel::flushPending()
+{
+    QMutexLocker lock(&m_mutex);
+    m_flushPending = false;
+
+    if (m_firstDirtyRow >= 0) {
+        emit dataChanged(index(m_firstDirtyRow, 3), index(m_lastDirtyRow, columnCount() - 1));
+        m_firstDirtyRow = m_lastDirtyRow = -1;
+    }
+
+    if (m_rowCount < m_nodes.size()) {
+        beginInsertRows(QModelIndex(), m_rowCount, m_nodes.size() - 1);
+        m_rowCount = m_nodes.size();
+        endInsertRows();
+    }
+}
+
+uint TranslationsModel::keyHash(const char *context, const char *sourceText,
+                                const char *disambiguation)
+{
+    // hashes the raw strings, so lookups don't need to allocate
+    uint h = 0;
+    for (const char *str : { context, sourceText, disambiguation }) {
+        if (str && *str)
+            h = qHashBits(str, std::strlen(str), h);
+        h = 31 * h + 1; // separator, so ("ab", "c") and ("a", "bc") differ
+    }
+    return h;
 }
 
-QModelIndex TranslationsModel::findNode(const char *context, const char *sourceText,
-                                        const char *disambiguation, const int n, const bool create)
+int TranslationsModel::findNode(const char *context, const char *sourceText,
+                                const char *disambiguation, const int n, const bool create)
 {
     Q_UNUSED(n);
     // QUESTION make use of n?
-    for (int i = 0; i < m_nodes.size(); ++i) {
-        const Row &node = m_nodes.at(i);
+    const uint h = keyHash(context, sourceText, disambiguation);
+    for (auto it = m_index.constFind(h); it != m_index.constEnd() && it.key() == h; ++it) {
+        const Row &node = m_nodes.at(it.value());
+        // QByteArray::operator==(const char*) doesn't allocate
         if (node.context == context && node.sourceText == sourceText
             && node.disambiguation == disambiguation)
-            return index(i, 0);
+            return it.value();
     }
-    if (create) {
-        Row node;
-        node.context = context;
-        node.sourceText = sourceText;
-        node.disambiguation = disambiguation;
-        const int newRow = m_nodes.size();
-        beginInsertRows(QModelIndex(), newRow, newRow);
-        m_nodes.append(node);
-        endInsertRows();
-        return index(newRow, 0);
+    if (!create)
+        return -1;
+
+    // new rows are announced in batches, retranslating a UI adds thousands of them at once
+    Row node;
+    node.context = context;
+    node.sourceText = sourceText;
+    node.disambiguation = disambiguation;
+    const int newRow = m_nodes.size();
+    m_nodes.append(node);
+    m_index.insert(h, newRow);
+    scheduleFlush();
+    return newRow;
+}
+
+void TranslationsModel::rebuildIndex()
+{
+    m_index.clear();
+    m_index.reserve(m_nodes.size());
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        const Row &node = m_nodes.at(i);
+        m_index.insert(keyHash(node.context.constData(), node.sourceText.constData(),
+                               node.disambiguation.constData()), i);
     }
-    return {};
 }
 
 TranslatorWrapper::TranslatorWrapper(QTranslator *wrapped, QObject *parent)
     : QTranslator(parent)
     , m_wrapped(wrapped)
     , m_model(new TranslationsModel(this))
+    , m_contextModel(nullptr)
+    , m_lookupCount(0)
+    , m_hitCount(0)
+    , m_lookupTime(0)
 {
     Q_ASSERT(wrapped);
 
@@ -221,21 +316,32 @@ bool TranslatorWrapper::isEmpty() const
 QString TranslatorWrapper::translate(const char *context, const char *sourceText,
                                      const char *disambiguation, int n) const
 {
-    const QString translation = translateInternal(context, sourceText, disambiguation, n);
+    qint64 nsecs = 0;
+    const QString translation = translateInternal(context, sourceText, disambiguation, n, &nsecs);
 
     if (context && strncmp(context, "GammaRay::", 10) == 0)
         return translation;
+
+    m_lookupCount.fetchAndAddRelaxed(1);
+    m_lookupTime.fetchAndAddRelaxed(nsecs);
+    if (m_contextModel)
+        m_contextModel->recordLookup(context, !translation.isNull(), nsecs);
     // it's not for this translator
     if (translation.isNull())
         return translation;
-    return m_model->translation(context, sourceText, disambiguation, n, translation);
+    m_hitCount.fetchAndAddRelaxed(1);
+    return m_model->translation(context, sourceText, disambiguation, n, translation, nsecs);
 }
 
 QString TranslatorWrapper::translateInternal(const char *context, const char *sourceText,
-                                             const char *disambiguation, int n)
+                                             const char *disambiguation, int n, qint64 *nsecs)
 const
 {
-    return translator()->translate(context, sourceText, disambiguation, n);
+    QElapsedTimer timer;
+    timer.start();
+    const auto translation = translator()->translate(context, sourceText, disambiguation, n);
+    *nsecs = timer.nsecsElapsed();
+    return translation;
 }
 
 QTranslator *TranslatorWrapper::translator() const
@@ -244,6 +350,26 @@ QTranslator *TranslatorWrapper::translator() const
     return m_wrapped;
 }
 
+void TranslatorWrapper::setContextModel(TranslationContextModel *model)
+{
+    m_contextModel = model;
+}
+
+quint64 TranslatorWrapper::lookupCount() const
+{
+    return m_lookupCount.loadAcquire();
+}
+
+quint64 TranslatorWrapper::hitCount() const
+{
+    return m_hitCount.loadAcquire();
+}
+
+qint64 TranslatorWrapper::lookupTime() const
+{
+    return m_lookupTime.loadAcquire();
+}
+
 FallbackTranslator::FallbackTranslator(QObject *parent)
     : QTranslator(parent)
 {
@@ -32,6 +32,9 @@
 #include <common/modelroles.h>
 
 #include <QAbstractItemModel>
+#include <QAtomicInteger>
+#include <QMultiHash>
+#include <QMutex>
 #include <QTranslator>
 
 QT_BEGIN_NAMESPACE
@@ -39,6 +42,7 @@ class QItemSelection;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class TranslationContextModel;
 class TranslatorWrapper;
 
 class TranslationsModel : public QAbstractTableModel
@@ -60,8 +64,9 @@ public:
     QMap<int, QVariant> itemData(const QModelIndex &index) const override;
 
     void resetTranslations(const QItemSelection &selection);
+    /// records a lookup that took @p nsecs in the wrapped translator, called in any thread
     QString translation(const char *context, const char *sourceText, const char *disambiguation,
-                        const int n, const QString &default_);
+                        const int n, const QString &default_, qint64 nsecs);
 
     void resetAllUnchanged();
 
@@ -73,10 +78,16 @@ public:
 signals:
     void rowCountChanged();
 
+private slots:
+    void flushPending();
+
 private:
     friend class TranslatorWrapper;
     TranslatorWrapper *m_translator;
 
+    /// protects the rows, the index and the pending change state
+    mutable QMutex m_mutex;
+
     struct Row
     {
         Row() = default;
@@ -85,12 +96,27 @@ private:
         QByteArray disambiguation;
         QString translation;
         bool isOverridden = false;
+        quint64 lookups = 0;
+        qint64 lookupTime = 0;
     };
+    /// all rows, including the ones not yet announced to the views
     QVector<Row> m_nodes;
-
-    QModelIndex findNode(const char *context, const char *sourceText, const char *disambiguation,
-                         const int n, const bool create);
-    void setTranslation(const QModelIndex &index, const QString &translation);
+    /// row indexes by key hash, see keyHash()
+    QMultiHash<uint, int> m_index;
+    /// number of rows announced to the views
+    int m_rowCount;
+    /// range of announced rows with pending dataChanged() emission
+    int m_firstDirtyRow;
+    int m_lastDirtyRow;
+    bool m_flushPending;
+
+    static uint keyHash(const char *context, const char *sourceText, const char *disambiguation);
+    int findNode(const char *context, const char *sourceText, const char *disambiguation,
+                 const int n, const bool create);
+    void setTranslation(int row, const QString &translation);
+    void markDirty(int row);
+    void scheduleFlush();
+    void rebuildIndex();
 };
 
 class TranslatorWrapper : public QTranslator
@@ -107,12 +133,26 @@ public:
                       int n) const override;
     QTranslator *translator() const;
 
+    /// also record lookup statistics per context in @p model
+    void setContextModel(TranslationContextModel *model);
+
+    /// number of lookups in the wrapped translator
+    quint64 lookupCount() const;
+    /// number of lookups the wrapped translator returned a translation for
+    quint64 hitCount() const;
+    /// total time spent in the wrapped translator, in nanoseconds
+    qint64 lookupTime() const;
+
 private:
     QTranslator *m_wrapped;
     TranslationsModel *m_model;
+    TranslationContextModel *m_contextModel;
+    mutable QAtomicInteger<quint64> m_lookupCount;
+    mutable QAtomicInteger<quint64> m_hitCount;
+    mutable QAtomicInteger<qint64> m_lookupTime;
 
     QString translateInternal(const char *context, const char *sourceText,
-                              const char *disambiguation, int n) const;
+                              const char *disambiguation, int n, qint64 *nsecs) const;
 };
 
 class FallbackTranslator : public QTranslator
@@ -67,6 +67,10 @@ QVariant TranslatorWrapperProxy::headerData(int section, Qt::Orientation orienta
             return tr("Disambiguation");
         case 3:
             return tr("Translation");
+        case 4:
+            return tr("Lookups");
+        case 5:
+            return tr("Time [µs]");
         }
     }
     return QAbstractItemModel::headerData(section, orientation, role);
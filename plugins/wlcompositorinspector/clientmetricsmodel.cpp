@@ -0,0 +1,263 @@
+/*
+  clientmetricsmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "clientmetricsmodel.h"
+#include "resourceinfo.h"
+#include "rollinghistogram.h"
+
+#include <core/util.h>
+
+#include <compat/qasconst.h>
+
+#include <QHash>
+#include <QTimer>
+#include <QWaylandSurface>
+
+#include <wayland-server.h>
+
+using namespace GammaRay;
+
+static const qint64 Window = 5000000000LL; // 5s
+
+struct ClientMetricsModel::Metrics
+{
+    explicit Metrics(wl_client *c)
+        : client(c)
+        , pid(0)
+        , frameLatency(Window)
+        , bufferTurnaround(Window)
+        , damage(Window)
+    {
+        wl_client_get_credentials(c, &pid, nullptr, nullptr);
+    }
+
+    wl_client *client;
+    pid_t pid;
+
+    RollingHistogram frameLatency;
+    RollingHistogram bufferTurnaround;
+    // one sample per commit, so this also gives the commit rate
+    RollingHistogram damage;
+
+    QHash<uint32_t, qint64> pendingFrames;
+    QHash<wl_resource *, qint64> attachedBuffers;
+    QHash<wl_resource *, qint64> pendingDamage;
+};
+
+static qint64 clippedArea(wl_resource *surfaceResource, const wl_argument *args)
+{
+    qint64 x0 = args[0].i;
+    qint64 y0 = args[1].i;
+    qint64 x1 = x0 + args[2].i;
+    qint64 y1 = y0 + args[3].i;
+
+    // clients commonly damage INT32_MAX sized rectangles to mean "everything"
+    if (auto surface = QWaylandSurface::fromResource(surfaceResource)) {
+        const QSize size = surface->size();
+        x0 = qMax<qint64>(0, x0);
+        y0 = qMax<qint64>(0, y0);
+        x1 = qMin<qint64>(size.width(), x1);
+        y1 = qMin<qint64>(size.height(), y1);
+    }
+
+    if (x1 <= x0 || y1 <= y0)
+        return 0;
+    return (x1 - x0) * (y1 - y0);
+}
+
+ClientMetricsModel::ClientMetricsModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_updateTimer(new QTimer(this))
+{
+    m_time.start();
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, &QTimer::timeout, this, &ClientMetricsModel::update);
+    m_updateTimer->start();
+}
+
+ClientMetricsModel::~ClientMetricsModel()
+{
+    qDeleteAll(m_clients);
+}
+
+ClientMetricsModel::Metrics *ClientMetricsModel::metrics(wl_client *client)
+{
+    for (Metrics *m : qAsConst(m_clients)) {
+        if (m->client == client)
+            return m;
+    }
+
+    beginInsertRows(QModelIndex(), m_clients.count(), m_clients.count());
+    auto *m = new Metrics(client);
+    m_clients.push_back(m);
+    endInsertRows();
+    return m;
+}
+
+void ClientMetricsModel::protocolMessage(int type, const wl_protocol_logger_message *message)
+{
+    wl_resource *resource = message->resource;
+    const char *name = message->message->name;
+    const qint64 now = m_time.nsecsElapsed();
+    const ResourceInfo info(resource);
+    Metrics *m = metrics(wl_resource_get_client(resource));
+
+    if (type == WL_PROTOCOL_LOGGER_REQUEST) {
+        if (info.isInterface(&wl_surface_interface)) {
+            if (qstrcmp(name, "commit") == 0) {
+                m->damage.add(now, m->pendingDamage.take(resource));
+            } else if (qstrcmp(name, "frame") == 0) {
+                m->pendingFrames.insert(message->arguments[0].n, now);
+            } else if (qstrcmp(name, "attach") == 0) {
+                if (auto buffer = reinterpret_cast<wl_resource *>(message->arguments[0].o))
+                    m->attachedBuffers.insert(buffer, now);
+            } else if (qstrcmp(name, "damage") == 0 || qstrcmp(name, "damage_buffer") == 0) {
+                m->pendingDamage[resource] += clippedArea(resource, message->arguments);
+            } else if (qstrcmp(name, "destroy") == 0) {
+                m->pendingDamage.remove(resource);
+            }
+        } else if (info.isInterface(&wl_buffer_interface) && qstrcmp(name, "destroy") == 0) {
+            m->attachedBuffers.remove(resource);
+        }
+        return;
+    }
+
+    if (info.isInterface(&wl_callback_interface) && qstrcmp(name, "done") == 0) {
+        // wl_display.sync callbacks are done as well, those are not in the pending list
+        const auto it = m->pendingFrames.find(wl_resource_get_id(resource));
+        if (it != m->pendingFrames.end()) {
+            m->frameLatency.add(now, now - it.value());
+            m->pendingFrames.erase(it);
+        }
+    } else if (info.isInterface(&wl_buffer_interface) && qstrcmp(name, "release") == 0) {
+        const auto it = m->attachedBuffers.find(resource);
+        if (it != m->attachedBuffers.end()) {
+            m->bufferTurnaround.add(now, now - it.value());
+            m->attachedBuffers.erase(it);
+        }
+    }
+}
+
+void ClientMetricsModel::removeClient(wl_client *client)
+{
+    for (int i = 0; i < m_clients.count(); ++i) {
+        if (m_clients.at(i)->client != client)
+            continue;
+        beginRemoveRows(QModelIndex(), i, i);
+        delete m_clients.takeAt(i);
+        endRemoveRows();
+        return;
+    }
+}
+
+int ClientMetricsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_clients.count();
+}
+
+int ClientMetricsModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QVariant ClientMetricsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const Metrics *m = m_clients.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case PidColumn:
+                return m->pid;
+            case CommitRateColumn:
+                return qRound(m->damage.count() * 1e9 / Window * 10) / 10.0;
+            case FrameLatencyColumn:
+                return m->frameLatency.count() ? Util::nsecsToMSecs(qint64(m->frameLatency.mean())) : QVariant();
+            case FrameLatencyP95Column:
+                return m->frameLatency.count() ? Util::nsecsToMSecs(qint64(m->frameLatency.percentile(0.95))) : QVariant();
+            case BufferTurnaroundColumn:
+                return m->bufferTurnaround.count() ? Util::nsecsToMSecs(qint64(m->bufferTurnaround.mean())) : QVariant();
+            case BufferTurnaroundP95Column:
+                return m->bufferTurnaround.count() ? Util::nsecsToMSecs(qint64(m->bufferTurnaround.percentile(0.95))) : QVariant();
+            case DamageColumn:
+                return m->damage.count() ? qRound64(m->damage.mean()) : QVariant();
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (index.column()) {
+            case FrameLatencyColumn:
+            case FrameLatencyP95Column:
+                return m->frameLatency.toString(1e6, tr("ms"));
+            case BufferTurnaroundColumn:
+            case BufferTurnaroundP95Column:
+                return m->bufferTurnaround.toString(1e6, tr("ms"));
+            case DamageColumn:
+                return m->damage.toString(1, tr("px"));
+        }
+    }
+    return QVariant();
+}
+
+QVariant ClientMetricsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+            case PidColumn:
+                return tr("pid");
+            case CommitRateColumn:
+                return tr("Commits/s");
+            case FrameLatencyColumn:
+                return tr("Frame Latency [ms]");
+            case FrameLatencyP95Column:
+                return tr("Frame Latency p95 [ms]");
+            case BufferTurnaroundColumn:
+                return tr("Buffer Turnaround [ms]");
+            case BufferTurnaroundP95Column:
+                return tr("Buffer Turnaround p95 [ms]");
+            case DamageColumn:
+                return tr("Damage/Commit [px]");
+        }
+    }
+    return QVariant();
+}
+
+void ClientMetricsModel::update()
+{
+    if (m_clients.isEmpty())
+        return;
+
+    const qint64 now = m_time.nsecsElapsed();
+    for (Metrics *m : qAsConst(m_clients)) {
+        m->frameLatency.expire(now);
+        m->bufferTurnaround.expire(now);
+        m->damage.expire(now);
+    }
+    emit dataChanged(index(0, CommitRateColumn), index(m_clients.count() - 1, DamageColumn));
+}
@@ -0,0 +1,95 @@
+/*
+  clientmetricsmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_CLIENTMETRICSMODEL_H
+#define GAMMARAY_CLIENTMETRICSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+struct wl_client;
+struct wl_protocol_logger_message;
+
+namespace GammaRay {
+
+/**
+ * Per-client frame pacing metrics derived from the protocol traffic.
+ *
+ * All values are rolling histograms over the last few seconds:
+ * - commit rate of wl_surface.commit
+ * - latency between wl_surface.frame and the wl_callback.done of that callback
+ * - turnaround between wl_surface.attach and wl_buffer.release of that buffer
+ * - damaged area per commit, as the sum of the damage rectangles clipped to
+ *   the surface size (overlapping rectangles are counted twice)
+ */
+class ClientMetricsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        PidColumn,
+        CommitRateColumn,
+        FrameLatencyColumn,
+        FrameLatencyP95Column,
+        BufferTurnaroundColumn,
+        BufferTurnaroundP95Column,
+        DamageColumn,
+        ColumnCount
+    };
+
+    explicit ClientMetricsModel(QObject *parent = nullptr);
+    ~ClientMetricsModel() override;
+
+    /// To be called from the protocol logger, @p type is a wl_protocol_logger_type.
+    void protocolMessage(int type, const wl_protocol_logger_message *message);
+    void removeClient(wl_client *client);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void update();
+
+private:
+    struct Metrics;
+    Metrics *metrics(wl_client *client);
+
+    QVector<Metrics *> m_clients;
+    QElapsedTimer m_time;
+    QTimer *m_updateTimer;
+};
+
+}
+
+#endif // GAMMARAY_CLIENTMETRICSMODEL_H
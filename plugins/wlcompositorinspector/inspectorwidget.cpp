@@ -43,6 +43,7 @@
 #include <QPainter>
 #include <QScrollArea>
 #include <QClipboard>
+#include <QTreeView>
 
 #include "ui_inspectorwidget.h"
 #include "wlcompositorclient.h"
@@ -80,13 +81,18 @@ InspectorWidget::InspectorWidget(QWidget *parent)
     auto resourcesModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.WaylandCompositorResourcesModel"));
     m_ui->resourcesView->setModel(resourcesModel);
 
-    m_logView = new LogView(this);
+    m_logView = new LogView(m_client, this);
     m_logView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     m_ui->gridLayout->addWidget(m_logView, 2, 0, 1, 2);
-    connect(m_client, &WlCompositorInterface::logMessage, m_logView, &LogView::logMessage);
-    connect(m_client, &WlCompositorInterface::resetLog, m_logView, &LogView::reset);
+    connect(m_client, &WlCompositorInterface::logRangeChanged, m_logView, &LogView::setLogRange);
+    connect(m_client, &WlCompositorInterface::timelineData, m_logView, &LogView::setTimelineData);
     connect(m_client, &WlCompositorInterface::setLoggingClient, m_logView, &LogView::setLoggingClient);
 
+    auto metricsView = new QTreeView(this);
+    metricsView->setRootIsDecorated(false);
+    metricsView->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.WaylandCompositorClientMetricsModel")));
+    m_logView->addTab(metricsView, tr("Client Metrics"));
+
     m_model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.WaylandCompositorClientsModel"));
     auto clientSelectionModel = ObjectBroker::selectionModel(m_model);
     connect(clientSelectionModel, &QItemSelectionModel::selectionChanged, this, &InspectorWidget::clientSelected);
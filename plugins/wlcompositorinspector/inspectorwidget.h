@@ -64,7 +64,6 @@ private:
     void clientSelected(const QItemSelection &selection);
     void clientContextMenu(QPoint pos);
     void resourceActivated(const QModelIndex &index);
-    void logMessage(const QByteArray &msg);
 
     QScopedPointer<Ui::InspectorWidget> m_ui;
     QAbstractItemModel *m_model;
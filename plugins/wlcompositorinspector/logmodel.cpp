@@ -0,0 +1,181 @@
+/*
+  logmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "logmodel.h"
+#include "logstore.h"
+
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+LogModel::LogModel(LogStore *store, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_store(store)
+    , m_endSeq(store->firstSequence())
+    , m_pid(0)
+    , m_updateTimer(new QTimer(this))
+{
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(100);
+    connect(m_updateTimer, &QTimer::timeout, this, &LogModel::update);
+}
+
+LogModel::~LogModel() = default;
+
+void LogModel::setClientFilter(quint64 pid)
+{
+    if (m_pid == pid)
+        return;
+    m_pid = pid;
+    rebuild();
+}
+
+void LogModel::setInterfaceFilter(const QString &filter)
+{
+    if (m_interfaceFilter == filter)
+        return;
+    m_interfaceFilter = filter;
+    m_interfaceMatches.clear();
+    rebuild();
+}
+
+void LogModel::scheduleUpdate()
+{
+    if (!m_updateTimer->isActive())
+        m_updateTimer->start();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.count();
+}
+
+int LogModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    // evicted messages are only removed on the next update
+    const qint64 seq = m_rows.at(index.row());
+    if (!m_store->contains(seq))
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case TimeColumn:
+                return QString::number(m_store->time(seq) / 1e6, 'f', 3);
+            case ClientColumn:
+                return m_store->pid(seq);
+            case MessageColumn:
+                return QString::fromUtf8(m_store->line(seq));
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == MessageColumn) {
+        return QString::fromUtf8(m_store->line(seq));
+    }
+    return QVariant();
+}
+
+QVariant LogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+            case TimeColumn:
+                return tr("Time [ms]");
+            case ClientColumn:
+                return tr("pid");
+            case MessageColumn:
+                return tr("Message");
+        }
+    }
+    return QVariant();
+}
+
+void LogModel::update()
+{
+    const qint64 firstSeq = m_store->firstSequence();
+    const int evicted = std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), firstSeq) - m_rows.constBegin();
+    if (evicted > 0) {
+        beginRemoveRows(QModelIndex(), 0, evicted - 1);
+        m_rows.remove(0, evicted);
+        endRemoveRows();
+    }
+
+    updateInterfaceMatches();
+    QVector<qint64> added;
+    for (qint64 seq = qMax(m_endSeq, firstSeq); seq < m_store->endSequence(); ++seq) {
+        if (accepts(seq))
+            added.push_back(seq);
+    }
+    m_endSeq = m_store->endSequence();
+
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_rows.count(), m_rows.count() + added.count() - 1);
+        m_rows += added;
+        endInsertRows();
+    }
+
+    emit logUpdated();
+}
+
+void LogModel::updateInterfaceMatches()
+{
+    if (m_interfaceFilter.isEmpty())
+        return;
+    for (int id = m_interfaceMatches.count(); id < m_store->interfaceCount(); ++id)
+        m_interfaceMatches.push_back(QString::fromLatin1(m_store->interfaceName(id)).contains(m_interfaceFilter, Qt::CaseInsensitive));
+}
+
+bool LogModel::accepts(qint64 seq) const
+{
+    if (m_pid && m_store->pid(seq) != m_pid)
+        return false;
+    return m_interfaceFilter.isEmpty() || m_interfaceMatches.at(m_store->interfaceId(seq));
+}
+
+void LogModel::rebuild()
+{
+    m_updateTimer->stop();
+    beginResetModel();
+    m_rows.clear();
+    updateInterfaceMatches();
+    for (qint64 seq = m_store->firstSequence(); seq < m_store->endSequence(); ++seq) {
+        if (accepts(seq))
+            m_rows.push_back(seq);
+    }
+    m_endSeq = m_store->endSequence();
+    endResetModel();
+}
@@ -0,0 +1,98 @@
+/*
+  logmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_LOGMODEL_H
+#define GAMMARAY_LOGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+
+class LogStore;
+
+/**
+ * Filtered view on a LogStore.
+ *
+ * Only sequence numbers of the accepted messages are kept, new messages and
+ * evictions are announced in batches.
+ */
+class LogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        TimeColumn,
+        ClientColumn,
+        MessageColumn,
+        ColumnCount
+    };
+
+    explicit LogModel(LogStore *store, QObject *parent = nullptr);
+    ~LogModel() override;
+
+    /// Only show messages of client @p pid, or all messages for 0.
+    void setClientFilter(quint64 pid);
+    /// Only show messages on interfaces containing @p filter.
+    void setInterfaceFilter(const QString &filter);
+
+    /// Called after messages have been appended to the store.
+    void scheduleUpdate();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    /// Emitted after new or evicted messages have been processed.
+    void logUpdated();
+
+private slots:
+    void update();
+
+private:
+    void updateInterfaceMatches();
+    bool accepts(qint64 seq) const;
+    void rebuild();
+
+    LogStore *m_store;
+    QVector<qint64> m_rows;
+    qint64 m_endSeq;
+    quint64 m_pid;
+    QString m_interfaceFilter;
+    QVector<bool> m_interfaceMatches;
+    QTimer *m_updateTimer;
+};
+
+}
+
+#endif // GAMMARAY_LOGMODEL_H
@@ -0,0 +1,173 @@
+/*
+  logstore.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "logstore.h"
+
+using namespace GammaRay;
+
+static const qint64 BaseBinWidth = 1000000; // 1ms
+static const int LevelFactor = 8;
+static const int LevelCount = 6;
+
+static qint64 binWidth(int level)
+{
+    qint64 width = BaseBinWidth;
+    for (int i = 0; i < level; ++i)
+        width *= LevelFactor;
+    return width;
+}
+
+LogStore::LogStore(int capacity)
+    : m_head(0)
+    , m_count(0)
+    , m_capacity(capacity)
+    , m_firstSeq(0)
+    , m_bins(LevelCount)
+{
+    Q_ASSERT(capacity > 0);
+}
+
+qint64 LogStore::append(qint64 time, quint64 pid, const char *interfaceName, const QByteArray &line)
+{
+    const QByteArray name = QByteArray::fromRawData(interfaceName, qstrlen(interfaceName));
+    int interfaceId = m_interfaceIds.value(name, -1);
+    if (interfaceId < 0) {
+        const QByteArray copy(interfaceName);
+        interfaceId = m_interfaceNames.count();
+        m_interfaceIds.insert(copy, interfaceId);
+        m_interfaceNames.push_back(copy);
+    }
+
+    if (m_count < m_capacity) {
+        m_times.push_back(time);
+        m_pids.push_back(pid);
+        m_interfaces.push_back(interfaceId);
+        m_lines.push_back(line);
+        ++m_count;
+    } else {
+        updateBins(m_times.at(m_head), m_pids.at(m_head), -1);
+        m_times[m_head] = time;
+        m_pids[m_head] = pid;
+        m_interfaces[m_head] = interfaceId;
+        m_lines[m_head] = line;
+        m_head = (m_head + 1) % m_capacity;
+        ++m_firstSeq;
+    }
+    updateBins(time, pid, 1);
+
+    return endSequence() - 1;
+}
+
+qint64 LogStore::lowerBound(qint64 time) const
+{
+    qint64 begin = m_firstSeq;
+    qint64 end = endSequence();
+    while (begin < end) {
+        const qint64 mid = begin + (end - begin) / 2;
+        if (this->time(mid) < time)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    return begin;
+}
+
+QVector<int> LogStore::histogram(qint64 from, qint64 to, int bins, quint64 pid) const
+{
+    if (bins <= 0 || to <= from)
+        return QVector<int>();
+
+    QVector<int> result(bins, 0);
+    const double width = double(to - from) / bins;
+
+    int level = -1;
+    while (level + 1 < LevelCount && binWidth(level + 1) <= width)
+        ++level;
+
+    if (level < 0) {
+        // finer than the smallest aggregation level, the range is short enough to look at each message
+        for (qint64 seq = lowerBound(from); seq < endSequence(); ++seq) {
+            const qint64 t = time(seq);
+            if (t >= to)
+                break;
+            if (pid && this->pid(seq) != pid)
+                continue;
+            ++result[qMin(bins - 1, int((t - from) / width))];
+        }
+        return result;
+    }
+
+    const Bins *levelBins = &m_bins.at(level);
+    if (pid) {
+        const auto it = m_clientBins.constFind(pid);
+        if (it == m_clientBins.constEnd())
+            return result;
+        levelBins = &it.value().at(level);
+    }
+
+    const qint64 levelWidth = binWidth(level);
+    for (auto it = levelBins->lowerBound(from / levelWidth); it != levelBins->constEnd(); ++it) {
+        const qint64 start = it.key() * levelWidth;
+        if (start >= to)
+            break;
+        const int index = int((start + levelWidth / 2 - from) / width);
+        result[qBound(0, index, bins - 1)] += it.value();
+    }
+    return result;
+}
+
+void LogStore::updateBins(qint64 time, quint64 pid, int delta)
+{
+    auto update = [time, delta](QVector<Bins> &levels) {
+        for (int level = 0; level < LevelCount; ++level) {
+            Bins &bins = levels[level];
+            const qint64 key = time / binWidth(level);
+            if (delta > 0) {
+                bins[key] += delta;
+                continue;
+            }
+            auto it = bins.find(key);
+            if (it == bins.end())
+                continue;
+            it.value() += delta;
+            if (it.value() <= 0)
+                bins.erase(it);
+        }
+    };
+
+    update(m_bins);
+
+    auto it = m_clientBins.find(pid);
+    if (it == m_clientBins.end()) {
+        if (delta < 0)
+            return;
+        it = m_clientBins.insert(pid, QVector<Bins>(LevelCount));
+    }
+    update(it.value());
+    if (it.value().at(0).isEmpty())
+        m_clientBins.erase(it);
+}
@@ -0,0 +1,105 @@
+/*
+  logstore.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_LOGSTORE_H
+#define GAMMARAY_LOGSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QVector>
+
+namespace GammaRay {
+
+/**
+ * Bounded, columnar store for the protocol log.
+ *
+ * Messages are addressed by a monotonically increasing sequence number, the
+ * oldest ones are dropped once the capacity is reached. Message counts are
+ * additionally aggregated into a pyramid of time bins (each level 8 times
+ * coarser than the previous one), so histograms over large time ranges don't
+ * need to look at individual messages.
+ */
+class LogStore
+{
+public:
+    explicit LogStore(int capacity);
+
+    qint64 append(qint64 time, quint64 pid, const char *interfaceName, const QByteArray &line);
+
+    int count() const { return m_count; }
+    int capacity() const { return m_capacity; }
+    bool isEmpty() const { return m_count == 0; }
+
+    /// Sequence number of the oldest message still in the store.
+    qint64 firstSequence() const { return m_firstSeq; }
+    /// Sequence number the next appended message will get.
+    qint64 endSequence() const { return m_firstSeq + m_count; }
+    bool contains(qint64 seq) const { return seq >= m_firstSeq && seq < endSequence(); }
+
+    qint64 time(qint64 seq) const { return m_times.at(slot(seq)); }
+    quint64 pid(qint64 seq) const { return m_pids.at(slot(seq)); }
+    int interfaceId(qint64 seq) const { return m_interfaces.at(slot(seq)); }
+    QByteArray line(qint64 seq) const { return m_lines.at(slot(seq)); }
+
+    int interfaceCount() const { return m_interfaceNames.count(); }
+    QByteArray interfaceName(int id) const { return m_interfaceNames.at(id); }
+
+    /// Returns the sequence number of the first message at or after @p time.
+    qint64 lowerBound(qint64 time) const;
+
+    /**
+     * Returns the number of messages in each of @p bins equally sized bins
+     * covering [@p from, @p to), optionally restricted to client @p pid.
+     */
+    QVector<int> histogram(qint64 from, qint64 to, int bins, quint64 pid = 0) const;
+
+private:
+    int slot(qint64 seq) const { return (m_head + int(seq - m_firstSeq)) % m_capacity; }
+    void updateBins(qint64 time, quint64 pid, int delta);
+
+    typedef QMap<qint64, int> Bins;
+
+    QVector<qint64> m_times;
+    QVector<quint64> m_pids;
+    QVector<int> m_interfaces;
+    QVector<QByteArray> m_lines;
+    int m_head;
+    int m_count;
+    int m_capacity;
+    qint64 m_firstSeq;
+
+    QVector<QByteArray> m_interfaceNames;
+    QHash<QByteArray, int> m_interfaceIds;
+
+    QVector<Bins> m_bins;
+    QHash<quint64, QVector<Bins> > m_clientBins;
+};
+
+}
+
+#endif // GAMMARAY_LOGSTORE_H
@@ -27,356 +27,120 @@
 */
 
 #include "logview.h"
+#include "wlcompositorinterface.h"
 
+#include <common/objectbroker.h>
+
+#include <compat/qasconst.h>
+
+#include <QAbstractItemModel>
+#include <QApplication>
+#include <QClipboard>
+#include <QHeaderView>
+#include <QKeyEvent>
+#include <QLineEdit>
 #include <QMouseEvent>
-#include <QScrollBar>
-#include <QStaticText>
 #include <QPainter>
 #include <QScrollArea>
-#include <QClipboard>
-#include <QApplication>
+#include <QScrollBar>
+#include <QTimer>
+#include <QTreeView>
+#include <QVBoxLayout>
 #include <QtMath>
 
-#include "ringbuffer.h"
+#include <algorithm>
 
 namespace GammaRay {
 
-class View : public QWidget
+class MessagesView : public QTreeView
 {
 public:
-  explicit View(QWidget *p)
-    : QWidget(p)
-    , m_lines(5000)
-    , m_metrics(QFont())
-    , m_lineHeight(m_metrics.height())
-    , m_client(0)
-  {
-    resize(0, 0);
-    setFocusPolicy(Qt::ClickFocus);
-    setCursor(Qt::IBeamCursor);
-  }
-
-  QSize sizeHint() const override
-  {
-    return size();
-  }
-
-  void drawLine(QPainter &painter, const QRect &rect, const QStaticText &line)
-  {
-    painter.setPen(palette().color(QPalette::Text));
-    painter.drawStaticText(0, rect.y(), line);
-  }
-
-  void drawLineSelected(QPainter &painter, const QRect &rect, const QStaticText &line)
-  {
-    painter.fillRect(rect, palette().highlight());
-    painter.setPen(palette().color(QPalette::HighlightedText));
-    painter.drawStaticText(0, rect.y(), line);
-  }
-
-  void drawLinePartialSelected(QPainter &painter, const QRect &rect, const QStaticText &line, int startSelectChar, int endSelectChar)
+  explicit MessagesView(QWidget *parent)
+    : QTreeView(parent)
+    , m_atBottom(true)
   {
-    const QString &text = line.text();
-    int startX = m_metrics.width(text.left(startSelectChar));
-    int endX = m_metrics.width(text.left(endSelectChar));
-
-    if (startSelectChar > 0) {
-      painter.drawText(QRect(rect.x(), rect.y(), startX,  rect.height()), Qt::TextDontClip, text.left(startSelectChar));
-    }
-
-    QRect selectRect(rect.x() + startX, rect.y(), endX - startX, rect.height());
-    painter.fillRect(selectRect, palette().highlight());
-    painter.setPen(palette().color(QPalette::HighlightedText));
-    painter.drawText(selectRect, Qt::TextDontClip, text.mid(startSelectChar, endSelectChar - startSelectChar));
-
-    if (endSelectChar < text.count()) {
-      painter.setPen(palette().color(QPalette::Text));
-      painter.drawText(QRect(rect.x() + endX, rect.y(), m_metrics.width(text) - endX, rect.height()), text.mid(endSelectChar));
-    }
+    setRootIsDecorated(false);
+    setUniformRowHeights(true);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setSelectionBehavior(QAbstractItemView::SelectRows);
   }
 
-  void selectionBoundaries(QPoint &start, QPoint &end) const
-  {
-    bool startBeforeEnd = (m_selectionStart.y() < m_selectionEnd.y()) ||
-                          (m_selectionStart.y() == m_selectionEnd.y() && m_selectionStart.x() < m_selectionEnd.x());
-    start = startBeforeEnd ? m_selectionStart : m_selectionEnd;
-    end = startBeforeEnd ? m_selectionEnd : m_selectionStart;
-  }
-
-  struct LineSelection
-  {
-    bool isNull() const { return start == end; }
-    bool isFull() const { return start == 0 && end < 0; }
-
-    int start;
-    int end;
-  };
-  LineSelection lineSelection(int line) const
+  void setModel(QAbstractItemModel *model) override
   {
-    if (m_selectionStart == m_selectionEnd) {
-      return { 0, 0 };
-    }
-
-    QPoint start, end;
-    selectionBoundaries(start, end);
-
-    if (start.y() < line && line < end.y()) {
-      return { 0, m_lines.at(line).text.text().count() };
-    }
-
-    if (start.y() == line || end.y() == line) {
-      int startChar = 0;
-      int endChar = m_lines.at(line).text.text().count();
-      if (start.y() == line)
-        startChar = start.x();
-      if (end.y() == line)
-        endChar = end.x() + 1;
-      return { startChar, endChar };
-    }
-
-    return { 0, 0 };
+    QTreeView::setModel(model);
+    connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+      m_atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    });
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this]() {
+      if (m_atBottom)
+        scrollToBottom();
+    });
   }
 
-  void paintEvent(QPaintEvent *event) override
-  {
-    if (m_lineHeight < 0) {
-      return;
-    }
-
-    QPainter painter(this);
-
-    QRectF drawRect = event->rect();
-    int startingLine = lineAt(drawRect.y());
-    int y = linePosAt(drawRect.y());
-
-    for (int i = startingLine; i < m_lines.count(); ++i) {
-      if (m_client && m_lines.at(i).pid != m_client) {
-        continue;
-      }
-      const QStaticText &text = m_lines.at(i).text;
-
-      QRect lineRect(QRect(0, y, text.size().width(), m_lineHeight));
-      painter.fillRect(QRectF(0, y, drawRect.width(), m_lineHeight), i % 2 ? palette().base() : palette().alternateBase());
-
-      LineSelection selection = lineSelection(i);
-      if (selection.isNull()) {
-        drawLine(painter, lineRect, text);
-      } else if (selection.isFull()) {
-        drawLineSelected(painter, lineRect, text);
-      } else {
-        drawLinePartialSelected(painter, lineRect, text, selection.start, selection.end);
-      }
-
-      y += m_lineHeight;
-      if (y >= drawRect.bottom())
-        break;
-    }
-  }
-
-  inline int linesCount() const
-  {
-    return m_client ? m_linesCount.value(m_client) : m_lines.count();
-  }
-
-  inline int linePosAt(int y) const {
-    int line = qMin(y / m_lineHeight, m_lines.count() - 1);
-    return line * m_lineHeight;
-  }
-
-  inline int lineAt(int y) const {
-    int line = qMin(y / m_lineHeight, m_lines.count() - 1);
-    if (!m_client) {
-      return line;
-    }
-
-    for (int i = 0, l = 0; i < m_lines.count(); ++i) {
-      if (m_lines.at(i).pid == m_client) {
-        if (l++ == line) {
-          return i;
-        }
-      }
-    }
-    return line;
-  }
-  inline QPoint charPosAt(const QPointF &p) const
-  {
-    int line = lineAt(p.y());
-    int lineX = 0;
-
-    const QString &text = m_lines.at(line).text.text();
-    for (int x = 0, i = 0; i < text.count(); ++i) {
-      const QChar &c = text.at(i);
-      if (p.x() >= x) {
-        lineX = i;
-      }
-      x += m_metrics.width(c);
-    }
-
-    return {lineX, line};
-  }
-
-  void mousePressEvent(QMouseEvent *e) override
+  void keyPressEvent(QKeyEvent *e) override
   {
-    if (e->button() == Qt::LeftButton) {
-      m_selectionStart = m_selectionEnd = charPosAt(e->pos());
+    if (e->matches(QKeySequence::Copy)) {
+      QApplication::clipboard()->setText(selectedText());
       e->accept();
-      update();
+      return;
     }
-  }
-
-  void mouseMoveEvent(QMouseEvent *e) override
-  {
-    m_selectionEnd = charPosAt(e->pos());
-    e->accept();
-    update();
+    QTreeView::keyPressEvent(e);
   }
 
   QString selectedText() const
   {
-    if (m_selectionStart == m_selectionEnd) {
-      return QString();
-    }
+    auto rows = selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end());
 
-    QPoint start, end;
-    selectionBoundaries(start, end);
     QString string;
-    for (int i = start.y(); i <= end.y(); ++i) {
-      if (m_client && m_lines.at(i).pid != m_client) {
-        continue;
-      }
-      const QStaticText &line = m_lines.at(i).text;
-      LineSelection selection = lineSelection(i);
-      string += line.text().mid(selection.start, selection.end - selection.start);
+    for (const auto &row : qAsConst(rows)) {
+      QStringList columns;
+      for (int i = 0; i < model()->columnCount(); ++i)
+        columns.push_back(row.sibling(row.row(), i).data().toString());
+      string += columns.join(QLatin1Char(' '));
       string += QLatin1Char('\n');
     }
     return string;
   }
 
-  void keyPressEvent(QKeyEvent *e) override
-  {
-    if (e->key() == Qt::Key_C && e->modifiers() == Qt::ControlModifier) {
-      QApplication::clipboard()->setText(selectedText());
-    }
-  }
-
-  void resetSelection()
-  {
-      m_selectionStart = m_selectionEnd = QPoint();
-      update();
-  }
-
-  struct Line {
-      quint64 pid = 0;
-      QStaticText text;
-      int *counter = nullptr;
-
-      Line() = default;
-
-      Line(quint64 p, const QStaticText &t, int *cnt)
-        : pid(p), text(t), counter(cnt)
-      {
-        (*counter)++;
-      }
-
-      Line(const Line &l)
-        : pid(l.pid), text(l.text), counter(l.counter)
-      {
-        (*counter)++;
-      }
-
-      ~Line() { (*counter)--; }
-
-      Line &operator=(const Line &l) {
-          (*counter)--;
-
-          pid = l.pid;
-          text = l.text;
-          counter = l.counter;
-
-          (*counter)++;
-          return *this;
-      }
-
-  };
-  RingBuffer<Line> m_lines;
-  QHash<quint64, int> m_linesCount;
-  QFontMetricsF m_metrics;
-  int m_lineHeight;
-  QPoint m_selectionStart;
-  QPoint m_selectionEnd;
-  quint64 m_client;
+  bool m_atBottom;
 };
 
 
-class Messages : public QScrollArea
+class Messages : public QWidget
 {
 public:
-  explicit Messages(QWidget *parent)
-    : QScrollArea(parent)
-    , m_view(new View(this))
-  {
-    m_view->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
-    setWidget(m_view);
-    setWidgetResizable(true);
-  }
-
-  void logMessage(quint64 pid, qint64 time, const QByteArray &msg)
-  {
-    auto scrollbar = verticalScrollBar();
-    bool scroll = scrollbar->value() >= scrollbar->maximum();
-
-    add(pid, time, msg);
-
-    if (scroll)
-      scrollbar->setValue(scrollbar->maximum());
-  }
-
-  void reset()
-  {
-    m_view->m_lines.clear();
-    m_view->resize(0, 0);
-  }
-
-  void updateSize()
+  Messages(WlCompositorInterface *iface, QWidget *parent)
+    : QWidget(parent)
+    , m_interface(iface)
+    , m_filter(new QLineEdit(this))
+    , m_view(new MessagesView(this))
+    , m_filterTimer(new QTimer(this))
   {
-    QSizeF lineSize = m_view->m_lines.last().text.size();
-
-    int w = m_view->width();
-    int h = m_view->linesCount() * m_view->m_lineHeight;
-
-    if (lineSize.width() > w) {
-      w = lineSize.width();
-    }
-    m_view->resize(w, h);
-    m_view->update();
-  }
-
-  void add(quint64 pid, qint64 time, const QByteArray &m)
-  {
-    m_view->m_lines.append(View::Line(pid, QStaticText(QString("[%1ms] %2").arg(QString::number(time / 1e6), QString(m))), &m_view->m_linesCount[pid]));
-
-    if (m_view->m_client && pid != m_view->m_client) {
-      return;
-    }
-
-    updateSize();
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_filter);
+    layout->addWidget(m_view);
+
+    m_filter->setPlaceholderText(LogView::tr("Filter interfaces"));
+    m_filter->setClearButtonEnabled(true);
+
+    // the filter is applied in the probe, don't send a request for each keystroke
+    m_filterTimer->setSingleShot(true);
+    m_filterTimer->setInterval(300);
+    connect(m_filter, &QLineEdit::textChanged, m_filterTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(m_filterTimer, &QTimer::timeout, this, [this]() {
+      m_interface->setLogInterfaceFilter(m_filter->text());
+    });
+
+    m_view->setModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.WaylandCompositorLogModel")));
+    m_view->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
   }
 
-  void setLoggingClient(quint64 pid)
-  {
-    m_view->m_client = pid;
-
-    auto scrollbar = verticalScrollBar();
-    qreal v = (qreal)scrollbar->value() / (qreal)scrollbar->maximum();
-
-    m_view->resetSelection();
-    updateSize();
-
-    // keep the scrollbar at he same percentage
-    scrollbar->setValue(v * (qreal)scrollbar->maximum());
-  }
-
-  View *m_view;
+  WlCompositorInterface *m_interface;
+  QLineEdit *m_filter;
+  MessagesView *m_view;
+  QTimer *m_filterTimer;
 };
 
 
@@ -386,14 +150,7 @@ public:
   class View : public QWidget
   {
   public:
-    struct DataPoint {
-      qint64 time;
-      quint64 pid;
-      QByteArray msg;
-    };
-
     View()
-      : m_data(5000)
     {
       resize(100, 100);
       setAttribute(Qt::WA_OpaquePaintEvent);
@@ -405,8 +162,6 @@ public:
       return size();
     }
 
-    inline qint64 initialTime() const { return m_data.isEmpty() ? 0 : m_data.at(0).time; }
-
     void paintEvent(QPaintEvent *event) override
     {
       QPainter painter(this);
@@ -429,7 +184,7 @@ public:
         mul = mul == 2 ? 5 : 2;
       }
 
-      auto it = initialTime();
+      auto it = m_rangeStart;
       auto rit = round(it, -1);
 
       //draw the grid lines
@@ -460,42 +215,61 @@ public:
         }
       }
 
-      //finally draw the event lines
-      painter.setPen(palette.color(QPalette::Text));
-      bool hasDrawn = false;
-      for (int i = 0; i < m_data.count(); ++i) {
-        const auto &point = m_data.at(i);
-        if (m_client && point.pid != m_client) {
-            painter.setPen(palette.color(QPalette::Dark));
-        } else {
-            painter.setPen(palette.color(QPalette::Text));
-        }
+      //finally draw the binned message counts, the selected client on top of the total
+      if (m_total.isEmpty())
+        return;
 
-        qreal offset = point.time - m_start;
-        qreal x = offset / m_zoom;
-        qreal y = qMax(qreal(40.), drawRect.y());
-        if (!drawRect.contains(QPoint(x, y))) {
-          if (hasDrawn)
-            break;
-          else
-            continue;
-        }
-        hasDrawn = true;
+      const int maxCount = *std::max_element(m_total.constBegin(), m_total.constEnd());
+      if (maxCount == 0)
+        return;
 
-        painter.drawLine(x, y, x, drawRect.bottom());
+      const qreal top = 40;
+      const qreal barsHeight = qMax(qreal(0), height() - top);
+      drawBins(painter, drawRect, m_total, maxCount, top, barsHeight,
+               palette.color(m_client.isEmpty() ? QPalette::Text : QPalette::Dark));
+      drawBins(painter, drawRect, m_client, maxCount, top, barsHeight, palette.color(QPalette::Text));
+    }
+
+    void drawBins(QPainter &painter, const QRectF &drawRect, const QVector<int> &bins, int maxCount, qreal top, qreal height, const QColor &color)
+    {
+      painter.setPen(color);
+      const qreal binWidth = qreal(m_binsTo - m_binsFrom) / bins.count();
+      for (int i = 0; i < bins.count(); ++i) {
+        const int count = bins.at(i);
+        if (count == 0)
+          continue;
+
+        const qreal x = (m_binsFrom + (i + 0.5) * binWidth - m_start) / m_zoom;
+        if (x < drawRect.left() || x > drawRect.right())
+          continue;
+
+        // logarithmic, so single messages stay visible next to frame callback bursts
+        const qreal h = qMax(qreal(2), height * std::log1p(count) / std::log1p(maxCount));
+        painter.drawLine(QPointF(x, top + height - h), QPointF(x, top + height));
       }
     }
 
+    int binAt(qreal x) const
+    {
+      if (m_total.isEmpty() || m_binsTo <= m_binsFrom)
+        return -1;
+      const qreal binWidth = qreal(m_binsTo - m_binsFrom) / m_total.count();
+      const int bin = qFloor((m_start + x * m_zoom - m_binsFrom) / binWidth);
+      return bin >= 0 && bin < m_total.count() ? bin : -1;
+    }
+
     void mouseMoveEvent(QMouseEvent *e) override
     {
-      const QPointF &pos = e->localPos();
-      for (int i = 0; i < m_data.count(); ++i) {
-        qreal timex = (m_data.at(i).time - m_start) / m_zoom;
-        if (fabs(pos.x() - timex) < 2) {
-          setToolTip(m_data.at(i).msg);
-          return;
-        }
+      const int bin = binAt(e->localPos().x());
+      if (bin < 0 || m_total.at(bin) == 0) {
+        setToolTip(QString());
+        return;
       }
+
+      QString tip = LogView::tr("%n message(s)", nullptr, m_total.at(bin));
+      if (!m_client.isEmpty())
+        tip += LogView::tr(", %n from the selected client", nullptr, m_client.at(bin));
+      setToolTip(tip);
     }
 
     qint64 round(qint64 time, int direction)
@@ -506,42 +280,89 @@ public:
 
     void updateSize()
     {
-      if (m_data.count() == 0)
+      if (m_rangeEnd <= m_rangeStart)
         return;
 
-      m_start = round(m_data.at(0).time, -1);
-      m_timespan = round(m_data.last().time, 1) - m_start;
+      m_start = round(m_rangeStart, -1);
+      m_timespan = round(m_rangeEnd, 1) - m_start;
       resize(m_timespan / m_zoom, height());
     }
 
-    RingBuffer<DataPoint> m_data;
     qreal m_zoom = 100000;
     qint64 m_start = 0;
     qint64 m_timespan = 0;
-    quint64 m_client = 0;
+    qint64 m_rangeStart = 0;
+    qint64 m_rangeEnd = 0;
+
+    qint64 m_binsFrom = 0;
+    qint64 m_binsTo = 0;
+    QVector<int> m_total;
+    QVector<int> m_client;
   };
 
-  explicit Timeline(QWidget *parent)
+  Timeline(WlCompositorInterface *iface, QWidget *parent)
     : QScrollArea(parent)
+    , m_interface(iface)
+    , m_requestTimer(new QTimer(this))
   {
     m_view.setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Fixed);
     setWidget(&m_view);
     setWidgetResizable(true);
     m_view.installEventFilter(this);
+
+    // only the visible range is requested, one bin per pixel
+    m_requestTimer->setSingleShot(true);
+    m_requestTimer->setInterval(50);
+    connect(m_requestTimer, &QTimer::timeout, this, &Timeline::requestVisibleRange);
+    connect(horizontalScrollBar(), &QScrollBar::valueChanged, m_requestTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
   }
 
-  void logMessage(quint64 pid, qint64 time, const QByteArray &msg)
+  void setLogRange(qint64 start, qint64 end)
   {
-    m_view.m_data.append({ time, pid, msg });
+    m_view.m_rangeStart = start;
+    m_view.m_rangeEnd = end;
     m_view.updateSize();
+    scheduleRequest();
   }
 
-  void setLoggingClient(quint64 pid)
+  void setTimelineData(qint64 from, qint64 to, const QVector<int> &total, const QVector<int> &client)
   {
-    m_view.m_client = pid;
+    m_view.m_binsFrom = from;
+    m_view.m_binsTo = to;
+    m_view.m_total = total;
+    m_view.m_client = client;
     m_view.update();
   }
 
+  void scheduleRequest()
+  {
+    if (isVisible() && !m_requestTimer->isActive())
+      m_requestTimer->start();
+  }
+
+  void requestVisibleRange()
+  {
+    const int width = viewport()->width();
+    if (width <= 0 || m_view.m_timespan <= 0)
+      return;
+
+    const qint64 from = m_view.m_start + qint64(horizontalScrollBar()->value() * m_view.m_zoom);
+    const qint64 to = from + qint64(width * m_view.m_zoom);
+    m_interface->requestTimeline(from, to, width);
+  }
+
+  void showEvent(QShowEvent *e) override
+  {
+    QScrollArea::showEvent(e);
+    scheduleRequest();
+  }
+
+  void resizeEvent(QResizeEvent *e) override
+  {
+    QScrollArea::resizeEvent(e);
+    scheduleRequest();
+  }
+
   bool eventFilter(QObject *o, QEvent *e) override
   {
     if (o == &m_view && e->type() == QEvent::Wheel) {
@@ -561,17 +382,20 @@ public:
       //keep the point under the mouse still, if possible
       pos = pos / m_view.m_zoom;
       sb->setValue(sbvalue + (0.5 + pos - we->posF().x()));
+      scheduleRequest();
     }
     return QScrollArea::eventFilter(o, e);
   }
 
+  WlCompositorInterface *m_interface;
+  QTimer *m_requestTimer;
   View m_view;
 };
 
-LogView::LogView(QWidget *p)
+LogView::LogView(WlCompositorInterface *iface, QWidget *p)
        : QTabWidget(p)
-       , m_messages(new Messages(this))
-       , m_timeline(new Timeline(this))
+       , m_messages(new Messages(iface, this))
+       , m_timeline(new Timeline(iface, this))
 {
   setTabPosition(QTabWidget::West);
   addTab(m_messages, tr("Messages"));
@@ -583,21 +407,22 @@ QSize LogView::sizeHint() const
   return {200, 200};
 }
 
-void LogView::logMessage(quint64 pid, qint64 time, const QByteArray &msg)
+void LogView::setLogRange(qint64 start, qint64 end)
 {
-  m_messages->logMessage(pid, time, msg);
-  m_timeline->logMessage(pid, time, msg);
+  m_timeline->setLogRange(start, end);
 }
 
-void LogView::setLoggingClient(quint64 pid)
+void LogView::setTimelineData(qint64 from, qint64 to, const QVector<int> &total, const QVector<int> &client)
 {
-  m_messages->setLoggingClient(pid);
-  m_timeline->setLoggingClient(pid);
+  m_timeline->setTimelineData(from, to, total, client);
 }
 
-void LogView::reset()
+void LogView::setLoggingClient(quint64 pid)
 {
-  m_messages->reset();
+  Q_UNUSED(pid);
+  // the probe has already applied the client filter to the message model,
+  // fetch the per-client bins for the timeline
+  m_timeline->scheduleRequest();
 }
 
 }
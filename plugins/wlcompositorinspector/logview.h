@@ -31,22 +31,24 @@
 
 #include <QScrollArea>
 #include <QTabWidget>
+#include <QVector>
 
 namespace GammaRay {
 
 class Messages;
 class Timeline;
+class WlCompositorInterface;
 
 class LogView : public QTabWidget
 {
   Q_OBJECT
 public:
-  explicit LogView(QWidget *p);
+  explicit LogView(WlCompositorInterface *iface, QWidget *p);
 
   QSize sizeHint() const override;
-  void logMessage(quint64 pid, qint64 time, const QByteArray &msg);
+  void setLogRange(qint64 start, qint64 end);
+  void setTimelineData(qint64 from, qint64 to, const QVector<int> &total, const QVector<int> &client);
   void setLoggingClient(quint64 pid);
-  void reset();
 
 private:
   Messages *m_messages;
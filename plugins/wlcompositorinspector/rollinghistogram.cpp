@@ -0,0 +1,64 @@
+/*
+  rollinghistogram.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "rollinghistogram.h"
+
+#include <QString>
+
+using namespace GammaRay;
+
+RollingHistogram::RollingHistogram(qint64 window)
+    : m_window(window)
+{
+}
+
+void RollingHistogram::add(qint64 time, qint64 value)
+{
+    m_samples.enqueue({ time, value });
+    m_histogram.add(value);
+    expire(time);
+}
+
+void RollingHistogram::expire(qint64 now)
+{
+    while (!m_samples.isEmpty() && m_samples.head().time < now - m_window)
+        m_histogram.remove(m_samples.dequeue().value);
+}
+
+qint64 RollingHistogram::maximum() const
+{
+    // the histogram's maximum covers expired samples as well
+    qint64 max = 0;
+    for (const Sample &s : m_samples)
+        max = qMax(max, s.value);
+    return max;
+}
+
+QString RollingHistogram::toString(double scale, const QString &unit) const
+{
+    return m_histogram.toString(scale, unit);
+}
@@ -0,0 +1,71 @@
+/*
+  rollinghistogram.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_ROLLINGHISTOGRAM_H
+#define GAMMARAY_ROLLINGHISTOGRAM_H
+
+#include <common/log2histogram.h>
+
+#include <QQueue>
+
+namespace GammaRay {
+
+/**
+ * Log2Histogram restricted to the samples of a sliding time window.
+ */
+class RollingHistogram
+{
+public:
+    explicit RollingHistogram(qint64 window);
+
+    /// Adds @p value, sampled at @p time (in ns).
+    void add(qint64 time, qint64 value);
+    /// Drops all samples older than the window at @p now.
+    void expire(qint64 now);
+
+    int count() const { return m_samples.count(); }
+    qint64 window() const { return m_window; }
+    double mean() const { return m_histogram.mean(); }
+    qint64 maximum() const;
+    double percentile(double p) const { return m_histogram.percentile(p); }
+
+    /// Human readable bucket list, values are divided by @p scale.
+    QString toString(double scale, const QString &unit) const;
+
+private:
+    struct Sample {
+        qint64 time;
+        qint64 value;
+    };
+    QQueue<Sample> m_samples;
+    Log2Histogram m_histogram;
+    qint64 m_window;
+};
+
+}
+
+#endif // GAMMARAY_ROLLINGHISTOGRAM_H
@@ -57,4 +57,14 @@ void WlCompositorClient::setSelectedResource(uint32_t id)
   Endpoint::instance()->invokeObject(objectName(), "setSelectedResource", QVariantList() << id);
 }
 
+void WlCompositorClient::setLogInterfaceFilter(const QString &filter)
+{
+  Endpoint::instance()->invokeObject(objectName(), "setLogInterfaceFilter", QVariantList() << filter);
+}
+
+void WlCompositorClient::requestTimeline(qint64 from, qint64 to, int bins)
+{
+  Endpoint::instance()->invokeObject(objectName(), "requestTimeline", QVariantList() << from << to << bins);
+}
+
 }
@@ -45,6 +45,8 @@ public slots:
   void disconnected() override;
   void setSelectedClient(int index) override;
   void setSelectedResource(uint32_t id) override;
+  void setLogInterfaceFilter(const QString &filter) override;
+  void requestTimeline(qint64 from, qint64 to, int bins) override;
 
 };
 
@@ -55,8 +55,10 @@
 
 #include <wayland-server.h>
 
+#include "clientmetricsmodel.h"
 #include "clientsmodel.h"
-#include "ringbuffer.h"
+#include "logmodel.h"
+#include "logstore.h"
 #include "resourceinfo.h"
 
 namespace GammaRay
@@ -138,53 +140,71 @@ public:
 
     Logger(WlCompositorInspector *inspector, QObject *parent)
         : QObject(parent)
-        , m_lines(5000)
+        , m_store(100000)
+        , m_model(new LogModel(&m_store, this))
         , m_connected(false)
         , m_inspector(inspector)
+        , m_pid(0)
     {
       m_timer.start();
+      connect(m_model, &LogModel::logUpdated, this, [this]() {
+          if (m_connected) {
+              emitRange();
+          }
+      });
     }
 
     void add(wl_resource *res, MessageType dir, const QString &line)
     {
         pid_t pid;
         wl_client_get_credentials(wl_resource_get_client(res), &pid, nullptr, nullptr);
-        QString l = QStringLiteral("%1 %2 %3").arg(QString::number(pid),
-                                                   dir == MessageType::Request ? QLatin1String("->") : QLatin1String("<-"),
-                                                   line);
+        QString l = QStringLiteral("%1 %2").arg(dir == MessageType::Request ? QLatin1String("->") : QLatin1String("<-"),
+                                                line);
         // we use QByteArray rather than QString because the log has mostly (only) latin characters
         // so we save some space using utf8 rather than the utf16 QString uses
-        QByteArray utf8 = l.toUtf8();
-        qint64 time = m_timer.nsecsElapsed();
-        m_lines.append({ time, pid, utf8 });
-        if (m_connected) {
-            emit m_inspector->logMessage(pid, time, utf8);
-        }
+        m_store.append(m_timer.nsecsElapsed(), pid, ResourceInfo(res).interfaceName(), l.toUtf8());
+        m_model->scheduleUpdate();
     }
 
     void setCurrentClient(QWaylandClient *client)
     {
-        emit m_inspector->setLoggingClient(client ? client->processId() : 0);
+        m_pid = client ? client->processId() : 0;
+        m_model->setClientFilter(m_pid);
+        emit m_inspector->setLoggingClient(m_pid);
     }
 
     void setConnected(bool c)
     {
         m_connected = c;
-        for (int i = 0; i < m_lines.count(); ++i) {
-            const Message &m = m_lines.at(i);
-            emit m_inspector->logMessage(m.pid, m.time, m.line);
+        if (c) {
+            emitRange();
         }
     }
 
-    struct Message {
-      qint64 time;
-      pid_t pid;
-      QByteArray line;
-    };
-    RingBuffer<Message> m_lines;
+    void emitRange()
+    {
+        if (m_store.isEmpty()) {
+            emit m_inspector->logRangeChanged(0, 0);
+        } else {
+            emit m_inspector->logRangeChanged(m_store.time(m_store.firstSequence()),
+                                              m_store.time(m_store.endSequence() - 1));
+        }
+    }
+
+    void requestTimeline(qint64 from, qint64 to, int bins)
+    {
+        // one bin per pixel is all the client ever needs
+        bins = qBound(0, bins, 8192);
+        emit m_inspector->timelineData(from, to, m_store.histogram(from, to, bins),
+                                       m_pid ? m_store.histogram(from, to, bins, m_pid) : QVector<int>());
+    }
+
+    LogStore m_store;
+    LogModel *m_model;
     bool m_connected;
     WlCompositorInspector *m_inspector;
     QElapsedTimer m_timer;
+    quint64 m_pid;
 };
 
 class ResourcesModel : public QAbstractItemModel
@@ -437,10 +457,14 @@ WlCompositorInspector::WlCompositorInspector(Probe *probe, QObject *parent)
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.WaylandCompositorClientsModel"), m_clientsModel);
     m_clientSelectionModel = ObjectBroker::selectionModel(m_clientsModel);
 
+    m_clientMetricsModel = new ClientMetricsModel(this);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.WaylandCompositorClientMetricsModel"), m_clientMetricsModel);
+
     m_resourcesModel = new ResourcesModel;
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.WaylandCompositorResourcesModel"), m_resourcesModel);
 
     m_logger = new Logger(this, this);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.WaylandCompositorLogModel"), m_logger->m_model);
 
     connect(probe, &Probe::objectCreated, this, &WlCompositorInspector::objectAdded);
     connect(probe, &Probe::objectSelected, this, &WlCompositorInspector::objectSelected);
@@ -558,7 +582,9 @@ void WlCompositorInspector::init(QWaylandCompositor *compositor)
         }
         line += QLatin1Char(')');
 
-        static_cast<WlCompositorInspector *>(ud)->m_logger->add(resource, (Logger::MessageType)type, line);
+        auto *inspector = static_cast<WlCompositorInspector *>(ud);
+        inspector->m_logger->add(resource, (Logger::MessageType)type, line);
+        inspector->m_clientMetricsModel->protocolMessage(type, message);
     }, this);
 
     wl_list *clients = wl_display_get_client_list(dpy);
@@ -582,11 +608,12 @@ void WlCompositorInspector::addClient(wl_client *c)
 
     QString pid = QString::number(client->processId());
     qWarning() << "client" << client << pid;
-    connect(client, &QObject::destroyed, this, [this, pid, client](QObject *) {
+    connect(client, &QObject::destroyed, this, [this, pid, client, c](QObject *) {
         if (m_resourcesModel->client() == client) {
           m_resourcesModel->setClient(nullptr);
         }
         m_clientsModel->removeClient(client);
+        m_clientMetricsModel->removeClient(c);
     });
 
     m_clientsModel->addClient(client);
@@ -621,4 +648,14 @@ void WlCompositorInspector::setSelectedResource(uint id)
     m_surfaceView->setSurface(surface);
 }
 
+void WlCompositorInspector::setLogInterfaceFilter(const QString &filter)
+{
+    m_logger->m_model->setInterfaceFilter(filter);
+}
+
+void WlCompositorInspector::requestTimeline(qint64 from, qint64 to, int bins)
+{
+    m_logger->requestTimeline(from, to, bins);
+}
+
 }
@@ -44,6 +44,7 @@ struct wl_client;
 
 namespace GammaRay {
 
+class ClientMetricsModel;
 class ClientsModel;
 class Logger;
 class ResourcesModel;
@@ -62,6 +63,8 @@ public slots:
     void disconnected() override;
     void setSelectedClient(int index) override;
     void setSelectedResource(uint id) override;
+    void setLogInterfaceFilter(const QString &filter) override;
+    void requestTimeline(qint64 from, qint64 to, int bins) override;
 
 private slots:
     void objectAdded(QObject *obj);
@@ -73,6 +76,7 @@ private:
 
     QWaylandCompositor *m_compositor;
     ClientsModel *m_clientsModel;
+    ClientMetricsModel *m_clientMetricsModel;
     QItemSelectionModel *m_clientSelectionModel;
     Logger *m_logger;
     ResourcesModel *m_resourcesModel;
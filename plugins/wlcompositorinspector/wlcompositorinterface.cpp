@@ -35,6 +35,7 @@ namespace GammaRay {
 WlCompositorInterface::WlCompositorInterface(QObject *parent)
     : QObject(parent)
 {
+    qRegisterMetaTypeStreamOperators<QVector<int> >();
     ObjectBroker::registerObject<WlCompositorInterface *>(this);
 }
 
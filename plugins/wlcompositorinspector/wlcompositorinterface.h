@@ -32,6 +32,7 @@
 #include <config-gammaray.h>
 
 #include <QObject>
+#include <QVector>
 
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
@@ -51,11 +52,17 @@ public slots:
   virtual void disconnected() = 0;
   virtual void setSelectedClient(int index) = 0;
   virtual void setSelectedResource(uint id) = 0;
+  /// Restricts the protocol log model to messages on interfaces matching @p filter.
+  virtual void setLogInterfaceFilter(const QString &filter) = 0;
+  /// Requests the message counts of [@p from, @p to) in @p bins bins, answered by timelineData().
+  virtual void requestTimeline(qint64 from, qint64 to, int bins) = 0;
 
 signals:
-  void logMessage(quint64 pid, qint64 time, const QByteArray &msg);
+  /// Time range covered by the protocol log, emitted when new messages arrive.
+  void logRangeChanged(qint64 start, qint64 end);
+  /// Binned message counts, for all clients and for the selected one (empty if none is selected).
+  void timelineData(qint64 from, qint64 to, const QVector<int> &total, const QVector<int> &client);
   void setLoggingClient(quint64 pid);
-  void resetLog();
 
 };
 
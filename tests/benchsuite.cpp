@@ -30,15 +30,65 @@
 #include "core/probe.h"
 #include "core/util.h"
 
+#include <compat/qasconst.h>
+
 #include <QtTestGui>
 
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
 #include <QLabel>
 #include <QTreeView>
 
+#include <algorithm>
+#include <memory>
+
 QTEST_MAIN(GammaRay::BenchSuite)
 
 using namespace GammaRay;
 
+namespace {
+// the previous object list storage, a sorted vector with one row notification per change
+class SortedVectorObjectList : public QAbstractTableModel
+{
+public:
+    explicit SortedVectorObjectList(Probe *probe)
+    {
+        connect(probe, &Probe::objectCreated, this, [this](QObject *obj) {
+            auto it = std::lower_bound(m_objects.begin(), m_objects.end(), obj);
+            const int row = std::distance(m_objects.begin(), it);
+            beginInsertRows(QModelIndex(), row, row);
+            m_objects.insert(it, obj);
+            endInsertRows();
+        });
+        connect(probe, &Probe::objectDestroyed, this, [this](QObject *obj) {
+            auto it = std::lower_bound(m_objects.begin(), m_objects.end(), obj);
+            if (it == m_objects.end() || *it != obj)
+                return;
+            const int row = std::distance(m_objects.begin(), it);
+            beginRemoveRows(QModelIndex(), row, row);
+            m_objects.erase(it);
+            endRemoveRows();
+        });
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_objects.size();
+    }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 2;
+    }
+    QVariant data(const QModelIndex &, int) const override
+    {
+        return QVariant();
+    }
+
+private:
+    QVector<QObject *> m_objects;
+};
+}
+
 void BenchSuite::iconForObject()
 {
     QWidget widget;
@@ -77,3 +127,107 @@ void BenchSuite::probe_objectAdded()
     qDeleteAll(objects);
     delete Probe::instance();
 }
+
+void BenchSuite::objectListModel_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("sortedVectorBaseline");
+
+    QTest::newRow("100k") << 100000 << false;
+    QTest::newRow("1M") << 1000000 << false;
+    // the sorted vector is quadratic on removal, 1M objects would take ages there
+    QTest::newRow("100k, sorted vector baseline") << 100000 << true;
+}
+
+void BenchSuite::objectListModel()
+{
+    QFETCH(int, count);
+    QFETCH(bool, sortedVectorBaseline);
+
+    Probe::createProbe(false);
+    QAbstractItemModel *model = Probe::instance()->objectListModel();
+    std::unique_ptr<SortedVectorObjectList> baseline;
+    if (sortedVectorBaseline) {
+        // measure the baseline on its own, with the same object change delivery
+        disconnect(Probe::instance(), nullptr, model, nullptr);
+        baseline.reset(new SortedVectorObjectList(Probe::instance()));
+        model = baseline.get();
+    }
+
+    QVector<QObject *> objects;
+    objects.reserve(count);
+    for (int i = 0; i < count; ++i)
+        objects.push_back(new QObject);
+
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE {
+        // creation storm, as seen from constructors, reported in batches by the probe
+        timer.start();
+        for (auto obj : qAsConst(objects))
+            Probe::objectAdded(obj, true);
+        QTRY_COMPARE_WITH_TIMEOUT(model->rowCount(), count, 600 * 1000);
+        const auto addTime = timer.restart();
+
+        // destruction storm in the main thread, delivered one by one
+        for (auto obj : qAsConst(objects))
+            Probe::objectRemoved(obj);
+        const auto removeTime = timer.elapsed();
+        QCOMPARE(model->rowCount(), 0);
+
+        qInfo("%s: add %lld ms, remove %lld ms", QTest::currentDataTag(), addTime, removeTime);
+    }
+
+    qDeleteAll(objects);
+    baseline.reset();
+    delete Probe::instance();
+}
+
+void BenchSuite::objectTreeModel_data()
+{
+    QTest::addColumn<int>("parentCount");
+    QTest::addColumn<int>("childCount");
+
+    QTest::newRow("100 x 1000") << 100 << 1000;
+    QTest::newRow("1000 x 100") << 1000 << 100;
+}
+
+void BenchSuite::objectTreeModel()
+{
+    QFETCH(int, parentCount);
+    QFETCH(int, childCount);
+
+    Probe::createProbe(false);
+    auto model = Probe::instance()->objectTreeModel();
+
+    QVector<QObject *> parents;
+    QVector<QObject *> objects;
+    objects.reserve(parentCount * (childCount + 1));
+    for (int i = 0; i < parentCount; ++i) {
+        auto parent = new QObject;
+        parents.push_back(parent);
+        objects.push_back(parent);
+        for (int j = 0; j < childCount; ++j)
+            objects.push_back(new QObject(parent));
+    }
+
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE {
+        // a whole tree instantiated at once, as for a QML component or a widget form
+        timer.start();
+        for (auto obj : qAsConst(objects))
+            Probe::objectAdded(obj, true);
+        QTRY_COMPARE_WITH_TIMEOUT(model->rowCount(), parentCount, 600 * 1000);
+        const auto addTime = timer.restart();
+        QCOMPARE(model->rowCount(model->index(parentCount - 1, 0)), childCount);
+
+        for (auto obj : qAsConst(objects))
+            Probe::objectRemoved(obj);
+        const auto removeTime = timer.elapsed();
+        QCOMPARE(model->rowCount(), 0);
+
+        qInfo("%s: add %lld ms, remove %lld ms", QTest::currentDataTag(), addTime, removeTime);
+    }
+
+    qDeleteAll(parents);
+    delete Probe::instance();
+}
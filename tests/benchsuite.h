@@ -39,6 +39,10 @@ class BenchSuite : public QObject
 private slots:
     void iconForObject();
     void probe_objectAdded();
+    void objectListModel_data();
+    void objectListModel();
+    void objectTreeModel_data();
+    void objectTreeModel();
 };
 }
 
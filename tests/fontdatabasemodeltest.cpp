@@ -41,7 +41,15 @@ private slots:
         FontDatabaseModel model;
         ModelTest tester(&model);
 
-        QVERIFY(model.rowCount() > 0);
+        QTRY_VERIFY(model.rowCount() > 0);
+
+        // styles are fetched on demand
+        const auto family = model.index(0, 0);
+        QVERIFY(model.hasChildren(family));
+        if (model.canFetchMore(family))
+            model.fetchMore(family);
+        QVERIFY(!model.canFetchMore(family));
+        QVERIFY(model.rowCount(family) > 0);
     }
 };
 
@@ -100,6 +100,8 @@ private slots:
         QVERIFY(proxyIdx.isValid());
         QVERIFY(!proxyIdx.parent().isValid());
 
+        QSignalSpy resetSpy(modelModel, SIGNAL(modelReset()));
+        QVERIFY(resetSpy.isValid());
         targetProxy->setSourceModel(targetModel);
         QCOMPARE(modelModel->rowCount(), topRowCount);
         proxyIdx = searchFixedIndex(modelModel, "targetProxy", Qt::MatchRecursive);
@@ -108,6 +110,7 @@ private slots:
 
         targetProxy->setSourceModel(nullptr);
         QCOMPARE(modelModel->rowCount(), topRowCount + 1);
+        QCOMPARE(resetSpy.size(), 0); // moved, not reset
         proxyIdx = searchFixedIndex(modelModel, "targetProxy", Qt::MatchRecursive);
         QVERIFY(proxyIdx.isValid());
         QVERIFY(!proxyIdx.parent().isValid());
@@ -265,6 +268,15 @@ private slots:
         QCOMPARE(cellData.column, 0);
         QCOMPARE(cellData.flags, Qt::NoItemFlags);
 
+        // changes to the selected cell are updated in place
+        QSignalSpy cellDataSpy(cellModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+        QVERIFY(cellDataSpy.isValid());
+        item->setText("item0,0 changed");
+        QVERIFY(!cellDataSpy.isEmpty());
+        idx = searchFixedIndex(cellModel, QLatin1String("Qt::DisplayRole"), Qt::MatchRecursive);
+        QCOMPARE(idx.sibling(idx.row(), 1).data().toString(), QLatin1String("item0,0 changed"));
+        QVERIFY(cellContentResetSpy.isEmpty());
+
         cellSelModel->clear();
         QCOMPARE(cellModel->rowCount(), 0);
         QVERIFY(cellContentResetSpy.isEmpty());
@@ -324,6 +336,57 @@ private slots:
         delete targetModel;
     }
 
+    void testCallProfiler()
+    {
+        createProbe();
+
+        auto targetModel = new QStringListModel;
+        targetModel->setObjectName("targetModel");
+        targetModel->setStringList(QStringList() << "item1" << "item2" << "item3");
+        QTest::qWait(1); // trigger model inspector plugin loading
+
+        auto modelModel = ObjectBroker::model("com.kdab.GammaRay.ModelModel");
+        QVERIFY(modelModel);
+        auto profileModel = ObjectBroker::model("com.kdab.GammaRay.ModelCallProfile");
+        QVERIFY(profileModel);
+        ModelTest profileModelTester(profileModel);
+
+        auto modelSelModel = ObjectBroker::selectionModel(modelModel);
+        QVERIFY(modelSelModel);
+        auto idx = searchFixedIndex(modelModel, "targetModel", Qt::MatchRecursive);
+        QVERIFY(idx.isValid());
+        modelSelModel->select(idx, QItemSelectionModel::ClearAndSelect);
+
+        auto iface = ObjectBroker::object<ModelInspectorInterface*>();
+        QVERIFY(iface);
+        iface->setCallProfilingEnabled(true);
+
+        targetModel->setData(targetModel->index(1, 0), QStringLiteral("item2a"));
+        targetModel->insertRows(3, 2);
+        for (int i = 0; i < 10; ++i)
+            QCOMPARE(targetModel->index(0, 0).data().toString(), QLatin1String("item1"));
+
+        QTRY_VERIFY(searchFixedIndex(profileModel, "rowsInserted").isValid());
+        idx = searchFixedIndex(profileModel, "dataChanged");
+        QVERIFY(idx.isValid());
+        QCOMPARE(idx.sibling(idx.row(), 1).data().toInt(), 1);
+        idx = searchFixedIndex(profileModel, "rowsInserted");
+        QCOMPARE(idx.sibling(idx.row(), 7).data().toInt(), 2);
+
+#if defined(Q_OS_LINUX) && defined(Q_PROCESSOR_X86)
+        idx = searchFixedIndex(profileModel, "data(Qt::DisplayRole)");
+        QVERIFY(idx.isValid());
+        QVERIFY(idx.sibling(idx.row(), 1).data().toInt() >= 10);
+#endif
+
+        iface->setCallProfilingEnabled(false);
+        QCOMPARE(profileModel->rowCount(), 0);
+        // calls go straight to the model again
+        QCOMPARE(targetModel->index(0, 0).data().toString(), QLatin1String("item1"));
+
+        delete targetModel;
+    }
+
     void testWidget()
     {
         createProbe();
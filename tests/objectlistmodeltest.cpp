@@ -0,0 +1,173 @@
+/*
+  objectlistmodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "baseprobetest.h"
+
+#include <common/objectmodel.h>
+
+#include <compat/qasconst.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QSet>
+#include <QSignalSpy>
+
+using namespace GammaRay;
+
+class ObjectListModelTest : public BaseProbeTest
+{
+    Q_OBJECT
+private:
+    static QSet<QObject *> modelObjects(QAbstractItemModel *model)
+    {
+        QSet<QObject *> objects;
+        for (int row = 0; row < model->rowCount(); ++row)
+            objects.insert(model->index(row, 0).data(ObjectModel::ObjectRole).value<QObject *>());
+        return objects;
+    }
+
+private slots:
+    void testBatchedAddRemove()
+    {
+        createProbe();
+
+        auto model = Probe::instance()->objectListModel();
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        const auto baseRowCount = model->rowCount();
+        QSignalSpy insertSpy(model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+        QVERIFY(insertSpy.isValid());
+
+        // spans several storage chunks
+        QVector<QObject *> objects;
+        for (int i = 0; i < 3000; ++i)
+            objects.push_back(new QObject);
+        QTest::qWait(1);
+
+        QCOMPARE(model->rowCount(), baseRowCount + objects.size());
+        QCOMPARE(insertSpy.size(), 1);
+        auto contents = modelObjects(model);
+        for (auto obj : qAsConst(objects))
+            QVERIFY(contents.contains(obj));
+
+        // remove scattered rows and contiguous ranges across chunk boundaries
+        QVector<QObject *> remaining;
+        for (int i = 0; i < objects.size(); ++i) {
+            if (i % 3 == 0 || (i > 1000 && i < 2100))
+                delete objects.at(i);
+            else
+                remaining.push_back(objects.at(i));
+        }
+        QTest::qWait(1);
+
+        QCOMPARE(model->rowCount(), baseRowCount + remaining.size());
+        contents = modelObjects(model);
+        for (auto obj : qAsConst(remaining))
+            QVERIFY(contents.contains(obj));
+        QCOMPARE(Probe::instance()->allQObjects().size(), model->rowCount());
+
+        qDeleteAll(remaining);
+        QTest::qWait(1);
+        QCOMPARE(model->rowCount(), baseRowCount);
+    }
+
+    void testSparseRemovals()
+    {
+        createProbe();
+
+        auto model = Probe::instance()->objectListModel();
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        QTest::qWait(1);
+        const auto baseRowCount = model->rowCount();
+
+        QVector<QObject *> objects;
+        for (int i = 0; i < 5000; ++i)
+            objects.push_back(new QObject);
+        QTest::qWait(1);
+
+        // thin out every storage chunk, so they get merged, insertion order has to survive that
+        QVector<QObject *> remaining;
+        for (int i = 0; i < objects.size(); ++i) {
+            if (i % 16 == 0)
+                remaining.push_back(objects.at(i));
+            else
+                delete objects.at(i);
+        }
+        QTest::qWait(1);
+
+        for (int i = 0; i < 100; ++i)
+            remaining.push_back(new QObject);
+        delete remaining.takeAt(10);
+        QTest::qWait(1);
+
+        QCOMPARE(model->rowCount(), baseRowCount + remaining.size());
+        const auto &allObjects = Probe::instance()->allQObjects();
+        QCOMPARE(allObjects.size(), model->rowCount());
+        const auto remainingSet = QSet<QObject *>::fromList(remaining.toList());
+        QVector<QObject *> order;
+        for (int row = 0; row < model->rowCount(); ++row) {
+            const auto obj = model->index(row, 0).data(ObjectModel::ObjectRole).value<QObject *>();
+            QCOMPARE(allObjects.at(row), obj);
+            if (remainingSet.contains(obj))
+                order.push_back(obj);
+        }
+        QCOMPARE(order, remaining);
+
+        qDeleteAll(remaining);
+        QTest::qWait(1);
+        QCOMPARE(model->rowCount(), baseRowCount);
+    }
+
+    void testCreateDestroyInOneBatch()
+    {
+        createProbe();
+
+        auto model = Probe::instance()->objectListModel();
+        QVERIFY(model);
+        ModelTest modelTest(model);
+        QTest::qWait(1);
+        const auto baseRowCount = model->rowCount();
+
+        auto keep = new QObject;
+        auto transient = new QObject;
+        delete transient;
+        QTest::qWait(1);
+
+        QCOMPARE(model->rowCount(), baseRowCount + 1);
+        const auto contents = modelObjects(model);
+        QVERIFY(contents.contains(keep));
+
+        delete keep;
+        QTest::qWait(1);
+        QCOMPARE(model->rowCount(), baseRowCount);
+    }
+};
+
+QTEST_MAIN(ObjectListModelTest)
+
+#include "objectlistmodeltest.moc"
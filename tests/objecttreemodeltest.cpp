@@ -0,0 +1,141 @@
+/*
+  objecttreemodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "baseprobetest.h"
+#include "testhelpers.h"
+
+#include <common/objectmodel.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QSemaphore>
+#include <QThread>
+
+using namespace GammaRay;
+using namespace TestHelpers;
+
+// object changes from a secondary thread are queued and reach the object tree in one batch
+class TreeChangeThread : public QThread
+{
+    Q_OBJECT
+public:
+    void run() override
+    {
+        auto parent = new QObject;
+        parent->setObjectName(QStringLiteral("parent"));
+        child = new QObject(parent);
+        child->setObjectName(QStringLiteral("child"));
+        auto grandChild = new QObject(child);
+        grandChild->setObjectName(QStringLiteral("grandChild"));
+        created.release();
+        proceed.acquire();
+
+        child->setParent(nullptr);
+        delete parent;
+        auto added = new QObject(child);
+        added->setObjectName(QStringLiteral("added"));
+        delete new QObject(child);
+    }
+
+    QObject *child = nullptr;
+    QSemaphore created;
+    QSemaphore proceed;
+};
+
+class ObjectTreeModelTest : public BaseProbeTest
+{
+    Q_OBJECT
+private slots:
+    void testCreateReparentDestroyInOneBatch()
+    {
+        createProbe();
+
+        auto model = Probe::instance()->objectTreeModel();
+        QVERIFY(model);
+        ModelTest modelTest(model);
+
+        TreeChangeThread thread;
+        thread.start();
+        thread.created.acquire();
+        QTRY_VERIFY(searchFixedIndex(model, QStringLiteral("grandChild"), Qt::MatchRecursive).isValid());
+        QCOMPARE(searchFixedIndex(model, QStringLiteral("child"), Qt::MatchRecursive).parent(),
+                 searchFixedIndex(model, QStringLiteral("parent"), Qt::MatchRecursive));
+
+        thread.proceed.release();
+        QVERIFY(thread.wait(30000));
+        QTRY_VERIFY(!searchFixedIndex(model, QStringLiteral("parent"), Qt::MatchRecursive).isValid());
+
+        // the reparented child survives its former parent, along with its own children
+        const auto childIdx = searchFixedIndex(model, QStringLiteral("child"), Qt::MatchRecursive);
+        QVERIFY(childIdx.isValid());
+        QVERIFY(!childIdx.parent().isValid());
+        QCOMPARE(childIdx.data(ObjectModel::ObjectRole).value<QObject *>(), thread.child);
+        QCOMPARE(model->rowCount(childIdx), 2);
+        QCOMPARE(searchFixedIndex(model, QStringLiteral("grandChild"), Qt::MatchRecursive).parent(), childIdx);
+        QCOMPARE(searchFixedIndex(model, QStringLiteral("added"), Qt::MatchRecursive).parent(), childIdx);
+
+        delete thread.child;
+        QTest::qWait(1);
+        QVERIFY(!searchFixedIndex(model, QStringLiteral("child"), Qt::MatchRecursive).isValid());
+    }
+
+    void testReparentOutOfDestroyedParent()
+    {
+        createProbe();
+
+        auto model = Probe::instance()->objectTreeModel();
+        QVERIFY(model);
+        ModelTest modelTest(model);
+
+        auto parent = new QObject;
+        parent->setObjectName(QStringLiteral("parent"));
+        auto child = new QObject(parent);
+        child->setObjectName(QStringLiteral("child"));
+        auto grandChild = new QObject(child);
+        grandChild->setObjectName(QStringLiteral("grandChild"));
+        QTest::qWait(1);
+        QVERIFY(searchFixedIndex(model, QStringLiteral("grandChild"), Qt::MatchRecursive).isValid());
+
+        // the reparenting is only processed after the destruction
+        child->setParent(nullptr);
+        delete parent;
+        QTest::qWait(1);
+
+        const auto childIdx = searchFixedIndex(model, QStringLiteral("child"), Qt::MatchRecursive);
+        QVERIFY(childIdx.isValid());
+        QVERIFY(!childIdx.parent().isValid());
+        QCOMPARE(searchFixedIndex(model, QStringLiteral("grandChild"), Qt::MatchRecursive).parent(), childIdx);
+
+        delete child;
+        QTest::qWait(1);
+        QVERIFY(!searchFixedIndex(model, QStringLiteral("grandChild"), Qt::MatchRecursive).isValid());
+    }
+};
+
+QTEST_MAIN(ObjectTreeModelTest)
+
+#include "objecttreemodeltest.moc"
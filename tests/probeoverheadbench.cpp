@@ -0,0 +1,468 @@
+/*
+  probeoverheadbench.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * End-to-end probe overhead benchmark.
+ *
+ * Runs a set of synthetic Qt workloads in one of three modes, selected by the
+ * GAMMARAY_BENCH_PROBE environment variable:
+ * - "none": plain application, no probe
+ * - "probe": probe attached, nobody looking at any tool
+ * - "monitored": probe attached and the models of the major tools in use,
+ *   as they would be with a client showing them
+ *
+ * Without GAMMARAY_BENCH_PROBE set, the executable re-runs itself in all three
+ * modes and prints the throughput and latency deltas relative to "none".
+ * Per-run results are written as JSON to the file named by GAMMARAY_BENCH_REPORT.
+ */
+
+#include <config-gammaray.h>
+
+#include "baseprobetest.h"
+
+#include <common/objectbroker.h>
+
+#include <QAbstractItemModel>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+
+#ifdef GAMMARAY_BENCH_QUICK
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickView>
+#endif
+
+#include <cstdio>
+
+using namespace GammaRay;
+
+namespace {
+const char *modeVariable = "GAMMARAY_BENCH_PROBE";
+const char *reportVariable = "GAMMARAY_BENCH_REPORT";
+
+/** Emulates a client view on a tool model, i.e. fetches everything that changes. */
+class ModelMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ModelMonitor(QAbstractItemModel *model, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_model(model)
+    {
+        connect(model, &QAbstractItemModel::rowsInserted, this, &ModelMonitor::rowsInserted);
+        connect(model, &QAbstractItemModel::dataChanged, this, &ModelMonitor::dataChanged);
+    }
+
+private slots:
+    void rowsInserted(const QModelIndex &parent, int first, int last)
+    {
+        for (int row = first; row <= last; ++row) {
+            for (int col = 0; col < m_model->columnCount(parent); ++col)
+                m_model->itemData(m_model->index(row, col, parent));
+        }
+    }
+
+    void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+    {
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            for (int col = topLeft.column(); col <= bottomRight.column(); ++col)
+                m_model->itemData(topLeft.sibling(row, col));
+        }
+    }
+
+private:
+    QAbstractItemModel *m_model;
+};
+
+class ChurnThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit ChurnThread(int objects)
+        : m_objects(objects)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < m_objects; i += 10) {
+            QObject parent;
+            for (int j = 0; j < 10; ++j)
+                new QObject(&parent);
+        }
+    }
+
+private:
+    int m_objects;
+};
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void valueChanged(int value);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public slots:
+    void setValue(int value)
+    {
+        m_sum += value;
+    }
+
+private:
+    qint64 m_sum = 0;
+};
+}
+
+class ProbeOverheadBench : public BaseProbeTest
+{
+    Q_OBJECT
+private:
+    void report(const QString &benchmark, qint64 elapsedNSecs, qint64 operations)
+    {
+        QJsonObject result;
+        result.insert(QStringLiteral("benchmark"), benchmark);
+        result.insert(QStringLiteral("tag"), QString::fromUtf8(QTest::currentDataTag()));
+        result.insert(QStringLiteral("mode"), m_mode);
+        result.insert(QStringLiteral("elapsedMs"), elapsedNSecs / 1000000.0);
+        result.insert(QStringLiteral("operations"), double(operations));
+        result.insert(QStringLiteral("opsPerSecond"), elapsedNSecs > 0 ? operations * 1.0e9 / elapsedNSecs : 0.0);
+        result.insert(QStringLiteral("meanLatencyUs"), operations > 0 ? elapsedNSecs / 1000.0 / operations : 0.0);
+        m_report.push_back(result);
+
+        QTest::setBenchmarkResult(elapsedNSecs / 1000000.0, QTest::WalltimeMilliseconds);
+    }
+
+    void monitorToolModels()
+    {
+        // make sure the tools we care about get activated
+        {
+            QTimer timer;
+            QWidget widget;
+#ifdef GAMMARAY_BENCH_QUICK
+            QQuickView view;
+#endif
+            QTest::qWait(1);
+        }
+        QTest::qWait(1);
+
+        static const char * const toolModels[] = {
+            "com.kdab.GammaRay.ObjectTree",
+            "com.kdab.GammaRay.ObjectList",
+            "com.kdab.GammaRay.ObjectInspectorTree",
+            "com.kdab.GammaRay.SignalHistoryModel",
+            "com.kdab.GammaRay.TimerModel",
+            "com.kdab.GammaRay.EventModel",
+            "com.kdab.GammaRay.WidgetTree",
+            "com.kdab.GammaRay.QuickItemModel",
+            "com.kdab.GammaRay.QuickSceneGraphModel",
+            "com.kdab.GammaRay.MetaObjectBrowserTreeModel",
+            "com.kdab.GammaRay.ProblemModel"
+        };
+        for (auto name : toolModels) {
+            // in-process this sends the "model in use" event, like a client would
+            auto model = ObjectBroker::model(QString::fromLatin1(name));
+            if (model)
+                new ModelMonitor(model, this);
+        }
+    }
+
+private slots:
+    void initTestCase()
+    {
+        m_mode = QString::fromLocal8Bit(qgetenv(modeVariable));
+        if (m_mode.isEmpty())
+            m_mode = QStringLiteral("none");
+        if (m_mode == QLatin1String("none"))
+            return;
+
+        createProbe();
+        if (m_mode == QLatin1String("monitored"))
+            monitorToolModels();
+    }
+
+    void cleanupTestCase()
+    {
+        const auto fileName = QString::fromLocal8Bit(qgetenv(reportVariable));
+        if (fileName.isEmpty())
+            return;
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+        f.write(QJsonDocument(m_report).toJson());
+    }
+
+    void benchObjectChurn_data()
+    {
+        QTest::addColumn<int>("threads");
+        QTest::newRow("1 thread") << 1;
+        QTest::newRow("4 threads") << 4;
+    }
+
+    void benchObjectChurn()
+    {
+        QFETCH(int, threads);
+        static const int objectsPerThread = 50000;
+
+        QVector<ChurnThread*> workers;
+        for (int i = 0; i < threads; ++i)
+            workers.push_back(new ChurnThread(objectsPerThread));
+
+        QElapsedTimer t;
+        t.start();
+        for (auto worker : workers)
+            worker->start();
+        for (auto worker : workers)
+            worker->wait();
+        QTest::qWait(1); // let the probe process queued object changes
+        report(QStringLiteral("objectChurn"), t.nsecsElapsed(), qint64(threads) * objectsPerThread);
+
+        qDeleteAll(workers);
+    }
+
+    void benchSignalEmission_data()
+    {
+        QTest::addColumn<int>("connectionType");
+        QTest::newRow("direct") << int(Qt::DirectConnection);
+        QTest::newRow("queued") << int(Qt::QueuedConnection);
+    }
+
+    void benchSignalEmission()
+    {
+        QFETCH(int, connectionType);
+        static const int emissions = 200000;
+
+        Emitter emitter;
+        Receiver receiver;
+        connect(&emitter, &Emitter::valueChanged, &receiver, &Receiver::setValue,
+                static_cast<Qt::ConnectionType>(connectionType));
+        QTest::qWait(1);
+
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < emissions; ++i)
+            emit emitter.valueChanged(i);
+        QCoreApplication::processEvents();
+        report(QStringLiteral("signalEmission"), t.nsecsElapsed(), emissions);
+    }
+
+    void benchTimers()
+    {
+        static const int timerCount = 100;
+        static const int duration = 1000;
+
+        QVector<QTimer*> timers;
+        int timeouts = 0;
+        for (int i = 0; i < timerCount; ++i) {
+            auto timer = new QTimer(this);
+            timer->setInterval(0);
+            connect(timer, &QTimer::timeout, this, [&timeouts]() { ++timeouts; });
+            timers.push_back(timer);
+        }
+        QTest::qWait(1);
+
+        QElapsedTimer t;
+        t.start();
+        for (auto timer : timers)
+            timer->start();
+        QTest::qWait(duration);
+        for (auto timer : timers)
+            timer->stop();
+        report(QStringLiteral("timers"), t.nsecsElapsed(), timeouts);
+
+        qDeleteAll(timers);
+    }
+
+    void benchWidgetTree_data()
+    {
+        QTest::addColumn<int>("depth");
+        QTest::addColumn<int>("fanOut");
+        QTest::newRow("deep") << 200 << 1;
+        QTest::newRow("wide") << 4 << 8;
+    }
+
+    void benchWidgetTree()
+    {
+        QFETCH(int, depth);
+        QFETCH(int, fanOut);
+
+        int widgets = 0;
+        QElapsedTimer t;
+        t.start();
+        for (int round = 0; round < 10; ++round) {
+            QWidget root;
+            QVector<QWidget*> level = { &root };
+            for (int d = 0; d < depth; ++d) {
+                QVector<QWidget*> nextLevel;
+                for (auto parent : level) {
+                    for (int i = 0; i < fanOut; ++i) {
+                        nextLevel.push_back(new QWidget(parent));
+                        ++widgets;
+                    }
+                }
+                level = nextLevel;
+            }
+            root.show();
+            QTest::qWait(1);
+        }
+        report(QStringLiteral("widgetTree"), t.nsecsElapsed(), widgets);
+    }
+
+#ifdef GAMMARAY_BENCH_QUICK
+    void benchQmlScene()
+    {
+        static const int items = 2000;
+        static const int frames = 20;
+
+        QQuickView view;
+        view.resize(800, 600);
+        view.show();
+        QTest::qWaitForWindowExposed(&view);
+
+        QQmlComponent component(view.engine());
+        component.setData(QByteArrayLiteral(
+            "import QtQuick 2.0\n"
+            "Item { anchors.fill: parent\n"
+            "  property real phase: 0\n"
+            "  NumberAnimation on phase { from: 0; to: 1; loops: Animation.Infinite }\n"
+            "  Repeater { model: ") + QByteArray::number(items) + QByteArrayLiteral("\n"
+            "    Rectangle { x: (index % 40) * 20 + phase * 10; y: Math.floor(index / 40) * 12; width: 16; height: 8; color: \"steelblue\" }\n"
+            "  }\n"
+            "}\n"), QUrl());
+
+        QElapsedTimer t;
+        t.start();
+        auto root = qobject_cast<QQuickItem*>(component.create());
+        QVERIFY(root);
+        root->setParentItem(view.contentItem());
+        int swapped = 0;
+        connect(&view, &QQuickWindow::frameSwapped, this, [&swapped]() { ++swapped; });
+        while (swapped < frames && t.elapsed() < 30000)
+            QTest::qWait(1);
+        report(QStringLiteral("qmlScene"), t.nsecsElapsed(), swapped);
+
+        delete root;
+    }
+#endif
+
+private:
+    QString m_mode;
+    QJsonArray m_report;
+};
+
+// runs the benchmark in all modes, and compares the results against the probe-less run
+static int runComparison(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QTemporaryDir dir;
+    const QStringList modes = {
+        QStringLiteral("none"), QStringLiteral("probe"), QStringLiteral("monitored")
+    };
+
+    QHash<QString, QHash<QString, QJsonObject>> results; // mode -> benchmark/tag -> result
+    for (const auto &mode : modes) {
+        const auto reportFile = dir.filePath(mode + QLatin1String(".json"));
+        auto env = QProcessEnvironment::systemEnvironment();
+        env.insert(QString::fromLatin1(modeVariable), mode);
+        env.insert(QString::fromLatin1(reportVariable), reportFile);
+
+        QProcess proc;
+        proc.setProcessEnvironment(env);
+        proc.setProcessChannelMode(QProcess::ForwardedChannels);
+        proc.start(QCoreApplication::applicationFilePath(), QCoreApplication::arguments().mid(1));
+        if (!proc.waitForFinished(-1) || proc.exitStatus() != QProcess::NormalExit || proc.exitCode() != 0) {
+            std::fprintf(stderr, "Benchmark run in mode %s failed.\n", qPrintable(mode));
+            return 1;
+        }
+
+        QFile f(reportFile);
+        if (!f.open(QFile::ReadOnly))
+            return 1;
+        const auto runResults = QJsonDocument::fromJson(f.readAll()).array();
+        for (const auto &r : runResults) {
+            const auto obj = r.toObject();
+            const auto key = obj.value(QStringLiteral("benchmark")).toString() + QLatin1Char(':') + obj.value(QStringLiteral("tag")).toString();
+            results[mode].insert(key, obj);
+        }
+    }
+
+    QJsonArray combined;
+    std::printf("\n%-34s %-10s %10s %9s %12s %9s\n", "benchmark", "mode", "ops/s", "delta", "latency [us]", "delta");
+    const auto baseline = results.value(modes.first());
+    for (auto it = baseline.constBegin(); it != baseline.constEnd(); ++it) {
+        const auto baseOps = it.value().value(QStringLiteral("opsPerSecond")).toDouble();
+        const auto baseLatency = it.value().value(QStringLiteral("meanLatencyUs")).toDouble();
+        for (const auto &mode : modes) {
+            const auto r = results.value(mode).value(it.key());
+            const auto ops = r.value(QStringLiteral("opsPerSecond")).toDouble();
+            const auto latency = r.value(QStringLiteral("meanLatencyUs")).toDouble();
+            const auto opsDelta = baseOps > 0 ? (ops / baseOps - 1.0) * 100.0 : 0.0;
+            const auto latencyDelta = baseLatency > 0 ? (latency / baseLatency - 1.0) * 100.0 : 0.0;
+            std::printf("%-34s %-10s %10.0f %+8.1f%% %12.3f %+8.1f%%\n", qPrintable(it.key()), qPrintable(mode),
+                        ops, opsDelta, latency, latencyDelta);
+            auto entry = r;
+            entry.insert(QStringLiteral("opsPerSecondDelta"), opsDelta);
+            entry.insert(QStringLiteral("meanLatencyDelta"), latencyDelta);
+            combined.push_back(entry);
+        }
+    }
+    std::fflush(stdout);
+
+    const auto fileName = QString::fromLocal8Bit(qgetenv(reportVariable));
+    if (!fileName.isEmpty()) {
+        QFile f(fileName);
+        if (!f.open(QFile::WriteOnly | QFile::Truncate))
+            return 1;
+        f.write(QJsonDocument(combined).toJson());
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (qgetenv(modeVariable).isEmpty())
+        return runComparison(argc, argv);
+
+    QApplication app(argc, argv);
+    ProbeOverheadBench bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "probeoverheadbench.moc"
@@ -0,0 +1,545 @@
+/*
+  remotemodelbench.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2021 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Wire-level benchmarks for the remote model protocol.
+ *
+ * Drives RemoteModelServer and RemoteModel over an in-memory channel, a local socket
+ * and a TCP connection. Timings are reported via QTest::setBenchmarkResult, so
+ * the usual -xml/-csv/-lightxml QtTest output formats work for regression tracking.
+ * The additional protocol statistics (messages/s, bytes/message, compression ratio,
+ * latency percentiles) are printed, and also written as JSON to the file named by
+ * the GAMMARAY_BENCH_REPORT environment variable, if set.
+ * With GAMMARAY_BENCH_SMOKE set, all workloads are scaled down by a factor of 100,
+ * which is how this runs as part of the regular tests.
+ */
+
+#include <core/remote/remotemodelserver.h>
+#include <client/remotemodel.h>
+#include <common/message.h>
+
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using namespace GammaRay;
+
+static void fakeRegisterServer() {}
+
+static int workload(int size)
+{
+    static const bool smoke = qEnvironmentVariableIsSet("GAMMARAY_BENCH_SMOKE");
+    return smoke ? std::max(1, size / 100) : size;
+}
+
+namespace GammaRay {
+/** One direction of a client/server connection, with traffic accounting. */
+class MessageChannel : public QObject
+{
+    Q_OBJECT
+public:
+    /** Creates an in-memory channel if @p writeDevice and @p readDevice are @c nullptr. */
+    explicit MessageChannel(QIODevice *writeDevice, QIODevice *readDevice, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_writeDevice(writeDevice)
+        , m_readDevice(readDevice)
+    {
+        if (m_readDevice)
+            connect(m_readDevice, &QIODevice::readyRead, this, &MessageChannel::readyRead);
+    }
+
+    void send(const Message &msg)
+    {
+        QByteArray ba;
+        QBuffer buffer(&ba);
+        buffer.open(QIODevice::WriteOnly);
+        msg.write(&buffer);
+        buffer.close();
+
+        ++messagesSent;
+        payloadBytes += msg.size();
+        wireBytes += ba.size();
+
+        if (m_writeDevice)
+            m_writeDevice->write(ba);
+        else
+            QMetaObject::invokeMethod(this, "deliver", Qt::QueuedConnection, Q_ARG(QByteArray, ba));
+    }
+
+    void resetStatistics()
+    {
+        messagesSent = 0;
+        messagesReceived = 0;
+        payloadBytes = 0;
+        wireBytes = 0;
+    }
+
+    quint64 messagesSent = 0;
+    quint64 messagesReceived = 0;
+    quint64 payloadBytes = 0; // uncompressed payload size
+    quint64 wireBytes = 0; // including message headers, after compression
+
+signals:
+    void message(const GammaRay::Message &msg);
+
+private slots:
+    void deliver(const QByteArray &ba)
+    {
+        QBuffer buffer(const_cast<QByteArray*>(&ba));
+        buffer.open(QIODevice::ReadOnly);
+        ++messagesReceived;
+        emit message(Message::readMessage(&buffer));
+    }
+
+    void readyRead()
+    {
+        while (Message::canReadMessage(m_readDevice)) {
+            ++messagesReceived;
+            emit message(Message::readMessage(m_readDevice));
+        }
+    }
+
+private:
+    QIODevice *m_writeDevice;
+    QIODevice *m_readDevice;
+};
+
+class FakeRemoteModelServer : public RemoteModelServer
+{
+    Q_OBJECT
+public:
+    explicit FakeRemoteModelServer(const QString &objectName, MessageChannel *channel, QObject *parent = nullptr)
+        : RemoteModelServer(objectName, parent)
+        , m_channel(channel)
+    {
+        m_myAddress = 42;
+    }
+
+    static void setup()
+    {
+        FakeRemoteModelServer::s_registerServerCallback = &fakeRegisterServer;
+    }
+
+private:
+    bool isConnected() const override { return true; }
+    void sendMessage(const Message &msg) const override
+    {
+        m_channel->send(msg);
+    }
+
+    MessageChannel *m_channel;
+};
+
+class FakeRemoteModel : public RemoteModel
+{
+    Q_OBJECT
+public:
+    explicit FakeRemoteModel(const QString &serverObject, MessageChannel *channel, QObject *parent = nullptr)
+        : RemoteModel(serverObject, parent)
+        , m_channel(channel)
+    {
+        m_myAddress = 42;
+    }
+
+    static void setup()
+    {
+        FakeRemoteModel::s_registerClientCallback = &fakeRegisterServer;
+    }
+
+private:
+    void sendMessage(const Message &msg) const override
+    {
+        m_channel->send(msg);
+    }
+
+    MessageChannel *m_channel;
+};
+
+/** Cheap flat source model, QStandardItemModel is too heavy for a million rows. */
+class BenchListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit BenchListModel(int rows, QObject *parent = nullptr)
+        : QAbstractListModel(parent)
+        , m_rows(rows)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        switch (role) {
+        case Qt::DisplayRole:
+            return QStringLiteral("QObject 0x%1").arg(quintptr(index.row()) * 16, 12, 16, QLatin1Char('0'));
+        case Qt::ToolTipRole:
+            return QStringLiteral("Object at row %1").arg(index.row());
+        }
+        return QVariant();
+    }
+
+    void touchRow(int row)
+    {
+        const auto idx = index(row, 0);
+        emit dataChanged(idx, idx);
+    }
+
+private:
+    int m_rows;
+};
+}
+
+class RemoteModelBench : public QObject
+{
+    Q_OBJECT
+private:
+    enum Transport {
+        InMemory,
+        LocalSocket,
+        TcpSocket
+    };
+
+    // client/server pair connected via one of the transports above
+    struct Connection {
+        std::unique_ptr<QLocalServer> localServer;
+        std::unique_ptr<QTcpServer> tcpServer;
+        std::unique_ptr<QIODevice> serverSocket;
+        std::unique_ptr<QIODevice> clientSocket;
+        std::unique_ptr<MessageChannel> toClient;
+        std::unique_ptr<MessageChannel> toServer;
+        std::unique_ptr<FakeRemoteModelServer> server;
+        std::unique_ptr<FakeRemoteModel> client;
+    };
+
+    bool connectTransport(Connection &c, Transport transport)
+    {
+        switch (transport) {
+        case InMemory:
+            return true;
+        case LocalSocket:
+        {
+            c.localServer.reset(new QLocalServer);
+            const auto name = QStringLiteral("gammaray-remotemodelbench-%1").arg(QCoreApplication::applicationPid());
+            QLocalServer::removeServer(name);
+            if (!c.localServer->listen(name))
+                return false;
+            auto socket = new QLocalSocket;
+            c.clientSocket.reset(socket);
+            socket->connectToServer(name);
+            if (!c.localServer->waitForNewConnection(5000) || !socket->waitForConnected(5000))
+                return false;
+            auto serverSocket = c.localServer->nextPendingConnection();
+            serverSocket->setParent(nullptr);
+            c.serverSocket.reset(serverSocket);
+            return true;
+        }
+        case TcpSocket:
+        {
+            c.tcpServer.reset(new QTcpServer);
+            if (!c.tcpServer->listen(QHostAddress::LocalHost))
+                return false;
+            auto socket = new QTcpSocket;
+            c.clientSocket.reset(socket);
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            socket->connectToHost(QHostAddress::LocalHost, c.tcpServer->serverPort());
+            if (!c.tcpServer->waitForNewConnection(5000) || !socket->waitForConnected(5000))
+                return false;
+            auto serverSocket = c.tcpServer->nextPendingConnection();
+            serverSocket->setParent(nullptr);
+            serverSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            c.serverSocket.reset(serverSocket);
+            return true;
+        }
+        }
+        return false;
+    }
+
+    bool setupConnection(Connection &c, Transport transport, QAbstractItemModel *model)
+    {
+        if (!connectTransport(c, transport))
+            return false;
+
+        c.toClient.reset(new MessageChannel(c.serverSocket.get(), c.clientSocket.get()));
+        c.toServer.reset(new MessageChannel(c.clientSocket.get(), c.serverSocket.get()));
+
+        const auto name = QStringLiteral("com.kdab.GammaRay.UnitTest.BenchModel");
+        c.server.reset(new FakeRemoteModelServer(name, c.toClient.get()));
+        c.server->setModel(model);
+        c.server->modelMonitored(true);
+        c.client.reset(new FakeRemoteModel(name, c.toServer.get()));
+
+        connect(c.toClient.get(), &MessageChannel::message, c.client.get(), &RemoteModel::newMessage);
+        connect(c.toServer.get(), &MessageChannel::message, c.server.get(), &RemoteModelServer::newRequest);
+        return true;
+    }
+
+    template <typename Predicate>
+    static bool pumpUntil(Predicate pred, int timeout = 60000)
+    {
+        QElapsedTimer t;
+        t.start();
+        while (!pred()) {
+            if (t.elapsed() > timeout)
+                return false;
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+        }
+        return true;
+    }
+
+    static QModelIndex waitForRows(RemoteModel *client, int rows)
+    {
+        client->rowCount();
+        if (!pumpUntil([client, rows]() { return client->rowCount() == rows; }))
+            return QModelIndex();
+        return client->index(0, 0);
+    }
+
+    static bool isLoaded(const QModelIndex &idx)
+    {
+        return idx.data(RemoteModelRole::LoadingState).value<RemoteModelNodeState::NodeStates>() == RemoteModelNodeState::NoState;
+    }
+
+    static void addTransportColumn()
+    {
+        QTest::addColumn<int>("transport");
+    }
+
+    static QString transportName(int transport)
+    {
+        switch (transport) {
+        case InMemory:
+            return QStringLiteral("inmemory");
+        case LocalSocket:
+            return QStringLiteral("local");
+        case TcpSocket:
+            return QStringLiteral("tcp");
+        }
+        return QString();
+    }
+
+    static qint64 percentile(QVector<qint64> samples, double p)
+    {
+        if (samples.isEmpty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        const int idx = qBound(0, static_cast<int>(p * (samples.size() - 1) + 0.5), samples.size() - 1);
+        return samples.at(idx);
+    }
+
+    void report(const QString &benchmark, qint64 elapsedNSecs, const Connection &c, QJsonObject extra = QJsonObject())
+    {
+        const quint64 messages = c.toClient->messagesSent + c.toServer->messagesSent;
+        const quint64 wireBytes = c.toClient->wireBytes + c.toServer->wireBytes;
+        const quint64 payloadBytes = c.toClient->payloadBytes + c.toServer->payloadBytes;
+        static const quint64 headerSize = sizeof(Protocol::PayloadSize) + sizeof(Protocol::ObjectAddress) + sizeof(Protocol::MessageType);
+        const quint64 wirePayload = wireBytes - messages * headerSize;
+
+        extra.insert(QStringLiteral("benchmark"), benchmark);
+        extra.insert(QStringLiteral("tag"), QString::fromUtf8(QTest::currentDataTag()));
+        extra.insert(QStringLiteral("elapsedMs"), elapsedNSecs / 1000000.0);
+        extra.insert(QStringLiteral("messages"), double(messages));
+        extra.insert(QStringLiteral("messagesPerSecond"), elapsedNSecs > 0 ? messages * 1.0e9 / elapsedNSecs : 0.0);
+        extra.insert(QStringLiteral("bytesPerMessage"), messages ? double(wireBytes) / messages : 0.0);
+        extra.insert(QStringLiteral("wireBytes"), double(wireBytes));
+        extra.insert(QStringLiteral("compressionRatio"), wirePayload ? double(payloadBytes) / wirePayload : 1.0);
+        m_report.push_back(extra);
+
+        qInfo("%s", QJsonDocument(extra).toJson(QJsonDocument::Compact).constData());
+        QTest::setBenchmarkResult(elapsedNSecs / 1000000.0, QTest::WalltimeMilliseconds);
+    }
+
+private slots:
+    void initTestCase()
+    {
+        FakeRemoteModelServer::setup();
+        FakeRemoteModel::setup();
+    }
+
+    void cleanupTestCase()
+    {
+        const auto fileName = QString::fromLocal8Bit(qgetenv("GAMMARAY_BENCH_REPORT"));
+        if (fileName.isEmpty())
+            return;
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+        f.write(QJsonDocument(m_report).toJson());
+    }
+
+    void benchFullSync_data()
+    {
+        addTransportColumn();
+        QTest::addColumn<int>("rows");
+        for (int transport : { InMemory, LocalSocket, TcpSocket }) {
+            for (int rows : { workload(10000), workload(100000), workload(1000000) }) {
+                const auto tag = QStringLiteral("%1-%2").arg(transportName(transport)).arg(rows);
+                QTest::newRow(qPrintable(tag)) << transport << rows;
+            }
+        }
+    }
+
+    // row count plus data for every row, as a view scrolling through the entire model would do
+    void benchFullSync()
+    {
+        QFETCH(int, transport);
+        QFETCH(int, rows);
+
+        BenchListModel model(rows);
+        Connection c;
+        QVERIFY(setupConnection(c, static_cast<Transport>(transport), &model));
+
+        QBitArray loaded(rows);
+        int loadedCount = 0;
+        connect(c.client.get(), &QAbstractItemModel::dataChanged, this, [&](const QModelIndex &tl, const QModelIndex &br) {
+            for (int row = tl.row(); row <= br.row(); ++row) {
+                if (!loaded.testBit(row)) {
+                    loaded.setBit(row);
+                    ++loadedCount;
+                }
+            }
+        });
+
+        QElapsedTimer t;
+        t.start();
+        QVERIFY(waitForRows(c.client.get(), rows).isValid());
+        for (int row = 0; row < rows; ++row)
+            c.client->index(row, 0).data();
+        QVERIFY(pumpUntil([&]() { return loadedCount == rows; }, 600000));
+        const auto elapsed = t.nsecsElapsed();
+
+        QJsonObject extra;
+        extra.insert(QStringLiteral("rows"), rows);
+        report(QStringLiteral("fullSync"), elapsed, c, extra);
+    }
+
+    void benchRowFetchLatency_data()
+    {
+        addTransportColumn();
+        for (int transport : { InMemory, LocalSocket, TcpSocket })
+            QTest::newRow(qPrintable(transportName(transport))) << transport;
+    }
+
+    // round-trip time of individual data requests for random rows, one at a time
+    void benchRowFetchLatency()
+    {
+        QFETCH(int, transport);
+        const int rows = workload(100000);
+        const int samples = workload(1000);
+
+        BenchListModel model(rows);
+        Connection c;
+        QVERIFY(setupConnection(c, static_cast<Transport>(transport), &model));
+        QVERIFY(waitForRows(c.client.get(), rows).isValid());
+        c.toClient->resetStatistics();
+        c.toServer->resetStatistics();
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(0, rows - 1);
+        QVector<qint64> latencies;
+        latencies.reserve(samples);
+
+        QElapsedTimer total;
+        total.start();
+        for (int i = 0; i < samples; ++i) {
+            const auto idx = c.client->index(dist(rng), 0);
+            if (isLoaded(idx))
+                continue;
+            QElapsedTimer t;
+            t.start();
+            idx.data(); // triggers the request
+            QVERIFY(pumpUntil([&idx]() { return isLoaded(idx); }));
+            latencies.push_back(t.nsecsElapsed() / 1000);
+        }
+        const auto elapsed = total.nsecsElapsed();
+
+        QJsonObject extra;
+        extra.insert(QStringLiteral("samples"), latencies.size());
+        extra.insert(QStringLiteral("p50Us"), double(percentile(latencies, 0.50)));
+        extra.insert(QStringLiteral("p90Us"), double(percentile(latencies, 0.90)));
+        extra.insert(QStringLiteral("p99Us"), double(percentile(latencies, 0.99)));
+        extra.insert(QStringLiteral("maxUs"), double(percentile(latencies, 1.0)));
+        report(QStringLiteral("rowFetchLatency"), elapsed, c, extra);
+    }
+
+    void benchChangeNotifications_data()
+    {
+        addTransportColumn();
+        for (int transport : { InMemory, LocalSocket, TcpSocket })
+            QTest::newRow(qPrintable(transportName(transport))) << transport;
+    }
+
+    // single-row dataChanged storm on a monitored model, as e.g. the timer or signal monitors produce
+    void benchChangeNotifications()
+    {
+        QFETCH(int, transport);
+        const int rows = workload(10000);
+        const int changes = workload(100000);
+
+        BenchListModel model(rows);
+        Connection c;
+        QVERIFY(setupConnection(c, static_cast<Transport>(transport), &model));
+        QVERIFY(waitForRows(c.client.get(), rows).isValid());
+        c.toClient->resetStatistics();
+        c.toServer->resetStatistics();
+
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < changes; ++i)
+            model.touchRow(i % rows);
+        const auto toClient = c.toClient.get();
+        QVERIFY(pumpUntil([toClient]() { return toClient->messagesReceived >= toClient->messagesSent; }));
+        const auto elapsed = t.nsecsElapsed();
+
+        QJsonObject extra;
+        extra.insert(QStringLiteral("changes"), changes);
+        report(QStringLiteral("changeNotifications"), elapsed, c, extra);
+    }
+
+private:
+    QJsonArray m_report;
+};
+
+QTEST_MAIN(RemoteModelBench)
+
+#include "remotemodelbench.moc"
@@ -30,6 +30,7 @@
 #include <client/remotemodel.h>
 #include <common/message.h>
 
+#include <QAbstractListModel>
 #include <QBuffer>
 #include <QDebug>
 #include <QObject>
@@ -113,6 +114,47 @@ private:
 };
 }
 
+// populates itself in chunks of 10 rows via fetchMore()
+class IncrementalModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit IncrementalModel(QObject *parent = nullptr)
+        : QAbstractListModel(parent)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_count;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!index.isValid() || role != Qt::DisplayRole)
+            return QVariant();
+        return QStringLiteral("entry%1").arg(index.row());
+    }
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        return !parent.isValid() && m_count < 35;
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        if (!canFetchMore(parent))
+            return;
+        const int count = qMin(10, 35 - m_count);
+        beginInsertRows(QModelIndex(), m_count, m_count + count - 1);
+        m_count += count;
+        endInsertRows();
+    }
+
+private:
+    int m_count = 0;
+};
+
 class RemoteModelTest : public QObject
 {
     Q_OBJECT
@@ -320,6 +362,71 @@ private slots:
 // QEXPECT_FAIL("", "QSFPM misbehavior, no idea yet where this is coming from", Continue);
         QCOMPARE(proxy.rowCount(pi1), 2);
     }
+
+    void testFetchMore()
+    {
+        IncrementalModel model;
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.IncrementalModel"), this);
+        server.setModel(&model);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.IncrementalModel"), this);
+        connect(&server, &FakeRemoteModelServer::message, &client,
+                &RemoteModel::newMessage);
+        connect(&client, &FakeRemoteModel::message, &server,
+                &RemoteModelServer::newRequest);
+
+        // asking for the row count doesn't fetch anything on the server
+        QCOMPARE(client.rowCount(), 0);
+        QTest::qWait(25);
+        QCOMPARE(model.rowCount(), 0);
+        QCOMPARE(client.rowCount(), 0);
+        QVERIFY(client.canFetchMore(QModelIndex()));
+        QVERIFY(client.hasChildren());
+
+        // one chunk per request
+        client.fetchMore(QModelIndex());
+        QTRY_COMPARE(client.rowCount(), 10);
+        QCOMPARE(model.rowCount(), 10);
+        QVERIFY(client.canFetchMore(QModelIndex()));
+
+        client.fetchMore(QModelIndex());
+        QTRY_COMPARE(client.rowCount(), 20);
+        QCOMPARE(model.rowCount(), 20);
+
+        while (client.canFetchMore(QModelIndex()))
+            client.fetchMore(QModelIndex());
+        QTRY_COMPARE(client.rowCount(), 35);
+        QCOMPARE(model.rowCount(), 35);
+        QVERIFY(!client.canFetchMore(QModelIndex()));
+
+        auto index = client.index(34, 0);
+        QVERIFY(waitForData(index));
+        QCOMPARE(index.data().toString(), QStringLiteral("entry34"));
+    }
+
+    void testFetchMoreModelTest()
+    {
+        IncrementalModel model;
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.IncrementalModel"), this);
+        server.setModel(&model);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.IncrementalModel"), this);
+        connect(&server, &FakeRemoteModelServer::message, &client,
+                &RemoteModel::newMessage);
+        connect(&client, &FakeRemoteModel::message, &server,
+                &RemoteModelServer::newRequest);
+
+        // ModelTest keeps fetching as a view scrolled to the bottom would
+        ModelTest modelTest(&client);
+        QTRY_VERIFY(client.canFetchMore(QModelIndex()));
+        client.fetchMore(QModelIndex());
+        QTRY_COMPARE(client.rowCount(), 35);
+        QCOMPARE(model.rowCount(), 35);
+    }
 };
 
 QTEST_MAIN(RemoteModelTest)
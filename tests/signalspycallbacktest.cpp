@@ -30,6 +30,13 @@
 
 using namespace GammaRay;
 
+static int s_signalBeginCount = 0;
+
+static void countingSignalBeginCallback(QObject *, int, void **)
+{
+    ++s_signalBeginCount;
+}
+
 class Sender : public QObject
 {
     Q_OBJECT
@@ -71,6 +78,48 @@ private slots:
         QVERIFY(s2.isNull());
     }
 
+    void testUnregister()
+    {
+        createProbe();
+
+        SignalSpyCallbackSet callbacks;
+        callbacks.signalBeginCallback = countingSignalBeginCallback;
+        Probe::instance()->registerSignalSpyCallbackSet(callbacks);
+
+        Sender s;
+        s_signalBeginCount = 0;
+        s.emitSignal();
+        QCOMPARE(s_signalBeginCount, 1);
+
+        Probe::instance()->unregisterSignalSpyCallbackSet(callbacks);
+        s.emitSignal();
+        QCOMPARE(s_signalBeginCount, 1);
+    }
+
+    void testMonitoredSendersOnly()
+    {
+        createProbe();
+
+        SignalSpyCallbackSet callbacks;
+        callbacks.signalBeginCallback = countingSignalBeginCallback;
+        callbacks.monitoredSendersOnly = true;
+        Probe::instance()->registerSignalSpyCallbackSet(callbacks);
+
+        Sender s1;
+        Sender s2;
+        Probe::instance()->addSignalSpySender(&s1);
+        s_signalBeginCount = 0;
+        s1.emitSignal();
+        QCOMPARE(s_signalBeginCount, 1);
+        s2.emitSignal(); // may pass the pre-filter as a false positive, but that's very unlikely with just one sender
+        QCOMPARE(s_signalBeginCount, 1);
+
+        Probe::instance()->removeSignalSpySender(&s1);
+        Probe::instance()->unregisterSignalSpyCallbackSet(callbacks);
+        s1.emitSignal();
+        QCOMPARE(s_signalBeginCount, 1);
+    }
+
     void cleanupTestCase()
     {
         // explicitly delete the probe as our usual cleanup doesn't work since we will
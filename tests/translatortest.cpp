@@ -107,6 +107,31 @@ private slots:
         QCoreApplication::translate(nullptr, "key", nullptr);
         QCoreApplication::translate(nullptr, "key", "disambiguation");
         QCoreApplication::translate("context", "key", "disambiguation");
+        QTest::qWait(1);
+
+        // repeated lookups hit the existing rows
+        const auto rowCount = model->rowCount();
+        for (int i = 0; i < 3; ++i) {
+            QCoreApplication::translate("context", "key", nullptr);
+            QCoreApplication::translate(nullptr, "key", nullptr);
+            QCoreApplication::translate(nullptr, "key", "disambiguation");
+            QCoreApplication::translate("context", "key", "disambiguation");
+        }
+        QTest::qWait(1);
+        QCOMPARE(model->rowCount(), rowCount);
+
+        auto *contextModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.TranslationContextModel"));
+        QVERIFY(contextModel);
+        ModelTest contextModelTest(contextModel);
+        QVERIFY(contextModel->rowCount() > 0);
+
+        // every application lookup misses in t1 before the fallback translator hits
+        const auto contextRows = contextModel->match(contextModel->index(0, 0), Qt::DisplayRole,
+                                                     QByteArray("context"), 1, Qt::MatchExactly);
+        QCOMPARE(contextRows.size(), 1);
+        const auto contextRow = contextRows.at(0).row();
+        QCOMPARE(contextModel->index(contextRow, 2).data().toInt(), 8);
+        QVERIFY(contextModel->index(contextRow, 1).data().toInt() > 8);
 
         delete t1;
         QTest::qWait(1);